@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Macros.h"
+
+#include <atomic>
+#include <cstdint>
+
+class CancellationToken
+{
+	GENO_DISABLE_COPY_AND_MOVE( CancellationToken );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	// A failure limit of 0 never cancels on failures
+	explicit CancellationToken( uint32_t FailureLimit = 1 );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void     Cancel       ( void );
+	bool     IsCancelled  ( void ) const { return m_Cancelled.load( std::memory_order_relaxed ); }
+	void     ReportFailure( void );
+	uint32_t Failures     ( void ) const { return m_Failures.load( std::memory_order_relaxed ); }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	std::atomic< bool >     m_Cancelled    = false;
+	std::atomic< uint32_t > m_Failures     = 0;
+	uint32_t                m_FailureLimit = 1;
+
+}; // CancellationToken
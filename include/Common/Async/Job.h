@@ -16,8 +16,11 @@
  */
 
 #pragma once
+#include "Common/Async/CancellationToken.h"
 #include "Common/Macros.h"
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -32,29 +35,46 @@ class Job
 
 public:
 
-	template< typename Functor > explicit Job( Functor&& rrFunctor );
+	struct Cost
+	{
+		int64_t  Duration = 0; // Expected run time in milliseconds
+		uint64_t Size     = 0; // Size of the input. Breaks ties between jobs without a known duration.
+
+	}; // Cost
 
 //////////////////////////////////////////////////////////////////////////
 
-	void AddDependency( std::weak_ptr< Job > Job );
-	bool CanRun       ( void ) const;
+	template< typename Functor > explicit Job( Functor&& rrFunctor, Cost Cost = { } );
 
 //////////////////////////////////////////////////////////////////////////
 
 private:
 
-	std::vector< std::weak_ptr< Job > > m_Dependencies       = { };
-	std::function< void( void ) >       m_Function           = { };
-
-	bool                                m_HasFinishedRunning = false;
+	std::vector< std::weak_ptr< Job > >   m_Dependencies       = { };
+	std::vector< std::shared_ptr< Job > > m_Dependents         = { }; // Jobs that are released when this one finishes
+	std::function< void( void ) >         m_Function           = { };
+	Cost                                  m_Cost               = { };
+	int64_t                               m_CriticalPath       = 0;
+	uint64_t                              m_Sequence           = 0;
+	size_t                                m_Pending            = 0;   // Dependencies that haven't finished yet
+	std::chrono::steady_clock::time_point m_QueuedTime         = { }; // When the job became ready to run
+	std::shared_ptr< CancellationToken >  m_CancellationToken  = { };
+	std::function< bool( void ) >         m_Ready              = { };
+	std::shared_ptr< Job >                m_Continues          = { };
+
+	bool                                  m_Queued             = false;
+	bool                                  m_Continued          = false;
+	bool                                  m_HasFinishedRunning = false;
 
 }; // Job
 
 //////////////////////////////////////////////////////////////////////////
 
 template< typename Functor >
-Job::Job( Functor&& rrFunctor )
-	: m_Function( std::forward< Functor >( rrFunctor ) )
+Job::Job( Functor&& rrFunctor, Cost Cost )
+	: m_Function    ( std::forward< Functor >( rrFunctor ) )
+	, m_Cost        ( Cost )
+	, m_CriticalPath( Cost.Duration )
 {
 
 } // Job
@@ -19,8 +19,11 @@
 #include "Common/Async/Job.h"
 #include "Common/Macros.h"
 
-#include <deque>
+#include <chrono>
+#include <condition_variable>
+#include <future>
 #include <mutex>
+#include <set>
 #include <span>
 #include <thread>
 #include <vector>
@@ -46,38 +49,120 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-	template< typename Functor > JobPtr NewJob( Functor&& rrFunctor, std::span< JobPtr > Dependencies = { } );
+	static size_t                              CurrentThreadIndex       ( void );
+	static std::chrono::steady_clock::duration CurrentJobQueueTime      ( void );
+	static const CancellationToken*            CurrentCancellationToken ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	template< typename Functor > JobPtr NewJob( Functor&& rrFunctor, std::span< JobPtr > Dependencies = { }, Job::Cost Cost = { }, std::shared_ptr< CancellationToken > CancellationToken = nullptr );
+
+	// Finishes the current job by calling rrFunctor with the value of Future once it's ready. The worker is free to run other jobs in the meantime.
+	// Should be the last thing that a job does, since rrFunctor may run on another worker before it returns. Outside of a job, it waits for the value and calls rrFunctor right away.
+	// Whatever fulfils Future must call FutureFulfilled afterwards, or the continuation never runs.
+	template< typename T, typename Functor > void Continue( std::shared_future< T > Future, Functor&& rrFunctor );
+
+	// Queues the continuations whose futures have become ready
+	void FutureFulfilled( void );
 
 //////////////////////////////////////////////////////////////////////////
 
 private:
 
-	void StopThreads( void );
-	void ThreadEntry( void );
+	struct RunsBefore
+	{
+		using is_transparent = void;
+
+		bool operator()( const Job*    pA, const Job*    pB ) const;
+		bool operator()( const JobPtr& rA, const JobPtr& rB ) const { return ( *this )( rA.get(), rB.get() ); }
+		bool operator()( const JobPtr& rA, const Job*    pB ) const { return ( *this )( rA.get(), pB ); }
+		bool operator()( const Job*    pA, const JobPtr& rB ) const { return ( *this )( pA, rB.get() ); }
+
+	}; // RunsBefore
+
+//////////////////////////////////////////////////////////////////////////
+
+	void StopThreads      ( void );
+	void ThreadEntry      ( size_t Index );
+	void Queue            ( JobPtr Job );
+	void Finish           ( Job& rJob );
+	void RaiseCriticalPath( Job& rJob, int64_t SuccessorPath );
 
 //////////////////////////////////////////////////////////////////////////
 
-	std::vector< std::thread > m_Threads   = { };
-	std::deque< JobPtr >       m_Jobs      = { };
-	std::mutex                 m_JobsMutex = { };
+	static JobPtr CurrentJob( void );
+
+//////////////////////////////////////////////////////////////////////////
 
-	bool                       m_Running   = false;
+	std::vector< std::thread >     m_Threads       = { };
+	std::set< JobPtr, RunsBefore > m_ReadyJobs     = { };
+	std::vector< JobPtr >          m_Continuations = { }; // Continuations whose futures weren't ready yet
+	std::mutex                     m_JobsMutex     = { };
+	std::condition_variable        m_JobsReady     = { };
+	uint64_t                       m_NextSequence  = 0;
+
+	bool                           m_Running       = false;
 
 }; // JobSystem
 
 //////////////////////////////////////////////////////////////////////////
 
 template< typename Functor >
-JobSystem::JobPtr JobSystem::NewJob( Functor&& rrFunctor, std::span< JobPtr > Dependencies )
+JobSystem::JobPtr JobSystem::NewJob( Functor&& rrFunctor, std::span< JobPtr > Dependencies, Job::Cost Cost, std::shared_ptr< CancellationToken > CancellationToken )
 {
 	std::scoped_lock Lock( m_JobsMutex );
-	std::shared_ptr  Job = std::make_shared< ::Job >( std::forward< Functor >( rrFunctor ) );
+	std::shared_ptr  Job = std::make_shared< ::Job >( std::forward< Functor >( rrFunctor ), Cost );
+
+	Job->m_CancellationToken = std::move( CancellationToken );
+	Job->m_Sequence          = m_NextSequence++;
 
 	for( JobPtr& rDependency : Dependencies )
-		Job->AddDependency( rDependency );
+	{
+		if( rDependency->m_HasFinishedRunning )
+			continue;
+
+		Job->m_Dependencies.emplace_back( rDependency );
+		rDependency->m_Dependents.push_back( Job );
+		++Job->m_Pending;
 
-	m_Jobs.push_back( Job );
+		// Everything that this job waits for now lies on a path that is at least this long
+		RaiseCriticalPath( *rDependency, Job->m_CriticalPath );
+	}
+
+	if( Job->m_Pending == 0 )
+		Queue( Job );
 
 	return Job;
 
 } // NewJob
+
+//////////////////////////////////////////////////////////////////////////
+
+template< typename T, typename Functor >
+void JobSystem::Continue( std::shared_future< T > Future, Functor&& rrFunctor )
+{
+	JobPtr Current = CurrentJob();
+
+	if( !Current )
+	{
+		rrFunctor( Future.get() );
+		return;
+	}
+
+	std::scoped_lock Lock( m_JobsMutex );
+	std::shared_ptr  Continuation = std::make_shared< Job >( [ Future, Function = std::forward< Functor >( rrFunctor ) ]( void ) mutable { Function( Future.get() ); }, Current->m_Cost );
+
+	Continuation->m_Ready             = [ Future ]( void ) { return Future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready; };
+	Continuation->m_CancellationToken = Current->m_CancellationToken;
+	Continuation->m_CriticalPath      = Current->m_CriticalPath;
+	Continuation->m_Sequence          = m_NextSequence++;
+	Continuation->m_Continues         = Current;
+	Current->m_Continued              = true;
+
+	// The future may have been fulfilled before the lock was taken, in which case FutureFulfilled has already passed
+	if( Continuation->m_Ready() )
+		Queue( std::move( Continuation ) );
+	else
+		m_Continuations.push_back( std::move( Continuation ) );
+
+} // Continue
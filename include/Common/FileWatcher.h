@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Macros.h"
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+// Tells which files in a set of directories were written, renamed or removed, without looking at them. Only Linux is supported, through
+// inotify. Elsewhere nothing can be watched, and users have to assume that every file may have changed.
+class FileWatcher
+{
+	GENO_DISABLE_COPY_AND_MOVE( FileWatcher );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	 FileWatcher( void );
+	~FileWatcher( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Only the files directly inside the directory are watched, not those in its subdirectories
+	bool Watch  ( const std::filesystem::path& rDirectory );
+
+	// Appends the files that changed since the last poll without waiting for more. Returns false if changes were lost, in which case
+	// every watched file should be treated as changed.
+	bool Poll   ( std::vector< std::filesystem::path >& rChanges );
+
+	bool IsValid( void ) const { return m_Descriptor >= 0; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	std::unordered_map< int, std::filesystem::path > m_Directories;
+
+	int                                              m_Descriptor = -1;
+
+}; // FileWatcher
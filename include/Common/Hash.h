@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Hash
+{
+	constexpr uint64_t FNV1A_OFFSET_BASIS = 0xCBF29CE484222325ull;
+	constexpr uint64_t FNV1A_PRIME        = 0x00000100000001B3ull;
+
+//////////////////////////////////////////////////////////////////////////
+
+	inline uint64_t FNV1a( const void* pData, size_t Size, uint64_t Seed = FNV1A_OFFSET_BASIS )
+	{
+		const unsigned char* pBytes = static_cast< const unsigned char* >( pData );
+		uint64_t             Result = Seed;
+
+		for( size_t i = 0; i < Size; ++i )
+		{
+			Result ^= pBytes[ i ];
+			Result *= FNV1A_PRIME;
+		}
+
+		return Result;
+
+	} // FNV1a
+
+//////////////////////////////////////////////////////////////////////////
+
+	constexpr uint64_t FNV1a( std::string_view String, uint64_t Seed = FNV1A_OFFSET_BASIS )
+	{
+		uint64_t Result = Seed;
+
+		for( char Char : String )
+		{
+			Result ^= static_cast< unsigned char >( Char );
+			Result *= FNV1A_PRIME;
+		}
+
+		return Result;
+
+	} // FNV1a
+
+//////////////////////////////////////////////////////////////////////////
+
+	inline uint64_t Combine( uint64_t Seed, uint64_t Value )
+	{
+		return FNV1a( &Value, sizeof( Value ), Seed );
+
+	} // Combine
+
+} // ::Hash
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Macros.h"
+
+#include <cstddef>
+#include <vector>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#endif // _WIN32
+
+// A GNU make jobserver, shared with the processes that are started from here. Makes, ninjas and cargos started by a build take their job slots from
+// it, so that nested builds don't run more jobs in total than the outermost one allows.
+class Jobserver
+{
+	GENO_SINGLETON( Jobserver );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	 Jobserver( void ) = default;
+	~Jobserver( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Joins the jobserver of the make that started this process, if there is one. Otherwise creates a jobserver with NumSlots slots for child processes to join.
+	void Start( size_t NumSlots );
+
+	// Every job that runs next to the first one needs a slot. Never blocks.
+	bool TryAcquire( void );
+	void Release   ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool IsActive( void ) const { return m_Active; }
+	bool IsClient( void ) const { return m_Active && !m_Owner; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	bool Join  ( void );
+	bool Create( size_t NumSlots );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::vector< char > m_Tokens          = { }; // Tokens must be given back as they were taken
+	bool                m_Active          = false;
+	bool                m_Owner           = false;
+
+#if defined( _WIN32 )
+	HANDLE              m_Semaphore       = nullptr;
+#else // _WIN32
+	int                 m_Descriptor      = -1; // Non-blocking, for this process only
+	int                 m_ChildDescriptor = -1; // Blocking, inherited by child processes
+#endif // !_WIN32
+
+}; // Jobserver
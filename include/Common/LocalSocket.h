@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Macros.h"
+
+#include <cstddef>
+#include <filesystem>
+
+// A stream socket in the UNIX domain, for talking to processes on the same machine. Not available on Windows, where every operation fails.
+class LocalSocket
+{
+	GENO_DISABLE_COPY( LocalSocket );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	 LocalSocket( void ) = default;
+	 LocalSocket( LocalSocket&& rrOther ) noexcept;
+	~LocalSocket( void ) { Close(); }
+
+	LocalSocket& operator=( LocalSocket&& rrOther ) noexcept;
+
+//////////////////////////////////////////////////////////////////////////
+
+	static LocalSocket Connect( const std::filesystem::path& rPath );
+	static LocalSocket Listen ( const std::filesystem::path& rPath );
+
+//////////////////////////////////////////////////////////////////////////
+
+	LocalSocket Accept    ( void );
+	bool        Send      ( const void* pData, size_t Size );
+	bool        Receive   ( void* pData, size_t Size );
+	void        SetTimeout( int Milliseconds );
+	void        Close     ( void );
+	bool        IsValid   ( void ) const { return m_Descriptor >= 0; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	explicit LocalSocket( int Descriptor ) : m_Descriptor( Descriptor ) { }
+
+//////////////////////////////////////////////////////////////////////////
+
+	int m_Descriptor = -1;
+
+}; // LocalSocket
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Collects the output of a process in fixed-size chunks, so that large outputs are never moved around while they grow
+class OutputBuffer
+{
+public:
+
+	// Called for every complete line, without the line break. Lines are not stored when a callback is set.
+	using LineCallback = std::function< void( std::string_view Line ) >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Bytes beyond MaxSize are dropped. A MaxSize of 0 discards everything.
+	explicit OutputBuffer( size_t MaxSize = std::numeric_limits< size_t >::max() );
+	explicit OutputBuffer( LineCallback Callback );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void        Append   ( std::string_view Data );
+	void        Flush    ( void );
+	std::string ToString ( void ) const;
+	void        WriteTo  ( std::ostream& rStream ) const;
+	size_t      Size     ( void ) const { return m_Size; }
+	bool        Empty    ( void ) const { return m_Size == 0; }
+	bool        Truncated( void ) const { return m_Truncated; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::vector< std::string > m_Chunks      = { };
+	std::string                m_PartialLine = { };
+	LineCallback               m_Callback    = { };
+	size_t                     m_MaxSize     = std::numeric_limits< size_t >::max();
+	size_t                     m_Size        = 0;
+	bool                       m_Truncated   = false;
+
+}; // OutputBuffer
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <vector>
 
  //////////////////////////////////////////////////////////////////////////
 
@@ -31,11 +33,34 @@ using ProcessID = pid_t;
 
 //////////////////////////////////////////////////////////////////////////
 
+class CancellationToken;
+class OutputBuffer;
+
 class Process
 {
 public:
+
+	// UTF-8 encoded arguments, passed to the program as they are
+	using Arguments = std::vector< std::string >;
+
+	// Resources that the process used, as reported by the system once it exited
+	struct ResourceUsage
+	{
+		int64_t  UserTime            = 0; // Microseconds
+		int64_t  SystemTime          = 0; // Microseconds
+		uint64_t PeakMemory          = 0; // Bytes
+		uint64_t BlockInputs         = 0;
+		uint64_t BlockOutputs        = 0;
+		uint64_t VoluntarySwitches   = 0;
+		uint64_t InvoluntarySwitches = 0;
+
+	}; // ResourceUsage
+
+//////////////////////////////////////////////////////////////////////////
+
 	 Process( void ) { }
 	 Process( const std::wstring_view& rCommandLine );
+	 Process( Arguments Argv, Arguments Environment = { } );
 	~Process( void ) { ForceKill(); }
 	 Process( const Process& rOther );
 	 Process( Process&& rrOther ) noexcept;
@@ -46,8 +71,14 @@ public:
 			 return *this;
 
 		 m_CommandLine = rOther.m_CommandLine;
+		 m_Arguments   = rOther.m_Arguments;
+		 m_Environment = rOther.m_Environment;
+		 m_Usage       = rOther.m_Usage;
 		 m_ExitCode    = rOther.m_ExitCode;
 		 m_Pid         = rOther.m_Pid;
+ #if defined( _WIN32 )
+		 m_Job         = rOther.m_Job;
+ #endif // _WIN32
 
 		 return *this;
 	 }
@@ -55,8 +86,14 @@ public:
 	 Process& operator=( const Process&& rrOther ) noexcept
 	 {
 		 m_CommandLine = rrOther.m_CommandLine;
+		 m_Arguments = rrOther.m_Arguments;
+		 m_Environment = rrOther.m_Environment;
+		 m_Usage = rrOther.m_Usage;
 		 m_ExitCode = rrOther.m_ExitCode;
 		 m_Pid = rrOther.m_Pid;
+ #if defined( _WIN32 )
+		 m_Job = rrOther.m_Job;
+ #endif // _WIN32
 
 		 return *this;
 	 }
@@ -70,23 +107,45 @@ public:
 //////////////////////////////////////////////////////////////////////////
 
 	 void         SetCommandLine( const std::wstring& rCommandLine ) { m_CommandLine = rCommandLine; }
+	 void         Kill          ( void );
 	 void         ForceKill     ( void );
 	 void         TryKill       ( void );
 	 void         Start         ( FILE* pOutputStream );
-	 int          Wait          ( void );
-	 int          ResultOf      ( void );
+	 int          Wait          ( const CancellationToken* pCancellationToken = nullptr );
+	 int          ResultOf      ( const CancellationToken* pCancellationToken = nullptr );
+	 int          Capture       ( OutputBuffer& rOutput, const CancellationToken* pCancellationToken = nullptr );
 	 std::wstring OutputOf      ( int& rResult );
 	 std::wstring OutputOf      ( void );
 	 bool         IsRunning     ( void )                             { return m_Running; }
+	 bool         HasExited     ( void );
+	 int          ExitCode      ( void ) const                       { return m_ExitCode; }
+	 ProcessID    Pid           ( void ) const                       { return m_Pid; }
+
+//////////////////////////////////////////////////////////////////////////
+
+	 const ResourceUsage& Usage        ( void ) const { return m_Usage; }
+	 uint64_t             CurrentMemory( void ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	 static std::string JoinArguments( const Arguments& rArguments );
 
 private:
 
+	 void SpawnArguments( FILE* pOutputStream );
+
+//////////////////////////////////////////////////////////////////////////
+
 	std::wstring m_CommandLine;
+	Arguments    m_Arguments;
+	Arguments    m_Environment;
+	ResourceUsage m_Usage;
 	bool m_Running = false;
 	int m_ExitCode  = 0;
 
 #if defined( _WIN32 )
 	ProcessID m_Pid = nullptr;
+	HANDLE    m_Job = nullptr; // Holds the process and everything that it starts
 #elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
 	ProcessID m_Pid = 0;
 #endif //__linux__ || __APPLE__
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Macros.h"
+#include "Common/OutputBuffer.h"
+#include "Common/Process.h"
+#include "Common/ResourceGovernor.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CancellationToken;
+
+class ProcessReactor
+{
+	GENO_SINGLETON( ProcessReactor );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	struct Result
+	{
+		int                                   ExitCode  = -1;
+		OutputBuffer                          Output;        // Everything that the process wrote to stdout and stderr
+		Process::ResourceUsage                Usage;
+		std::chrono::steady_clock::time_point StartTime = { };
+
+	}; // Result
+
+	struct Status
+	{
+		size_t                       NumRunning = 0;
+		size_t                       NumPending = 0;
+		size_t                       Limit      = 0; // Lower than MaxProcesses() while the governor holds processes back
+		ResourceGovernor::Constraint Constraint = ResourceGovernor::Constraint::None;
+
+	}; // Status
+
+//////////////////////////////////////////////////////////////////////////
+
+	 ProcessReactor( void );
+	~ProcessReactor( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Starts the process as soon as fewer than MaxProcesses() are running, the system has the resources for it and the jobserver has a slot for it. The token must outlive the process.
+	// ExpectedMemory is the peak memory of the process the last time it ran, or 0 if that's unknown.
+	// OnLine is called from the reactor thread for every line of output as it arrives. The output is still collected in the result.
+	std::shared_future< Result > Launch( Process::Arguments Arguments, const CancellationToken* pCancellationToken = nullptr, uint64_t ExpectedMemory = 0, OutputBuffer::LineCallback OnLine = { } );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void   SetMaxProcesses( size_t MaxProcesses );
+	size_t MaxProcesses   ( void ) const { return m_MaxProcesses.load( std::memory_order_relaxed ); }
+	Status CurrentStatus  ( void ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	struct Child
+	{
+		Process                  Instance;
+		std::promise< Result >   Promise;
+		Result                   Outcome;
+		OutputBuffer             Lines;
+		const CancellationToken* pCancellationToken = nullptr;
+#if defined( _WIN32 )
+		HANDLE                   OutputPipe         = nullptr;
+#endif // _WIN32
+		int                      OutputDescriptor   = -1;
+		int                      PidDescriptor      = -1;
+		uint64_t                 ExpectedMemory     = 0;
+		bool                     HasOwnSlot         = false;
+		bool                     HasJobSlot         = false;
+		bool                     Killed             = false;
+
+	}; // Child
+
+	using ChildPtr = std::unique_ptr< Child >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	void     ThreadEntry  ( void );
+	void     Admit        ( void );
+	void     Spawn        ( ChildPtr NewChild );
+	void     WaitForEvents( bool Poll );
+	void     ReadOutput   ( Child& rChild );
+	void     Finish       ( Child& rChild );
+	void     ReleaseSlot  ( Child& rChild );
+	void     Wake         ( void );
+	uint64_t RunningMemory( void ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::deque< ChildPtr >                      m_Pending       = { };
+	std::vector< ChildPtr >                     m_Running       = { };
+	std::unordered_map< int, Child* >           m_Descriptors   = { };
+	std::mutex                                  m_Mutex         = { };
+	std::thread                                 m_Thread        = { };
+	std::atomic< size_t >                       m_MaxProcesses  = 1;
+	std::atomic< bool >                         m_Stopping      = false;
+
+	ResourceGovernor                            m_Governor      = { };
+	std::chrono::steady_clock::time_point       m_RetryTime     = { };
+	bool                                        m_Throttled     = false;
+	bool                                        m_OwnSlotInUse  = false;
+	std::atomic< size_t >                       m_NumRunning    = 0;
+	std::atomic< size_t >                       m_NumPending    = 0;
+	std::atomic< ResourceGovernor::Constraint > m_Constraint    = ResourceGovernor::Constraint::None;
+
+#if defined( _WIN32 )
+	HANDLE                                      m_WakeEvent     = nullptr;
+#elif defined( __linux__ ) // _WIN32
+	int                                         m_Epoll         = -1;
+	int                                         m_WakeFd        = -1;
+#else // __linux__
+	int                                         m_WakePipe[ 2 ] = { -1, -1 };
+#endif // !_WIN32 && !__linux__
+
+}; // ProcessReactor
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Decides whether another process may start next to the running ones, based on the memory that the system has left and on how busy it already is
+class ResourceGovernor
+{
+public:
+
+	enum class Constraint
+	{
+		None,
+		Load,
+		Memory,
+		Jobserver,
+
+	}; // Constraint
+
+//////////////////////////////////////////////////////////////////////////
+
+	// RunningMemory is how much more the running processes are still expected to allocate
+	bool     Admit   ( uint64_t ExpectedMemory, size_t NumRunning, uint64_t RunningMemory );
+	void     Record  ( uint64_t PeakMemory );
+	uint64_t Estimate( uint64_t ExpectedMemory ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	Constraint CurrentConstraint( void ) const { return m_Constraint; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	static constexpr uint64_t                  DEFAULT_ESTIMATE = 256ull << 20;
+	static constexpr uint64_t                  MIN_RESERVE      = 512ull << 20;
+	static constexpr std::chrono::milliseconds SAMPLE_INTERVAL  = std::chrono::milliseconds( 250 );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void Sample( size_t NumRunning );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::chrono::steady_clock::time_point m_LastSample      = { };
+	uint64_t                              m_TotalMemory     = 0;
+	uint64_t                              m_AvailableMemory = 0;
+	double                                m_OtherLoad       = 0.0; // Cores that something other than this build keeps busy
+	double                                m_BuildLoad       = 0.0; // The share of the load average that this build added, decayed like the load average
+	uint64_t                              m_RecordedMemory  = 0;
+	uint64_t                              m_NumRecorded     = 0;
+	Constraint                            m_Constraint      = Constraint::None;
+
+}; // ResourceGovernor
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Common/Process.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class LocalSocket;
+
+// The messages between Geno and geno-worker. Geno preprocesses a file itself and sends the preprocessed source along with the command line to
+// compile it. The worker compiles it in a directory of its own and sends back the object file and everything that the compiler printed.
+// geno-buildd speaks the same protocol. It is sent a workspace to build, streams back what the build prints and ends with the exit code.
+// Every message is a header followed by its payload. Both ends run on the same machine, so values are sent in the native byte order.
+namespace WorkerProtocol
+{
+	constexpr uint32_t         MAGIC              = 0x4B574E47; // "GNWK"
+	constexpr uint32_t         VERSION            = 3;
+	constexpr uint64_t         MAX_PAYLOAD_SIZE   = 1ull << 30;
+
+	// Stand-ins for the paths of the source and object files in the arguments of a compile request, which only the worker knows
+	constexpr std::string_view INPUT_PLACEHOLDER  = "<input>";
+	constexpr std::string_view OUTPUT_PLACEHOLDER = "<output>";
+
+//////////////////////////////////////////////////////////////////////////
+
+	enum class MessageType : uint32_t
+	{
+		Status,       // No payload
+		StatusReply,
+		Compile,
+		CompileReply,
+		Build,
+		BuildOutput,  // Payload is text
+		BuildReply,
+
+	}; // MessageType
+
+	struct StatusReply
+	{
+		uint32_t Slots   = 0; // How many files the worker compiles at once
+		uint32_t Running = 0;
+
+	}; // StatusReply
+
+	struct CompileRequest
+	{
+		Process::Arguments Arguments;
+		std::string        SourceName; // Only the extension matters, since compilers pick the language from it
+		std::string        Source;
+
+	}; // CompileRequest
+
+	struct CompileReply
+	{
+		int32_t                ExitCode = -1;
+		std::string            Output;
+		std::string            Object;   // Empty if the compile failed
+		Process::ResourceUsage Usage;
+
+	}; // CompileReply
+
+	struct BuildRequest
+	{
+		std::string                Workspace;  // Absolute path of the workspace file
+		std::vector< std::string > Selections; // "Column=Value", for every column of the build matrix that differs from the workspace file
+		std::string                Project;    // Builds only this project and the projects that it links with, unless empty
+
+	}; // BuildRequest
+
+	struct BuildReply
+	{
+		int32_t ExitCode = 2; // Same as a headless build: 0 if it succeeded, 1 if it failed and 2 if it couldn't start
+
+	}; // BuildReply
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool                         Send   ( LocalSocket& rSocket, MessageType Type, std::string_view Payload = { } );
+	std::optional< MessageType > Receive( LocalSocket& rSocket, std::string& rPayload );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::string Encode( const StatusReply& rMessage );
+	std::string Encode( const CompileRequest& rMessage );
+	std::string Encode( const CompileReply& rMessage );
+	std::string Encode( const BuildRequest& rMessage );
+	std::string Encode( const BuildReply& rMessage );
+
+	bool        Decode( std::string_view Payload, StatusReply& rMessage );
+	bool        Decode( std::string_view Payload, CompileRequest& rMessage );
+	bool        Decode( std::string_view Payload, CompileReply& rMessage );
+	bool        Decode( std::string_view Payload, BuildRequest& rMessage );
+	bool        Decode( std::string_view Payload, BuildReply& rMessage );
+
+} // ::WorkerProtocol
@@ -0,0 +1,34 @@
+require 'library'
+
+tools = { }
+
+function tool( name, executable )
+	group 'Tools'
+	project( name )
+
+	includedirs { 'src/%{prj.name}/C++' }
+	kind 'ConsoleApp'
+	links( libraries )
+	location 'build/%{_ACTION}'
+	sysincludedirs { 'include' }
+	targetname( executable )
+
+	files {
+		'src/%{prj.name}/C++/**.cpp',
+		'src/%{prj.name}/C++/**.h',
+	}
+
+	vpaths {
+		[ 'Source Files/*' ] = 'src/' .. name .. '/C++',
+	}
+
+	filter 'system:linux'
+		links {
+			'stdc++fs',
+			'pthread',
+		}
+
+	filter { }
+
+	table.insert( tools, name )
+end
@@ -6,6 +6,7 @@ require 'premake/library'
 require 'premake/options'
 require 'premake/target'
 require 'premake/third_party_library'
+require 'premake/tool'
 require 'premake/utils'
 
 workspace( 'Geno' )
@@ -63,3 +64,31 @@ app( 'Geno' )
 			'AppKit.framework',
 			'OpenGL.framework',
 		}
+
+filter { }
+
+tool( 'GenoWorker', 'geno-worker' )
+
+tool( 'GenoBuildd', 'geno-buildd' )
+	includedirs {
+		'src/Geno/C++',
+	}
+
+	sysincludedirs {
+		'third_party/rapidjson/include',
+	}
+
+	files {
+		'src/Geno/C++/Build/**.cpp',
+		'src/Geno/C++/Build/**.h',
+		'src/Geno/C++/Compilers/**.cpp',
+		'src/Geno/C++/Compilers/**.h',
+		'src/Geno/C++/Components/**.cpp',
+		'src/Geno/C++/Components/**.h',
+	}
+
+	vpaths {
+		[ 'Geno/*' ] = 'src/Geno/C++',
+	}
+
+filter { }
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/Async/CancellationToken.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+CancellationToken::CancellationToken( uint32_t FailureLimit )
+	: m_FailureLimit( FailureLimit )
+{
+
+} // CancellationToken
+
+//////////////////////////////////////////////////////////////////////////
+
+void CancellationToken::Cancel( void )
+{
+	m_Cancelled.store( true, std::memory_order_relaxed );
+
+} // Cancel
+
+//////////////////////////////////////////////////////////////////////////
+
+void CancellationToken::ReportFailure( void )
+{
+	// Jobs that were killed by the cancellation aren't failures of their own
+	if( IsCancelled() )
+		return;
+
+	const uint32_t Failures = m_Failures.fetch_add( 1, std::memory_order_relaxed ) + 1;
+
+	if( m_FailureLimit > 0 && Failures >= m_FailureLimit )
+		Cancel();
+
+} // ReportFailure
@@ -19,6 +19,15 @@
 
 #include "Common/Async/Job.h"
 
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+
+static thread_local size_t                              ThreadIndex          = 0;
+static thread_local std::chrono::steady_clock::duration JobQueueTime         = { };
+static thread_local const CancellationToken*            JobCancellationToken = nullptr;
+static thread_local JobSystem::JobPtr                   RunningJob           = nullptr;
+
 //////////////////////////////////////////////////////////////////////////
 
 JobSystem::~JobSystem( void )
@@ -34,10 +43,13 @@ void JobSystem::StartThreads( size_t ThreadCount )
 	StopThreads();
 	m_Threads.clear();
 
-	m_Running = true;
+	{
+		std::scoped_lock Lock( m_JobsMutex );
+		m_Running = true;
+	}
 
 	for( size_t i = 0; i < ThreadCount; ++i )
-		m_Threads.emplace_back( &JobSystem::ThreadEntry, this );
+		m_Threads.emplace_back( &JobSystem::ThreadEntry, this, i + 1 );
 
 } // StartThreads
 
@@ -45,7 +57,12 @@ void JobSystem::StartThreads( size_t ThreadCount )
 
 void JobSystem::StopThreads( void )
 {
-	m_Running = false;
+	{
+		std::scoped_lock Lock( m_JobsMutex );
+		m_Running = false;
+	}
+
+	m_JobsReady.notify_all();
 
 	for( std::thread& rThread : m_Threads )
 		rThread.join();
@@ -54,39 +71,170 @@ void JobSystem::StopThreads( void )
 
 //////////////////////////////////////////////////////////////////////////
 
-void JobSystem::ThreadEntry( void )
+size_t JobSystem::CurrentThreadIndex( void )
+{
+	return ThreadIndex;
+
+} // CurrentThreadIndex
+
+//////////////////////////////////////////////////////////////////////////
+
+std::chrono::steady_clock::duration JobSystem::CurrentJobQueueTime( void )
+{
+	return JobQueueTime;
+
+} // CurrentJobQueueTime
+
+//////////////////////////////////////////////////////////////////////////
+
+const CancellationToken* JobSystem::CurrentCancellationToken( void )
+{
+	return JobCancellationToken;
+
+} // CurrentCancellationToken
+
+//////////////////////////////////////////////////////////////////////////
+
+void JobSystem::FutureFulfilled( void )
+{
+	std::scoped_lock Lock( m_JobsMutex );
+
+	// Only the continuations of work that is still in flight wait here, so there are never more of them than there are processes and remote compiles
+	auto Waiting = std::partition( m_Continuations.begin(), m_Continuations.end(), []( const JobPtr& rJob ) { return !rJob->m_Ready(); } );
+
+	for( auto it = Waiting; it != m_Continuations.end(); ++it )
+		Queue( std::move( *it ) );
+
+	m_Continuations.erase( Waiting, m_Continuations.end() );
+
+} // FutureFulfilled
+
+//////////////////////////////////////////////////////////////////////////
+
+void JobSystem::ThreadEntry( size_t Index )
 {
-	while( m_Running )
+	// Worker threads are numbered from 1 so that 0 identifies any other thread
+	ThreadIndex = Index;
+
+	std::unique_lock Lock( m_JobsMutex );
+
+	while( true )
 	{
-		while( !m_Jobs.empty() )
-		{
-			JobPtr Job;
+		// Idle workers sleep until a job is queued
+		m_JobsReady.wait( Lock, [ this ]( void ) { return !m_Running || !m_ReadyJobs.empty(); } );
 
-			m_JobsMutex.lock();
+		if( !m_Running )
+			break;
 
-			for( auto it = m_Jobs.begin(); it != m_Jobs.end(); ++it )
-			{
-				JobPtr& rJob = *it;
+		// Start the ready job with the longest path to the end of the build, so that long jobs don't end up running last
+		JobPtr Job = std::move( m_ReadyJobs.extract( m_ReadyJobs.begin() ).value() );
+		Job->m_Queued = false;
 
-				if( rJob && rJob->CanRun() )
-				{
-					Job = rJob;
-					m_Jobs.erase( it );
-					break;
-				}
-			}
+		Lock.unlock();
 
-			m_JobsMutex.unlock();
+		JobQueueTime         = std::chrono::steady_clock::now() - Job->m_QueuedTime;
+		JobCancellationToken = Job->m_CancellationToken.get();
+		RunningJob           = Job;
 
-			if( Job )
-			{
-				Job->m_Function();
-				Job->m_HasFinishedRunning = true;
-			}
-		}
+		// Cancelled jobs still finish so that whatever depends on them is released. Continuations always run, since they clean up work that was already started.
+		if( Job->m_Continues || !JobCancellationToken || !JobCancellationToken->IsCancelled() )
+			Job->m_Function();
+
+		JobCancellationToken = nullptr;
+		RunningJob           = nullptr;
 
-		// Always sleep a little bit to avoid exhausting the CPU
-		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		Lock.lock();
+
+		if( !Job->m_Continued )
+			Finish( *Job );
 	}
 
 } // ThreadEntry
+
+//////////////////////////////////////////////////////////////////////////
+
+void JobSystem::Queue( JobPtr Job )
+{
+	// The queue time is how long the job waited for a worker, not for its dependencies
+	Job->m_Queued     = true;
+	Job->m_QueuedTime = std::chrono::steady_clock::now();
+	m_ReadyJobs.insert( std::move( Job ) );
+
+	m_JobsReady.notify_one();
+
+} // Queue
+
+//////////////////////////////////////////////////////////////////////////
+
+void JobSystem::Finish( Job& rJob )
+{
+	// A continuation finishes the jobs that it continues
+	for( Job* pJob = &rJob; pJob; pJob = pJob->m_Continues.get() )
+	{
+		pJob->m_HasFinishedRunning = true;
+
+		for( JobPtr& rDependent : pJob->m_Dependents )
+		{
+			if( --rDependent->m_Pending == 0 )
+				Queue( std::move( rDependent ) );
+		}
+
+		pJob->m_Dependents.clear();
+	}
+
+	rJob.m_Continues.reset();
+
+} // Finish
+
+//////////////////////////////////////////////////////////////////////////
+
+void JobSystem::RaiseCriticalPath( Job& rJob, int64_t SuccessorPath )
+{
+	const int64_t CriticalPath = rJob.m_Cost.Duration + SuccessorPath;
+
+	if( CriticalPath <= rJob.m_CriticalPath )
+		return;
+
+	// The ready queue is ordered by the critical path, so a queued job has to be taken out while it changes
+	if( rJob.m_Queued )
+	{
+		auto Node = m_ReadyJobs.extract( m_ReadyJobs.find( &rJob ) );
+
+		Node.value()->m_CriticalPath = CriticalPath;
+		m_ReadyJobs.insert( std::move( Node ) );
+	}
+	else
+	{
+		rJob.m_CriticalPath = CriticalPath;
+	}
+
+	for( auto& rDependency : rJob.m_Dependencies )
+	{
+		if( auto JobPtr = rDependency.lock(); JobPtr && !JobPtr->m_HasFinishedRunning )
+			RaiseCriticalPath( *JobPtr, rJob.m_CriticalPath );
+	}
+
+} // RaiseCriticalPath
+
+//////////////////////////////////////////////////////////////////////////
+
+JobSystem::JobPtr JobSystem::CurrentJob( void )
+{
+	return RunningJob;
+
+} // CurrentJob
+
+//////////////////////////////////////////////////////////////////////////
+
+bool JobSystem::RunsBefore::operator()( const Job* pA, const Job* pB ) const
+{
+	if( pA->m_CriticalPath != pB->m_CriticalPath )
+		return pA->m_CriticalPath > pB->m_CriticalPath;
+
+	if( pA->m_Cost.Size != pB->m_Cost.Size )
+		return pA->m_Cost.Size > pB->m_Cost.Size;
+
+	// Jobs are otherwise started in the order that they were created
+	return pA->m_Sequence < pB->m_Sequence;
+
+} // RunsBefore
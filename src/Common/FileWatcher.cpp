@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/FileWatcher.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#if defined( __linux__ )
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+//////////////////////////////////////////////////////////////////////////
+
+FileWatcher::FileWatcher( void )
+{
+
+#if defined( __linux__ )
+
+	m_Descriptor = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+
+#endif // __linux__
+
+} // FileWatcher
+
+//////////////////////////////////////////////////////////////////////////
+
+FileWatcher::~FileWatcher( void )
+{
+
+#if defined( __linux__ )
+
+	if( m_Descriptor >= 0 )
+		close( m_Descriptor );
+
+#endif // __linux__
+
+} // ~FileWatcher
+
+//////////////////////////////////////////////////////////////////////////
+
+bool FileWatcher::Watch( [[ maybe_unused ]] const std::filesystem::path& rDirectory )
+{
+
+#if defined( __linux__ )
+
+	if( m_Descriptor < 0 )
+		return false;
+
+	// Editors that save through a temporary file rename it over the original, so moves count as writes
+	constexpr uint32_t Mask  = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+	const int          Watch = inotify_add_watch( m_Descriptor, rDirectory.c_str(), Mask );
+
+	if( Watch < 0 )
+		return false;
+
+	// Watching a directory again returns the same watch
+	m_Directories[ Watch ] = rDirectory;
+
+	return true;
+
+#else // __linux__
+
+	return false;
+
+#endif // !__linux__
+
+} // Watch
+
+//////////////////////////////////////////////////////////////////////////
+
+bool FileWatcher::Poll( [[ maybe_unused ]] std::vector< std::filesystem::path >& rChanges )
+{
+
+#if defined( __linux__ )
+
+	if( m_Descriptor < 0 )
+		return false;
+
+	alignas( inotify_event ) std::array< char, 16 * 1024 > Buffer;
+	bool                                                   Complete = true;
+
+	for( ;; )
+	{
+		const ssize_t Length = read( m_Descriptor, Buffer.data(), Buffer.size() );
+
+		if( Length < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+
+			// Anything but running out of events means that some may have been missed
+			return Complete && errno == EAGAIN;
+		}
+
+		for( ssize_t Offset = 0; Offset < Length; )
+		{
+			inotify_event Event;
+			memcpy( &Event, Buffer.data() + Offset, sizeof( Event ) );
+
+			const char* pName = Buffer.data() + Offset + sizeof( Event );
+			Offset           += static_cast< ssize_t >( sizeof( Event ) + Event.len );
+
+			if( Event.mask & IN_Q_OVERFLOW )
+			{
+				Complete = false;
+				continue;
+			}
+
+			auto Directory = m_Directories.find( Event.wd );
+			if( Directory == m_Directories.end() )
+				continue;
+
+			// The name is only given for files inside the directory. A directory that went away is a change of its own.
+			if( Event.len > 0 )
+				rChanges.push_back( Directory->second / std::string( pName, strnlen( pName, Event.len ) ) );
+			else if( Event.mask & ( IN_DELETE_SELF | IN_MOVE_SELF ) )
+				rChanges.push_back( Directory->second );
+
+			if( Event.mask & IN_IGNORED )
+				m_Directories.erase( Directory );
+		}
+	}
+
+#else // __linux__
+
+	return false;
+
+#endif // !__linux__
+
+} // Poll
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/Jobserver.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !_WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+// The token that GNU make writes for every slot
+constexpr char TOKEN = '+';
+
+//////////////////////////////////////////////////////////////////////////
+
+Jobserver::~Jobserver( void )
+{
+	// Slots that were taken from a parent would be lost to the rest of its build otherwise
+	while( !m_Tokens.empty() )
+		Release();
+
+#if defined( _WIN32 )
+
+	if( m_Semaphore )
+		CloseHandle( m_Semaphore );
+
+#else // _WIN32
+
+	for( int Descriptor : { m_Descriptor, m_ChildDescriptor } )
+	{
+		if( Descriptor >= 0 )
+			close( Descriptor );
+	}
+
+#endif // !_WIN32
+
+} // ~Jobserver
+
+//////////////////////////////////////////////////////////////////////////
+
+void Jobserver::Start( size_t NumSlots )
+{
+	if( m_Active )
+		return;
+
+	m_Active = Join() || Create( NumSlots );
+
+} // Start
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Jobserver::TryAcquire( void )
+{
+	if( !m_Active )
+		return true;
+
+#if defined( _WIN32 )
+
+	if( WaitForSingleObject( m_Semaphore, 0 ) != WAIT_OBJECT_0 )
+		return false;
+
+	m_Tokens.push_back( TOKEN );
+
+#else // _WIN32
+
+	// The descriptor is non-blocking, so this fails right away when all slots are taken
+	char Token;
+	if( read( m_Descriptor, &Token, 1 ) != 1 )
+		return false;
+
+	m_Tokens.push_back( Token );
+
+#endif // !_WIN32
+
+	return true;
+
+} // TryAcquire
+
+//////////////////////////////////////////////////////////////////////////
+
+void Jobserver::Release( void )
+{
+	if( m_Tokens.empty() )
+		return;
+
+	const char Token = m_Tokens.back();
+	m_Tokens.pop_back();
+
+#if defined( _WIN32 )
+
+	( void )Token;
+	ReleaseSemaphore( m_Semaphore, 1, nullptr );
+
+#else // _WIN32
+
+	while( write( m_Descriptor, &Token, 1 ) < 0 && errno == EINTR );
+
+#endif // !_WIN32
+
+} // Release
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Jobserver::Join( void )
+{
+	const char* pMakeFlags = getenv( "MAKEFLAGS" );
+	if( !pMakeFlags )
+		return false;
+
+	// Older versions of make use --jobserver-fds. If the option is repeated, the last one counts.
+	const std::string_view MakeFlags = pMakeFlags;
+	size_t                 Start     = MakeFlags.rfind( "--jobserver-auth=" );
+
+	if( Start != std::string_view::npos )
+		Start += std::size( "--jobserver-auth=" ) - 1;
+	else if( ( Start = MakeFlags.rfind( "--jobserver-fds=" ) ) != std::string_view::npos )
+		Start += std::size( "--jobserver-fds=" ) - 1;
+	else
+		return false;
+
+	const std::string Auth = std::string( MakeFlags.substr( Start, MakeFlags.find( ' ', Start ) - Start ) );
+
+#if defined( _WIN32 )
+
+	m_Semaphore = OpenSemaphoreA( SEMAPHORE_ALL_ACCESS, FALSE, Auth.c_str() );
+
+	if( !m_Semaphore )
+	{
+		std::cerr << "Failed to join the jobserver " << Auth << "\n";
+		return false;
+	}
+
+#else // _WIN32
+
+	if( Auth.starts_with( "fifo:" ) )
+	{
+		m_Descriptor = open( Auth.c_str() + 5, O_RDWR | O_NONBLOCK | O_CLOEXEC );
+	}
+	else
+	{
+		int ReadDescriptor;
+		int WriteDescriptor;
+
+		if( sscanf( Auth.c_str(), "%d,%d", &ReadDescriptor, &WriteDescriptor ) != 2 || fcntl( ReadDescriptor, F_GETFD ) < 0 )
+		{
+			// Make only passes the pipe to commands that it knows are recursive makes
+			std::cerr << "Not joining the jobserver in MAKEFLAGS, because its pipe wasn't inherited\n";
+			return false;
+		}
+
+#if defined( __linux__ )
+		// The pipe is shared with make and the other jobs, so it must stay blocking for them. Reopening it gives this process its own non-blocking view of it.
+		m_Descriptor = open( ( "/proc/self/fd/" + std::to_string( ReadDescriptor ) ).c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC );
+#endif // __linux__
+	}
+
+	if( m_Descriptor < 0 )
+	{
+		std::cerr << "Failed to join the jobserver " << Auth << "\n";
+		return false;
+	}
+
+#endif // !_WIN32
+
+	return true;
+
+} // Join
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Jobserver::Create( size_t NumSlots )
+{
+	// This process has a slot of its own, like every other client
+	const size_t NumTokens = NumSlots > 1 ? NumSlots - 1 : 0;
+	std::string  Auth;
+
+#if defined( _WIN32 )
+
+	Auth        = "gmake_semaphore_geno_" + std::to_string( GetCurrentProcessId() );
+	m_Semaphore = CreateSemaphoreA( nullptr, static_cast< LONG >( NumTokens ), static_cast< LONG >( std::max< size_t >( NumTokens, 1 ) ), Auth.c_str() );
+
+	if( !m_Semaphore )
+	{
+		std::cerr << "Failed to create the jobserver semaphore " << Auth << "\n";
+		return false;
+	}
+
+#else // _WIN32
+
+	std::error_code   Error;
+	const std::string Path = ( std::filesystem::temp_directory_path( Error ) / ( "geno-jobserver-" + std::to_string( getpid() ) ) ).string();
+
+	unlink( Path.c_str() );
+
+	if( mkfifo( Path.c_str(), 0600 ) != 0 )
+	{
+		std::cerr << "Failed to create the jobserver fifo " << Path << "\n";
+		return false;
+	}
+
+	// The fifo is opened twice, so that children can block on it while this process doesn't. Children get inherited descriptors rather than the path,
+	// because makes older than 4.4 don't understand --jobserver-auth=fifo:PATH.
+	m_Descriptor      = open( Path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC );
+	m_ChildDescriptor = open( Path.c_str(), O_RDWR );
+
+	unlink( Path.c_str() );
+
+	const std::string Tokens( NumTokens, TOKEN );
+
+	if( m_Descriptor < 0 || m_ChildDescriptor < 0 || ( !Tokens.empty() && write( m_Descriptor, Tokens.data(), Tokens.size() ) != static_cast< ssize_t >( Tokens.size() ) ) )
+	{
+		std::cerr << "Failed to set up the jobserver fifo " << Path << "\n";
+		return false;
+	}
+
+	Auth = std::to_string( m_ChildDescriptor ) + "," + std::to_string( m_ChildDescriptor );
+
+#endif // !_WIN32
+
+	m_Owner = true;
+
+	// Child processes find the jobserver the same way that the jobs of a make do
+	std::string MakeFlags = " -j" + std::to_string( NumSlots ) + " --jobserver-auth=" + Auth;
+
+	if( const char* pMakeFlags = getenv( "MAKEFLAGS" ); pMakeFlags && *pMakeFlags )
+		MakeFlags = pMakeFlags + MakeFlags;
+
+#if defined( _WIN32 )
+	SetEnvironmentVariableA( "MAKEFLAGS", MakeFlags.c_str() );
+	_putenv_s( "MAKEFLAGS", MakeFlags.c_str() );
+#else // _WIN32
+	setenv( "MAKEFLAGS", MakeFlags.c_str(), 1 );
+#endif // !_WIN32
+
+	return true;
+
+} // Create
@@ -18,6 +18,7 @@
 #include "Common/LocalAppData.h"
 
 #include <array>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
 
@@ -60,17 +61,22 @@ LocalAppData::LocalAppData( void )
 	{
 		strcpy( Buffer, pDataHome );
 	}
-	else if( const char* pDataDirs = getenv( "XDG_DATA_DIRS" ); pDataHome != nullptr )
+	else if( const char* pDataDirs = getenv( "XDG_DATA_DIRS" ); pDataDirs != nullptr )
 	{
 		if( const char* pColon = strchr( pDataDirs, ':' ); pColon != nullptr )
 		{
-			strncpy( Buffer, pDataDirs, pColon - pDataDirs - 1 );
+			strncpy( Buffer, pDataDirs, pColon - pDataDirs );
 		}
 		else
 		{
 			strcpy( Buffer, pDataDirs );
 		}
 	}
+	else if( const char* pHome = getenv( "HOME" ); pHome != nullptr )
+	{
+		strcpy( Buffer, pHome );
+		strcat( Buffer, "/.local/share" );
+	}
 	else
 	{
 		return;
@@ -78,7 +84,7 @@ LocalAppData::LocalAppData( void )
 
 	strcat( Buffer, "/geno" );
 
-	if( mkdir( Buffer, 0777 ) != 0 )
+	if( mkdir( Buffer, 0777 ) != 0 && errno != EEXIST )
 		return;
 
 	m_Path.assign( std::begin( Buffer ), std::begin( Buffer ) + strnlen( Buffer, std::size( Buffer ) ) );
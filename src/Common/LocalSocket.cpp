@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/LocalSocket.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // !_WIN32
+
+#if !defined( MSG_NOSIGNAL )
+#define MSG_NOSIGNAL 0
+#endif // !MSG_NOSIGNAL
+
+//////////////////////////////////////////////////////////////////////////
+
+#if !defined( _WIN32 )
+
+static bool MakeAddress( const std::filesystem::path& rPath, sockaddr_un& rAddress )
+{
+	const std::string Path = rPath.string();
+
+	// The path has to fit in the address, including the terminator
+	if( Path.empty() || Path.size() >= sizeof( rAddress.sun_path ) )
+		return false;
+
+	memset( &rAddress, 0, sizeof( rAddress ) );
+	rAddress.sun_family = AF_UNIX;
+	memcpy( rAddress.sun_path, Path.c_str(), Path.size() + 1 );
+
+	return true;
+
+} // MakeAddress
+
+//////////////////////////////////////////////////////////////////////////
+
+static int OpenSocket( void )
+{
+	const int Descriptor = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( Descriptor < 0 )
+		return -1;
+
+	fcntl( Descriptor, F_SETFD, FD_CLOEXEC );
+
+#if defined( SO_NOSIGPIPE )
+	// A peer that goes away should fail the write instead of killing the process
+	const int Enable = 1;
+	setsockopt( Descriptor, SOL_SOCKET, SO_NOSIGPIPE, &Enable, sizeof( Enable ) );
+#endif // SO_NOSIGPIPE
+
+	return Descriptor;
+
+} // OpenSocket
+
+#endif // !_WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+LocalSocket::LocalSocket( LocalSocket&& rrOther ) noexcept
+	: m_Descriptor( std::exchange( rrOther.m_Descriptor, -1 ) )
+{
+} // LocalSocket
+
+//////////////////////////////////////////////////////////////////////////
+
+LocalSocket& LocalSocket::operator=( LocalSocket&& rrOther ) noexcept
+{
+	if( this != &rrOther )
+	{
+		Close();
+
+		m_Descriptor = std::exchange( rrOther.m_Descriptor, -1 );
+	}
+
+	return *this;
+
+} // operator=
+
+//////////////////////////////////////////////////////////////////////////
+
+LocalSocket LocalSocket::Connect( [[ maybe_unused ]] const std::filesystem::path& rPath )
+{
+
+#if !defined( _WIN32 )
+
+	sockaddr_un Address;
+	if( !MakeAddress( rPath, Address ) )
+		return LocalSocket();
+
+	LocalSocket Socket( OpenSocket() );
+	if( !Socket.IsValid() )
+		return Socket;
+
+	while( connect( Socket.m_Descriptor, reinterpret_cast< const sockaddr* >( &Address ), sizeof( Address ) ) != 0 )
+	{
+		if( errno != EINTR )
+			return LocalSocket();
+	}
+
+	return Socket;
+
+#else // !_WIN32
+
+	return LocalSocket();
+
+#endif // _WIN32
+
+} // Connect
+
+//////////////////////////////////////////////////////////////////////////
+
+LocalSocket LocalSocket::Listen( [[ maybe_unused ]] const std::filesystem::path& rPath )
+{
+
+#if !defined( _WIN32 )
+
+	sockaddr_un Address;
+	if( !MakeAddress( rPath, Address ) )
+		return LocalSocket();
+
+	LocalSocket Socket( OpenSocket() );
+	if( !Socket.IsValid() )
+		return Socket;
+
+	// A socket file left behind by a previous run would make bind() fail
+	unlink( Address.sun_path );
+
+	if( bind( Socket.m_Descriptor, reinterpret_cast< const sockaddr* >( &Address ), sizeof( Address ) ) != 0 )
+		return LocalSocket();
+
+	// Only the owner may connect, since connecting lets anyone run programs as the owner
+	chmod( Address.sun_path, S_IRUSR | S_IWUSR );
+
+	if( listen( Socket.m_Descriptor, SOMAXCONN ) != 0 )
+		return LocalSocket();
+
+	return Socket;
+
+#else // !_WIN32
+
+	return LocalSocket();
+
+#endif // _WIN32
+
+} // Listen
+
+//////////////////////////////////////////////////////////////////////////
+
+LocalSocket LocalSocket::Accept( void )
+{
+
+#if !defined( _WIN32 )
+
+	for( ;; )
+	{
+		const int Descriptor = accept( m_Descriptor, nullptr, nullptr );
+
+		if( Descriptor >= 0 )
+		{
+			fcntl( Descriptor, F_SETFD, FD_CLOEXEC );
+
+			return LocalSocket( Descriptor );
+		}
+
+		// The peer may give up before its connection was accepted
+		if( errno != EINTR && errno != ECONNABORTED )
+			return LocalSocket();
+	}
+
+#else // !_WIN32
+
+	return LocalSocket();
+
+#endif // _WIN32
+
+} // Accept
+
+//////////////////////////////////////////////////////////////////////////
+
+bool LocalSocket::Send( [[ maybe_unused ]] const void* pData, [[ maybe_unused ]] size_t Size )
+{
+
+#if !defined( _WIN32 )
+
+	const char* pBytes = static_cast< const char* >( pData );
+
+	while( Size > 0 )
+	{
+		const ssize_t Length = send( m_Descriptor, pBytes, Size, MSG_NOSIGNAL );
+
+		if( Length < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+
+			return false;
+		}
+
+		pBytes += Length;
+		Size   -= static_cast< size_t >( Length );
+	}
+
+	return true;
+
+#else // !_WIN32
+
+	return false;
+
+#endif // _WIN32
+
+} // Send
+
+//////////////////////////////////////////////////////////////////////////
+
+bool LocalSocket::Receive( [[ maybe_unused ]] void* pData, [[ maybe_unused ]] size_t Size )
+{
+
+#if !defined( _WIN32 )
+
+	char* pBytes = static_cast< char* >( pData );
+
+	while( Size > 0 )
+	{
+		const ssize_t Length = recv( m_Descriptor, pBytes, Size, 0 );
+
+		if( Length < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+
+			return false;
+		}
+
+		// The peer closed the connection before everything arrived
+		if( Length == 0 )
+			return false;
+
+		pBytes += Length;
+		Size   -= static_cast< size_t >( Length );
+	}
+
+	return true;
+
+#else // !_WIN32
+
+	return false;
+
+#endif // _WIN32
+
+} // Receive
+
+//////////////////////////////////////////////////////////////////////////
+
+void LocalSocket::SetTimeout( [[ maybe_unused ]] int Milliseconds )
+{
+
+#if !defined( _WIN32 )
+
+	timeval Timeout;
+	Timeout.tv_sec  = Milliseconds / 1000;
+	Timeout.tv_usec = ( Milliseconds % 1000 ) * 1000;
+
+	setsockopt( m_Descriptor, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof( Timeout ) );
+	setsockopt( m_Descriptor, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof( Timeout ) );
+
+#endif // !_WIN32
+
+} // SetTimeout
+
+//////////////////////////////////////////////////////////////////////////
+
+void LocalSocket::Close( void )
+{
+
+#if !defined( _WIN32 )
+
+	if( m_Descriptor >= 0 )
+		close( m_Descriptor );
+
+#endif // !_WIN32
+
+	m_Descriptor = -1;
+
+} // Close
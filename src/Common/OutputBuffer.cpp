@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/OutputBuffer.h"
+
+#include <algorithm>
+#include <ostream>
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputBuffer::OutputBuffer( size_t MaxSize )
+	: m_MaxSize( MaxSize )
+{
+} // OutputBuffer
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputBuffer::OutputBuffer( LineCallback Callback )
+	: m_Callback( std::move( Callback ) )
+{
+} // OutputBuffer
+
+//////////////////////////////////////////////////////////////////////////
+
+void OutputBuffer::Append( std::string_view Data )
+{
+	if( m_Callback )
+	{
+		for( size_t End = Data.find( '\n' ); End != std::string_view::npos; End = Data.find( '\n' ) )
+		{
+			std::string_view Line = Data.substr( 0, End );
+
+			// Only lines that arrived in pieces have to be copied
+			if( !m_PartialLine.empty() )
+			{
+				m_PartialLine.append( Line );
+				Line = m_PartialLine;
+			}
+
+			if( Line.ends_with( '\r' ) )
+				Line.remove_suffix( 1 );
+
+			m_Callback( Line );
+			m_PartialLine.clear();
+
+			Data.remove_prefix( End + 1 );
+		}
+
+		m_PartialLine.append( Data );
+
+		return;
+	}
+
+	const size_t Accepted = std::min( Data.size(), m_MaxSize - m_Size );
+
+	m_Truncated |= Accepted < Data.size();
+	m_Size      += Accepted;
+	Data         = Data.substr( 0, Accepted );
+
+	while( !Data.empty() )
+	{
+		if( m_Chunks.empty() || m_Chunks.back().size() == CHUNK_SIZE )
+			m_Chunks.emplace_back().reserve( CHUNK_SIZE );
+
+		std::string& rChunk = m_Chunks.back();
+		const size_t Length = std::min( Data.size(), CHUNK_SIZE - rChunk.size() );
+
+		rChunk.append( Data.substr( 0, Length ) );
+		Data.remove_prefix( Length );
+	}
+
+} // Append
+
+//////////////////////////////////////////////////////////////////////////
+
+void OutputBuffer::Flush( void )
+{
+	// The last line doesn't necessarily end with a line break
+	if( m_Callback && !m_PartialLine.empty() )
+	{
+		m_Callback( m_PartialLine );
+		m_PartialLine.clear();
+	}
+
+} // Flush
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string OutputBuffer::ToString( void ) const
+{
+	std::string String;
+	String.reserve( m_Size );
+
+	for( const std::string& rChunk : m_Chunks )
+		String += rChunk;
+
+	return String;
+
+} // ToString
+
+//////////////////////////////////////////////////////////////////////////
+
+void OutputBuffer::WriteTo( std::ostream& rStream ) const
+{
+	for( const std::string& rChunk : m_Chunks )
+		rStream.write( rChunk.data(), static_cast< std::streamsize >( rChunk.size() ) );
+
+	rStream.flush();
+
+} // WriteTo
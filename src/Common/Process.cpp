@@ -17,26 +17,101 @@
 
 #include "Common/Process.h"
 
+#include "Common/Async/CancellationToken.h"
 #include "Common/Aliases.h"
+#include "Common/OutputBuffer.h"
 #include "Common/Platform/Win32/Win32Error.h"
 #include "Common/Platform/Win32/Win32ProcessInfo.h"
 
 #include <chrono>
 #include <codecvt>
+#include <cstdio>
+#include <cstring>
 #include <locale>
 #include <thread>
+#include <utility>
 
 #include <fcntl.h>
 #include <iostream>
 
 #if defined( _WIN32 )
 #include <corecrt_io.h>
+#include <Psapi.h>
 #define fdopen _fdopen
 #elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <sys/signal.h>
+#include <poll.h>
 #include <signal.h>
+#include <spawn.h>
 #include <unistd.h>
+
+extern char** environ;
+#endif // __linux__ || __APPLE__
+
+//////////////////////////////////////////////////////////////////////////
+
+#if defined( _WIN32 )
+
+static int64_t Microseconds( const FILETIME& rTime )
+{
+	// FILETIME counts in 100 nanosecond intervals
+	return static_cast< int64_t >( ( static_cast< uint64_t >( rTime.dwHighDateTime ) << 32 ) | rTime.dwLowDateTime ) / 10;
+
+} // Microseconds
+
+//////////////////////////////////////////////////////////////////////////
+
+static void QueryUsage( HANDLE Handle, Process::ResourceUsage& rUsage )
+{
+	FILETIME                CreationTime, ExitTime, KernelTime, UserTime;
+	PROCESS_MEMORY_COUNTERS MemoryCounters = { };
+	IO_COUNTERS             IOCounters     = { };
+
+	if( GetProcessTimes( Handle, &CreationTime, &ExitTime, &KernelTime, &UserTime ) )
+	{
+		rUsage.UserTime   = Microseconds( UserTime );
+		rUsage.SystemTime = Microseconds( KernelTime );
+	}
+
+	if( K32GetProcessMemoryInfo( Handle, &MemoryCounters, sizeof( MemoryCounters ) ) )
+		rUsage.PeakMemory = MemoryCounters.PeakWorkingSetSize;
+
+	if( GetProcessIoCounters( Handle, &IOCounters ) )
+	{
+		rUsage.BlockInputs  = IOCounters.ReadOperationCount;
+		rUsage.BlockOutputs = IOCounters.WriteOperationCount;
+	}
+
+} // QueryUsage
+
+#elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+
+static pid_t Reap( pid_t Pid, int& rStatus, int Options, Process::ResourceUsage& rUsage )
+{
+	rusage Usage  = { };
+	pid_t  Result = wait4( Pid, &rStatus, Options, &Usage );
+
+	if( Result > 0 )
+	{
+		rUsage.UserTime            = static_cast< int64_t >( Usage.ru_utime.tv_sec ) * 1000000 + Usage.ru_utime.tv_usec;
+		rUsage.SystemTime          = static_cast< int64_t >( Usage.ru_stime.tv_sec ) * 1000000 + Usage.ru_stime.tv_usec;
+#if defined( __APPLE__ )
+		rUsage.PeakMemory          = static_cast< uint64_t >( Usage.ru_maxrss );
+#else // __APPLE__
+		rUsage.PeakMemory          = static_cast< uint64_t >( Usage.ru_maxrss ) * 1024;
+#endif // !__APPLE__
+		rUsage.BlockInputs         = static_cast< uint64_t >( Usage.ru_inblock );
+		rUsage.BlockOutputs        = static_cast< uint64_t >( Usage.ru_oublock );
+		rUsage.VoluntarySwitches   = static_cast< uint64_t >( Usage.ru_nvcsw );
+		rUsage.InvoluntarySwitches = static_cast< uint64_t >( Usage.ru_nivcsw );
+	}
+
+	return Result;
+
+} // Reap
+
 #endif // __linux__ || __APPLE__
 
 //////////////////////////////////////////////////////////////////////////
@@ -53,12 +128,27 @@ Process::Process( const std::wstring_view& rCommandLine )
 
 //////////////////////////////////////////////////////////////////////////
 
+Process::Process( Arguments Argv, Arguments Environment )
+	: m_Arguments  ( std::move( Argv ) )
+	, m_Environment( std::move( Environment ) )
+{
+} // Process
+
+//////////////////////////////////////////////////////////////////////////
+
 Process::Process( const Process& rOther )
 {
 	m_CommandLine = rOther.m_CommandLine;
+	m_Arguments   = rOther.m_Arguments;
+	m_Environment = rOther.m_Environment;
+	m_Usage       = rOther.m_Usage;
 	m_ExitCode    = rOther.m_ExitCode;
 	m_Pid         = rOther.m_Pid;
 
+#if defined( _WIN32 )
+	m_Job         = rOther.m_Job;
+#endif // _WIN32
+
 } // Process
 
 //////////////////////////////////////////////////////////////////////////
@@ -66,11 +156,15 @@ Process::Process( const Process& rOther )
 Process::Process( Process&& rrOther ) noexcept
 {
 	m_CommandLine = std::move( rrOther.m_CommandLine );
+	m_Arguments   = std::move( rrOther.m_Arguments );
+	m_Environment = std::move( rrOther.m_Environment );
+	m_Usage       = rrOther.m_Usage;
 
 	m_ExitCode    = std::exchange( rrOther.m_ExitCode, 0 );
 
 #if defined( _WIN32 )
 	m_Pid         = std::exchange( rrOther.m_Pid, nullptr );
+	m_Job         = std::exchange( rrOther.m_Job, nullptr );
 #elif defined( __linux__ ) || defined( __APPLE__ ) // WIN32
 	m_Pid         = std::exchange( rrOther.m_Pid, 0 );
 #endif // __linux__ || __APPLE__
@@ -81,6 +175,11 @@ Process::Process( Process&& rrOther ) noexcept
 
 void Process::Start( FILE* pOutputStream )
 {
+	if( !m_Arguments.empty() )
+	{
+		SpawnArguments( pOutputStream );
+		return;
+	}
 
 #if defined( _WIN32 )
 
@@ -122,7 +221,111 @@ void Process::Start( FILE* pOutputStream )
 
 //////////////////////////////////////////////////////////////////////////
 
-int Process::Wait( void )
+void Process::SpawnArguments( FILE* pOutputStream )
+{
+
+#if defined( _WIN32 )
+
+	std::wstring CommandLine = UTF8Converter().from_bytes( JoinArguments( m_Arguments ) );
+	std::wstring Environment;
+
+	// The environment block is a sequence of null-terminated strings, terminated by an additional null
+	for( const std::string& rVariable : m_Environment )
+	{
+		Environment += UTF8Converter().from_bytes( rVariable );
+		Environment += L'\0';
+	}
+	Environment += L'\0';
+
+	STARTUPINFOW StartupInfo ={ };
+	StartupInfo.cb           = sizeof( STARTUPINFO );
+	StartupInfo.wShowWindow  = SW_HIDE;
+	StartupInfo.dwFlags      = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
+	StartupInfo.hStdOutput   = reinterpret_cast< HANDLE >( _get_osfhandle( fileno( pOutputStream ) ) );
+	StartupInfo.hStdError    = reinterpret_cast< HANDLE >( _get_osfhandle( fileno( pOutputStream ) ) );
+
+	// Compilers start more processes of their own. Those go into the same job, so that killing the job ends all of them.
+	// The process starts suspended, so that it can't start anything before it's in the job.
+	HANDLE Job = CreateJobObjectW( nullptr, nullptr );
+
+	PROCESS_INFORMATION ProcessInfo;
+	if( !WIN32_CALL( CreateProcessW( nullptr, CommandLine.data(), nullptr, nullptr, TRUE, CREATE_UNICODE_ENVIRONMENT | CREATE_SUSPENDED, m_Environment.empty() ? nullptr : Environment.data(), nullptr, &StartupInfo, &ProcessInfo ) ) )
+	{
+		if( Job )
+			CloseHandle( Job );
+
+		m_ExitCode = -1;
+		return;
+	}
+
+	if( Job && !AssignProcessToJobObject( Job, ProcessInfo.hProcess ) )
+	{
+		CloseHandle( Job );
+		Job = nullptr;
+	}
+
+	ResumeThread( ProcessInfo.hThread );
+	CloseHandle( ProcessInfo.hThread );
+
+	m_Pid = ProcessInfo.hProcess;
+	m_Job = Job;
+
+#elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+
+	std::vector< char* > Argv;
+	std::vector< char* > Envp;
+
+	Argv.reserve( m_Arguments.size() + 1 );
+	for( std::string& rArgument : m_Arguments )
+		Argv.push_back( rArgument.data() );
+	Argv.push_back( nullptr );
+
+	if( !m_Environment.empty() )
+	{
+		Envp.reserve( m_Environment.size() + 1 );
+		for( std::string& rVariable : m_Environment )
+			Envp.push_back( rVariable.data() );
+		Envp.push_back( nullptr );
+	}
+
+	// Only the output needs to be redirected, so there is no reason to copy the whole IDE through fork() and then run a shell
+	posix_spawn_file_actions_t FileActions;
+	posix_spawn_file_actions_init( &FileActions );
+	posix_spawn_file_actions_adddup2( &FileActions, fileno( pOutputStream ), STDOUT_FILENO );
+	posix_spawn_file_actions_adddup2( &FileActions, fileno( pOutputStream ), STDERR_FILENO );
+
+	// Compilers start more processes of their own, like cc1plus, as and ld. A process group of its own lets Kill() reach all of them.
+	posix_spawnattr_t Attributes;
+	posix_spawnattr_init( &Attributes );
+	posix_spawnattr_setflags( &Attributes, POSIX_SPAWN_SETPGROUP );
+	posix_spawnattr_setpgroup( &Attributes, 0 );
+
+	ProcessID PID    = 0;
+	int       Result = posix_spawnp( &PID, Argv[ 0 ], &FileActions, &Attributes, Argv.data(), Envp.empty() ? environ : Envp.data() );
+
+	posix_spawnattr_destroy( &Attributes );
+	posix_spawn_file_actions_destroy( &FileActions );
+
+	if( Result != 0 )
+	{
+		std::cerr << "Failed to start '" << m_Arguments[ 0 ] << "': " << strerror( Result ) << "\n";
+
+		// Same exit code as a shell would give for a command that could not be found
+		m_ExitCode = 127;
+		return;
+	}
+
+	m_Pid = PID;
+
+#endif // __linux__ || __APPLE__
+
+	m_Running = true;
+
+} // SpawnArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+int Process::Wait( const CancellationToken* pCancellationToken )
 {
 
 #if defined( _WIN32 )
@@ -131,11 +334,21 @@ int Process::Wait( void )
 	DWORD ExitCode;
 
 	while( WIN32_CALL( Result = GetExitCodeProcess( m_Pid, &ExitCode ) ) && ExitCode == STILL_ACTIVE )
+	{
+		if( pCancellationToken && pCancellationToken->IsCancelled() )
+			Kill();
+
 		Sleep( 1 );
+	}
 
+	QueryUsage( m_Pid, m_Usage );
 	CloseHandle( m_Pid );
 
+	if( m_Job )
+		CloseHandle( m_Job );
+
 	m_Pid = nullptr;
+	m_Job = nullptr;
 	m_ExitCode = ExitCode;
 	m_Running = false;
 
@@ -143,7 +356,33 @@ int Process::Wait( void )
 
 #elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
 
-	waitpid( m_Pid, &m_ExitCode, 0 );
+	// Never started. waitpid( 0 ) would wait for any child in the process group
+	if( m_Pid == 0 )
+		return m_ExitCode;
+
+	if( pCancellationToken )
+	{
+		// Poll so that the process can be killed by the same thread that reaps it. That way the pid can't have been reused by the time it's killed.
+		while( Reap( m_Pid, m_ExitCode, WNOHANG, m_Usage ) == 0 )
+		{
+			if( pCancellationToken->IsCancelled() )
+			{
+				Kill();
+				Reap( m_Pid, m_ExitCode, 0, m_Usage );
+				break;
+			}
+
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+	}
+	else
+	{
+		Reap( m_Pid, m_ExitCode, 0, m_Usage );
+	}
+
+	// The pid may be reused as soon as it has been reaped, so it must not be killed later
+	m_Pid = 0;
+	m_Running = false;
 
 	return m_ExitCode;
 
@@ -153,19 +392,131 @@ int Process::Wait( void )
 
 //////////////////////////////////////////////////////////////////////////
 
+bool Process::HasExited( void )
+{
+
+#if defined( _WIN32 )
+
+	if( m_Pid == nullptr )
+		return true;
+
+	if( WaitForSingleObject( m_Pid, 0 ) != WAIT_OBJECT_0 )
+		return false;
+
+	DWORD ExitCode = static_cast< DWORD >( -1 );
+	GetExitCodeProcess( m_Pid, &ExitCode );
+	QueryUsage( m_Pid, m_Usage );
+	CloseHandle( m_Pid );
+
+	if( m_Job )
+		CloseHandle( m_Job );
+
+	m_Pid      = nullptr;
+	m_Job      = nullptr;
+	m_ExitCode = static_cast< int >( ExitCode );
+
+#elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+
+	if( m_Pid == 0 )
+		return true;
+
+	if( Reap( m_Pid, m_ExitCode, WNOHANG, m_Usage ) == 0 )
+		return false;
+
+	m_Pid = 0;
+
+#endif // __linux__ || __APPLE__
+
+	m_Running = false;
+
+	return true;
+
+} // HasExited
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t Process::CurrentMemory( void ) const
+{
+
+#if defined( _WIN32 )
+
+	PROCESS_MEMORY_COUNTERS MemoryCounters = { };
+
+	if( m_Pid != nullptr && K32GetProcessMemoryInfo( m_Pid, &MemoryCounters, sizeof( MemoryCounters ) ) )
+		return MemoryCounters.WorkingSetSize;
+
+#elif defined( __linux__ ) // _WIN32
+
+	if( m_Pid == 0 )
+		return 0;
+
+	// The second field is the number of resident pages
+	char Path[ 32 ];
+	snprintf( Path, sizeof( Path ), "/proc/%d/statm", static_cast< int >( m_Pid ) );
+
+	if( FILE* pFile = fopen( Path, "r" ) )
+	{
+		unsigned long long Size     = 0;
+		unsigned long long Resident = 0;
+		const int          NumRead  = fscanf( pFile, "%llu %llu", &Size, &Resident );
+
+		fclose( pFile );
+
+		if( NumRead == 2 )
+			return Resident * static_cast< uint64_t >( sysconf( _SC_PAGESIZE ) );
+	}
+
+#endif // __linux__
+
+	return 0;
+
+} // CurrentMemory
+
+//////////////////////////////////////////////////////////////////////////
+
+void Process::Kill( void )
+{
+	// Ends the process along with everything that it started. The process still has to be waited for afterwards.
+
+#if defined( _WIN32 )
+
+	if( m_Job )
+		TerminateJobObject( m_Job, EXIT_FAILURE );
+	else if( m_Pid )
+		TerminateProcess( m_Pid, EXIT_FAILURE );
+
+#elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+
+	if( m_Pid == 0 )
+		return;
+
+	// Processes that were started from a command line share the process group of Geno, so only they themselves are killed
+	if( kill( -m_Pid, SIGKILL ) != 0 )
+		kill( m_Pid, SIGKILL );
+
+#endif // __linux__ || __APPLE__
+
+} // Kill
+
+//////////////////////////////////////////////////////////////////////////
+
 void Process::ForceKill( void )
 {
 
 #if defined( _WIN32 )
 
-	TerminateProcess( m_Pid, 0 );
+	Kill();
+
+	if( m_Job )
+		CloseHandle( m_Job );
 
 	m_Pid = nullptr;
+	m_Job = nullptr;
 
 #elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
 
 	// Now we could use SIGTERM if we want to be nice. But we'll use SIGKILL
-	m_ExitCode = kill( m_Pid, SIGKILL );
+	Kill();
 
 	m_Pid = 0;
 
@@ -184,18 +535,19 @@ void Process::TryKill( void )
 
 //////////////////////////////////////////////////////////////////////////
 
-int Process::ResultOf( void )
+int Process::ResultOf( const CancellationToken* pCancellationToken )
 {
 	Start( stdout );
 
-	return Wait();
+	return Wait( pCancellationToken );
 
 } // ResultOf
 
 //////////////////////////////////////////////////////////////////////////
 
-std::wstring Process::OutputOf( int& rResult )
+int Process::Capture( OutputBuffer& rOutput, const CancellationToken* pCancellationToken )
 {
+	char Buffer[ 16 * 1024 ];
 
 #if defined( _WIN32 )
 
@@ -206,55 +558,97 @@ std::wstring Process::OutputOf( int& rResult )
 	SecurityAttributes.bInheritHandle       = TRUE;
 	SecurityAttributes.lpSecurityDescriptor = nullptr;
 
-	if( CreatePipe( &Read, &Write, &SecurityAttributes, 0 ) )
-	{
-		std::wstring Output;
-		std::string  AnsiBuffer;
-		FILE*        pProcOutputHandle = fdopen( _open_osfhandle( reinterpret_cast< intptr_t >( Write ), _O_APPEND ), "w" );
-		Start( pProcOutputHandle );
-		rResult                        = Wait();
-
-		DWORD BytesAvailable;
-		if( PeekNamedPipe( Read, nullptr, 0, nullptr, &BytesAvailable, nullptr ) && BytesAvailable )
-		{
-			AnsiBuffer.resize( BytesAvailable );
-			Output    .resize( BytesAvailable );
+	if( !CreatePipe( &Read, &Write, &SecurityAttributes, 0 ) )
+		return -1;
 
-			ReadFile( Read, AnsiBuffer.data(), BytesAvailable, nullptr, nullptr );
-			MultiByteToWideChar( CP_ACP, 0, AnsiBuffer.c_str(), BytesAvailable, Output.data(), BytesAvailable );
-		}
+	// Only the child should get the write end
+	SetHandleInformation( Read, HANDLE_FLAG_INHERIT, 0 );
 
-		fclose( pProcOutputHandle );
-		CloseHandle( Read );
+	FILE* pProcOutputHandle = fdopen( _open_osfhandle( reinterpret_cast< intptr_t >( Write ), _O_APPEND ), "w" );
+	Start( pProcOutputHandle );
+	fclose( pProcOutputHandle );
 
-		return Output;
-	}
+	// Read until the child closes its end of the pipe, so that it never blocks on a full pipe
+	DWORD BytesRead;
+	while( ReadFile( Read, Buffer, static_cast< DWORD >( std::size( Buffer ) ), &BytesRead, nullptr ) && BytesRead > 0 )
+		rOutput.Append( std::string_view( Buffer, BytesRead ) );
 
-	return std::wstring();
+	CloseHandle( Read );
 
 #elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
 
 	int FileDescriptors[ 2 ];
-	pipe( FileDescriptors );
-	fcntl( FileDescriptors[ 0 ], F_SETFL, O_NONBLOCK ); // Don't want to block on read
+	if( pipe( FileDescriptors ) != 0 )
+		return -1;
 
-	FILE*     pStream = fdopen( FileDescriptors[ 1 ], "w" );
-	Start( pStream );
-	rResult           = Wait();
+	fcntl( FileDescriptors[ 0 ], F_SETFD, FD_CLOEXEC );
 
-	char        Buffer[ 1024 ];
-	ssize_t     Length;
-	std::string Output;
+	FILE* pStream = fdopen( FileDescriptors[ 1 ], "w" );
+	Start( pStream );
+	fclose( pStream );
 
-	while( ( Length = read( FileDescriptors[ 0 ], Buffer, std::size( Buffer ) ) ) > 0 )
+	// Read while the process runs, so that it never blocks on a full pipe
+	for( ;; )
 	{
-		Output.append( Buffer, Length );
+		pollfd  Descriptor = { FileDescriptors[ 0 ], POLLIN, 0 };
+		ssize_t Length     = -1;
+
+		if( poll( &Descriptor, 1, 10 ) > 0 )
+		{
+			if( ( Length = read( FileDescriptors[ 0 ], Buffer, std::size( Buffer ) ) ) > 0 )
+			{
+				rOutput.Append( std::string_view( Buffer, Length ) );
+				continue;
+			}
+		}
+
+		// End of file
+		if( Length == 0 )
+			break;
+
+		if( pCancellationToken && pCancellationToken->IsCancelled() )
+			Kill();
+
+		// Processes that the child left behind may keep the pipe open. Take what's left and stop.
+		if( HasExited() )
+		{
+			fcntl( FileDescriptors[ 0 ], F_SETFL, O_NONBLOCK );
+
+			while( ( Length = read( FileDescriptors[ 0 ], Buffer, std::size( Buffer ) ) ) > 0 )
+				rOutput.Append( std::string_view( Buffer, Length ) );
+
+			break;
+		}
 	}
 
-	fclose( pStream );
 	close( FileDescriptors[ 0 ] );
 
-	return UTF8Converter().from_bytes( Output );
+#endif // __linux__ || __APPLE__
+
+	rOutput.Flush();
+
+	return Wait( pCancellationToken );
+
+} // Capture
+
+//////////////////////////////////////////////////////////////////////////
+
+std::wstring Process::OutputOf( int& rResult )
+{
+	OutputBuffer      Output;
+	rResult                = Capture( Output );
+	const std::string Text = Output.ToString();
+
+#if defined( _WIN32 )
+
+	std::wstring WideText( MultiByteToWideChar( CP_ACP, 0, Text.data(), static_cast< int >( Text.size() ), nullptr, 0 ), L'\0' );
+	MultiByteToWideChar( CP_ACP, 0, Text.data(), static_cast< int >( Text.size() ), WideText.data(), static_cast< int >( WideText.size() ) );
+
+	return WideText;
+
+#elif defined( __linux__ ) || defined( __APPLE__ ) // _WIN32
+
+	return UTF8Converter().from_bytes( Text );
 
 #endif // __linux__ || __APPLE__
 
@@ -269,3 +663,51 @@ std::wstring Process::OutputOf( void )
 	return OutputOf( Result );
 
 } // OutputOf
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string Process::JoinArguments( const Arguments& rArguments )
+{
+	std::string CommandLine;
+
+	for( const std::string& rArgument : rArguments )
+	{
+		if( !CommandLine.empty() )
+			CommandLine += ' ';
+
+		if( !rArgument.empty() && rArgument.find_first_of( " \t\"" ) == std::string::npos )
+		{
+			CommandLine += rArgument;
+			continue;
+		}
+
+		// Quote the argument the way CommandLineToArgvW expects it, which is also understood by POSIX shells for the arguments we produce
+		CommandLine += '"';
+
+		size_t Backslashes = 0;
+		for( char Character : rArgument )
+		{
+			if( Character == '\\' )
+			{
+				++Backslashes;
+			}
+			else if( Character == '"' )
+			{
+				CommandLine.append( Backslashes + 1, '\\' );
+				Backslashes = 0;
+			}
+			else
+			{
+				Backslashes = 0;
+			}
+
+			CommandLine += Character;
+		}
+
+		CommandLine.append( Backslashes, '\\' );
+		CommandLine += '"';
+	}
+
+	return CommandLine;
+
+} // JoinArguments
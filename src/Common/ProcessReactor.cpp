@@ -0,0 +1,678 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/ProcessReactor.h"
+
+#include "Common/Async/CancellationToken.h"
+#include "Common/Async/JobSystem.h"
+#include "Common/Jobserver.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#elif defined( __linux__ ) // _WIN32
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#else // __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#endif // !_WIN32 && !__linux__
+
+//////////////////////////////////////////////////////////////////////////
+
+// How often running processes are checked for cancellation
+constexpr int CANCELLATION_POLL_INTERVAL = 10;
+
+// How long to hold back processes that the governor didn't admit, unless another process finishes first
+constexpr std::chrono::milliseconds ADMISSION_RETRY_INTERVAL = std::chrono::milliseconds( 100 );
+
+//////////////////////////////////////////////////////////////////////////
+
+ProcessReactor::ProcessReactor( void )
+{
+	// Children give their job slots back when the reactor shuts down, so the jobserver has to outlive it
+	Jobserver::Instance();
+
+	SetMaxProcesses( std::thread::hardware_concurrency() );
+
+#if defined( _WIN32 )
+
+	m_WakeEvent = CreateEventW( nullptr, FALSE, FALSE, nullptr );
+
+#elif defined( __linux__ ) // _WIN32
+
+	m_Epoll  = epoll_create1( EPOLL_CLOEXEC );
+	m_WakeFd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+
+	epoll_event Event = { };
+	Event.events      = EPOLLIN;
+	Event.data.fd     = m_WakeFd;
+	epoll_ctl( m_Epoll, EPOLL_CTL_ADD, m_WakeFd, &Event );
+
+#else // __linux__
+
+	if( pipe( m_WakePipe ) == 0 )
+	{
+		for( int Descriptor : m_WakePipe )
+		{
+			fcntl( Descriptor, F_SETFD, FD_CLOEXEC );
+			fcntl( Descriptor, F_SETFL, O_NONBLOCK );
+		}
+	}
+
+#endif // !_WIN32 && !__linux__
+
+	m_Thread = std::thread( &ProcessReactor::ThreadEntry, this );
+
+} // ProcessReactor
+
+//////////////////////////////////////////////////////////////////////////
+
+ProcessReactor::~ProcessReactor( void )
+{
+	m_Stopping = true;
+	Wake();
+
+	m_Thread.join();
+
+	// Children that are still running are killed when their process is destroyed
+	for( ChildPtr& rChild : m_Running )
+		Finish( *rChild );
+
+	for( ChildPtr& rChild : m_Pending )
+		rChild->Promise.set_value( std::move( rChild->Outcome ) );
+
+	JobSystem::Instance().FutureFulfilled();
+
+#if defined( _WIN32 )
+
+	CloseHandle( m_WakeEvent );
+
+#elif defined( __linux__ ) // _WIN32
+
+	close( m_WakeFd );
+	close( m_Epoll );
+
+#else // __linux__
+
+	close( m_WakePipe[ 0 ] );
+	close( m_WakePipe[ 1 ] );
+
+#endif // !_WIN32 && !__linux__
+
+} // ~ProcessReactor
+
+//////////////////////////////////////////////////////////////////////////
+
+std::shared_future< ProcessReactor::Result > ProcessReactor::Launch( Process::Arguments Arguments, const CancellationToken* pCancellationToken, uint64_t ExpectedMemory, OutputBuffer::LineCallback OnLine )
+{
+	ChildPtr                     NewChild = std::make_unique< Child >();
+	std::shared_future< Result > Future   = NewChild->Promise.get_future().share();
+
+	NewChild->Instance           = Process( std::move( Arguments ) );
+	NewChild->pCancellationToken = pCancellationToken;
+	NewChild->ExpectedMemory     = ExpectedMemory;
+	NewChild->Lines              = OnLine ? OutputBuffer( std::move( OnLine ) ) : OutputBuffer( 0 );
+	NewChild->Outcome.StartTime  = std::chrono::steady_clock::now();
+
+	// There's no reason to start anything for a build that was already stopped
+	if( pCancellationToken && pCancellationToken->IsCancelled() )
+	{
+		NewChild->Promise.set_value( std::move( NewChild->Outcome ) );
+		return Future;
+	}
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+		m_Pending.push_back( std::move( NewChild ) );
+		m_NumPending = m_Pending.size();
+	}
+
+	Wake();
+
+	return Future;
+
+} // Launch
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::SetMaxProcesses( size_t MaxProcesses )
+{
+
+#if defined( _WIN32 )
+	// One of the handles that the reactor waits for is used to wake it up
+	MaxProcesses = std::min< size_t >( MaxProcesses, MAXIMUM_WAIT_OBJECTS - 1 );
+#endif // _WIN32
+
+	m_MaxProcesses = std::max< size_t >( MaxProcesses, 1 );
+
+	Wake();
+
+} // SetMaxProcesses
+
+//////////////////////////////////////////////////////////////////////////
+
+ProcessReactor::Status ProcessReactor::CurrentStatus( void ) const
+{
+	Status Current;
+	Current.NumRunning = m_NumRunning.load( std::memory_order_relaxed );
+	Current.NumPending = m_NumPending.load( std::memory_order_relaxed );
+	Current.Constraint = m_Constraint.load( std::memory_order_relaxed );
+	Current.Limit      = Current.Constraint == ResourceGovernor::Constraint::None ? MaxProcesses() : std::max< size_t >( Current.NumRunning, 1 );
+
+	return Current;
+
+} // CurrentStatus
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::ThreadEntry( void )
+{
+	while( !m_Stopping )
+	{
+		Admit();
+
+		bool CheckCancellation = false;
+
+		for( ChildPtr& rChild : m_Running )
+		{
+			if( !rChild->pCancellationToken || rChild->Killed )
+				continue;
+
+			if( rChild->pCancellationToken->IsCancelled() )
+			{
+				// The process hasn't been reaped yet, so its pid can't have been reused. Kill() takes the processes that the compiler started along.
+				rChild->Instance.Kill();
+
+				rChild->Killed = true;
+			}
+			else
+			{
+				CheckCancellation = true;
+			}
+		}
+
+		WaitForEvents( CheckCancellation || m_Throttled );
+
+		const size_t NumFinished = std::erase_if( m_Running, [ this ]( ChildPtr& rChild )
+			{
+				if( rChild->Instance.IsRunning() )
+					return false;
+
+				Finish( *rChild );
+
+				return true;
+			} );
+
+		// Finished processes free up resources, so held back ones get another chance right away
+		if( NumFinished > 0 )
+			m_Throttled = false;
+
+		m_NumRunning = m_Running.size();
+	}
+
+} // ThreadEntry
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::Admit( void )
+{
+	if( m_Throttled && std::chrono::steady_clock::now() < m_RetryTime )
+		return;
+
+	m_Throttled = false;
+
+	// Start waiting processes until the limit is reached, or until the system can't take any more
+	while( m_Running.size() < MaxProcesses() )
+	{
+		ChildPtr NewChild;
+		uint64_t ExpectedMemory;
+
+		// Only this thread removes processes from the queue, so the first one stays the same after the lock is released
+		{
+			std::scoped_lock Lock( m_Mutex );
+
+			if( m_Pending.empty() )
+				break;
+
+			ExpectedMemory = m_Pending.front()->ExpectedMemory;
+		}
+
+		if( !m_Governor.Admit( ExpectedMemory, m_Running.size(), RunningMemory() ) )
+		{
+			m_Throttled  = true;
+			m_Constraint = m_Governor.CurrentConstraint();
+			m_RetryTime  = std::chrono::steady_clock::now() + ADMISSION_RETRY_INTERVAL;
+			break;
+		}
+
+		// One process at a time runs in the slot of this process. Every other one needs a slot from the jobserver.
+		const bool HasOwnSlot = !m_OwnSlotInUse;
+		const bool HasJobSlot = !HasOwnSlot && Jobserver::Instance().IsActive();
+
+		if( HasJobSlot && !Jobserver::Instance().TryAcquire() )
+		{
+			m_Throttled  = true;
+			m_Constraint = ResourceGovernor::Constraint::Jobserver;
+			m_RetryTime  = std::chrono::steady_clock::now() + ADMISSION_RETRY_INTERVAL;
+			break;
+		}
+
+		{
+			std::scoped_lock Lock( m_Mutex );
+
+			NewChild = std::move( m_Pending.front() );
+			m_Pending.pop_front();
+		}
+
+		NewChild->ExpectedMemory = m_Governor.Estimate( NewChild->ExpectedMemory );
+		NewChild->HasOwnSlot     = HasOwnSlot;
+		NewChild->HasJobSlot     = HasJobSlot;
+
+		if( HasOwnSlot )
+			m_OwnSlotInUse = true;
+
+		Spawn( std::move( NewChild ) );
+	}
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+		m_NumPending = m_Pending.size();
+	}
+
+	m_NumRunning = m_Running.size();
+
+	if( !m_Throttled )
+		m_Constraint = ResourceGovernor::Constraint::None;
+
+} // Admit
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::Spawn( ChildPtr NewChild )
+{
+	Child& rChild = *NewChild;
+
+	rChild.Outcome.StartTime = std::chrono::steady_clock::now();
+
+#if defined( _WIN32 )
+
+	HANDLE              Read;
+	HANDLE              Write;
+	SECURITY_ATTRIBUTES SecurityAttributes = { };
+	SecurityAttributes.nLength             = sizeof( SECURITY_ATTRIBUTES );
+	SecurityAttributes.bInheritHandle      = TRUE;
+
+	// A larger pipe lets the process keep writing between two polls
+	if( !CreatePipe( &Read, &Write, &SecurityAttributes, 64 * 1024 ) )
+	{
+		ReleaseSlot( rChild );
+
+		rChild.Promise.set_value( std::move( rChild.Outcome ) );
+		JobSystem::Instance().FutureFulfilled();
+		return;
+	}
+
+	// Only the child should get the write end
+	SetHandleInformation( Read, HANDLE_FLAG_INHERIT, 0 );
+
+	FILE* pStream = _fdopen( _open_osfhandle( reinterpret_cast< intptr_t >( Write ), _O_APPEND ), "w" );
+	rChild.Instance.Start( pStream );
+	fclose( pStream );
+
+	rChild.OutputPipe = Read;
+
+#else // _WIN32
+
+	int Pipe[ 2 ];
+
+#if defined( __linux__ )
+	const bool HasPipe = pipe2( Pipe, O_CLOEXEC ) == 0;
+#else // __linux__
+	const bool HasPipe = pipe( Pipe ) == 0;
+	if( HasPipe )
+	{
+		fcntl( Pipe[ 0 ], F_SETFD, FD_CLOEXEC );
+		fcntl( Pipe[ 1 ], F_SETFD, FD_CLOEXEC );
+	}
+#endif // !__linux__
+
+	if( !HasPipe )
+	{
+		ReleaseSlot( rChild );
+
+		rChild.Promise.set_value( std::move( rChild.Outcome ) );
+		JobSystem::Instance().FutureFulfilled();
+		return;
+	}
+
+	// The child gets its own copies of the write end, which are the only ones left after this
+	FILE* pStream = fdopen( Pipe[ 1 ], "w" );
+	rChild.Instance.Start( pStream );
+	fclose( pStream );
+
+	fcntl( Pipe[ 0 ], F_SETFL, O_NONBLOCK );
+
+	rChild.OutputDescriptor                = Pipe[ 0 ];
+	m_Descriptors[ rChild.OutputDescriptor ] = &rChild;
+
+#endif // !_WIN32
+
+	if( !rChild.Instance )
+	{
+		Finish( rChild );
+		return;
+	}
+
+#if defined( __linux__ )
+
+	epoll_event Event = { };
+	Event.events      = EPOLLIN;
+	Event.data.fd     = rChild.OutputDescriptor;
+	epoll_ctl( m_Epoll, EPOLL_CTL_ADD, rChild.OutputDescriptor, &Event );
+
+	// A pidfd becomes readable when the process exits. Older kernels don't have them, in which case the process is polled instead.
+	rChild.PidDescriptor = static_cast< int >( syscall( SYS_pidfd_open, rChild.Instance.Pid(), 0 ) );
+
+	if( rChild.PidDescriptor >= 0 )
+	{
+		Event.data.fd = rChild.PidDescriptor;
+		epoll_ctl( m_Epoll, EPOLL_CTL_ADD, rChild.PidDescriptor, &Event );
+
+		m_Descriptors[ rChild.PidDescriptor ] = &rChild;
+	}
+
+#endif // __linux__
+
+	m_Running.push_back( std::move( NewChild ) );
+
+} // Spawn
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::WaitForEvents( bool Poll )
+{
+
+#if defined( _WIN32 )
+
+	std::vector< HANDLE > Handles;
+	Handles.reserve( m_Running.size() + 1 );
+	Handles.push_back( m_WakeEvent );
+
+	for( ChildPtr& rChild : m_Running )
+		Handles.push_back( rChild->Instance.Pid() );
+
+	// Pipes can't be waited for together with processes, so they are polled while anything runs
+	WaitForMultipleObjects( static_cast< DWORD >( Handles.size() ), Handles.data(), FALSE, ( Poll || !m_Running.empty() ) ? CANCELLATION_POLL_INTERVAL : INFINITE );
+
+	// Several processes may have exited at once
+	for( ChildPtr& rChild : m_Running )
+	{
+		ReadOutput( *rChild );
+		rChild->Instance.HasExited();
+	}
+
+#elif defined( __linux__ ) // _WIN32
+
+	const bool  PollExits = std::any_of( m_Running.begin(), m_Running.end(), []( const ChildPtr& rChild ) { return rChild->PidDescriptor < 0; } );
+	epoll_event Events[ 64 ];
+	const int   NumEvents = epoll_wait( m_Epoll, Events, static_cast< int >( std::size( Events ) ), ( Poll || PollExits ) ? CANCELLATION_POLL_INTERVAL : -1 );
+
+	for( int i = 0; i < NumEvents; ++i )
+	{
+		const int Descriptor = Events[ i ].data.fd;
+
+		if( Descriptor == m_WakeFd )
+		{
+			uint64_t Value;
+			while( read( m_WakeFd, &Value, sizeof( Value ) ) > 0 );
+			continue;
+		}
+
+		// The descriptor may have been closed by an earlier event in this batch
+		auto It = m_Descriptors.find( Descriptor );
+		if( It == m_Descriptors.end() )
+			continue;
+
+		Child& rChild = *It->second;
+
+		if( Descriptor == rChild.OutputDescriptor )
+			ReadOutput( rChild );
+		else if( Descriptor == rChild.PidDescriptor )
+			rChild.Instance.HasExited();
+	}
+
+	if( PollExits )
+	{
+		for( ChildPtr& rChild : m_Running )
+		{
+			if( rChild->PidDescriptor < 0 )
+				rChild->Instance.HasExited();
+		}
+	}
+
+#else // __linux__
+
+	// Without a way to wait for exits, the processes are polled while their output is read
+	std::vector< pollfd > Descriptors;
+	Descriptors.reserve( m_Running.size() + 1 );
+	Descriptors.push_back( { m_WakePipe[ 0 ], POLLIN, 0 } );
+
+	for( ChildPtr& rChild : m_Running )
+	{
+		if( rChild->OutputDescriptor >= 0 )
+			Descriptors.push_back( { rChild->OutputDescriptor, POLLIN, 0 } );
+	}
+
+	const int Timeout = m_Running.empty() && !Poll ? -1 : CANCELLATION_POLL_INTERVAL;
+
+	if( poll( Descriptors.data(), Descriptors.size(), Timeout ) > 0 )
+	{
+		char Buffer[ 64 ];
+		while( read( m_WakePipe[ 0 ], Buffer, sizeof( Buffer ) ) > 0 );
+	}
+
+	for( ChildPtr& rChild : m_Running )
+	{
+		ReadOutput( *rChild );
+		rChild->Instance.HasExited();
+	}
+
+#endif // !_WIN32 && !__linux__
+
+} // WaitForEvents
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::ReadOutput( Child& rChild )
+{
+	char Buffer[ 16 * 1024 ];
+
+#if defined( _WIN32 )
+
+	if( !rChild.OutputPipe )
+		return;
+
+	// Only read what's there, so that processes that inherited the pipe, like mspdbsrv.exe, can't keep the reactor waiting
+	DWORD Available;
+	DWORD Length;
+
+	while( PeekNamedPipe( rChild.OutputPipe, nullptr, 0, nullptr, &Available, nullptr ) )
+	{
+		if( Available == 0 )
+			return;
+
+		if( !ReadFile( rChild.OutputPipe, Buffer, std::min< DWORD >( Available, static_cast< DWORD >( sizeof( Buffer ) ) ), &Length, nullptr ) )
+			break;
+
+		rChild.Outcome.Output.Append( std::string_view( Buffer, Length ) );
+		rChild.Lines.Append( std::string_view( Buffer, Length ) );
+	}
+
+	// The pipe broke, because everything that had the write end closed it
+	CloseHandle( rChild.OutputPipe );
+	rChild.OutputPipe = nullptr;
+
+#else // _WIN32
+
+	if( rChild.OutputDescriptor < 0 )
+		return;
+
+	ssize_t Length;
+
+	while( ( Length = read( rChild.OutputDescriptor, Buffer, sizeof( Buffer ) ) ) > 0 )
+	{
+		rChild.Outcome.Output.Append( std::string_view( Buffer, static_cast< size_t >( Length ) ) );
+		rChild.Lines.Append( std::string_view( Buffer, static_cast< size_t >( Length ) ) );
+	}
+
+	// End of file. The process, and everything that it started, closed its output.
+	if( Length == 0 )
+	{
+
+#if defined( __linux__ )
+		epoll_ctl( m_Epoll, EPOLL_CTL_DEL, rChild.OutputDescriptor, nullptr );
+#endif // __linux__
+
+		m_Descriptors.erase( rChild.OutputDescriptor );
+		close( rChild.OutputDescriptor );
+
+		rChild.OutputDescriptor = -1;
+	}
+
+#endif // !_WIN32
+
+} // ReadOutput
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::Finish( Child& rChild )
+{
+	// Everything that the process itself wrote is in the pipe by now. Don't wait for any processes that it left behind.
+	ReadOutput( rChild );
+
+#if defined( _WIN32 )
+
+	if( rChild.OutputPipe )
+	{
+		CloseHandle( rChild.OutputPipe );
+		rChild.OutputPipe = nullptr;
+	}
+
+#else // _WIN32
+
+	for( int* pDescriptor : { &rChild.OutputDescriptor, &rChild.PidDescriptor } )
+	{
+		if( *pDescriptor < 0 )
+			continue;
+
+#if defined( __linux__ )
+		epoll_ctl( m_Epoll, EPOLL_CTL_DEL, *pDescriptor, nullptr );
+#endif // __linux__
+
+		m_Descriptors.erase( *pDescriptor );
+		close( *pDescriptor );
+
+		*pDescriptor = -1;
+	}
+
+#endif // !_WIN32
+
+	rChild.Outcome.Output.Flush();
+	rChild.Lines.Flush();
+
+	// Processes that are still running when the reactor shuts down are killed along with it
+	rChild.Outcome.ExitCode = rChild.Instance.IsRunning() ? -1 : rChild.Instance.ExitCode();
+	rChild.Outcome.Usage    = rChild.Instance.Usage();
+
+	m_Governor.Record( rChild.Outcome.Usage.PeakMemory );
+
+	ReleaseSlot( rChild );
+
+	rChild.Promise.set_value( std::move( rChild.Outcome ) );
+
+	// Jobs that continue once the process has exited can run now
+	JobSystem::Instance().FutureFulfilled();
+
+} // Finish
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::ReleaseSlot( Child& rChild )
+{
+	if( rChild.HasOwnSlot )
+		m_OwnSlotInUse = false;
+
+	if( rChild.HasJobSlot )
+		Jobserver::Instance().Release();
+
+	rChild.HasOwnSlot = false;
+	rChild.HasJobSlot = false;
+
+} // ReleaseSlot
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProcessReactor::Wake( void )
+{
+
+#if defined( _WIN32 )
+
+	SetEvent( m_WakeEvent );
+
+#elif defined( __linux__ ) // _WIN32
+
+	const uint64_t Value = 1;
+	write( m_WakeFd, &Value, sizeof( Value ) );
+
+#else // __linux__
+
+	const char Value = 0;
+	write( m_WakePipe[ 1 ], &Value, sizeof( Value ) );
+
+#endif // !_WIN32 && !__linux__
+
+} // Wake
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t ProcessReactor::RunningMemory( void ) const
+{
+	uint64_t Memory = 0;
+
+	// Processes that haven't reached their expected peak yet will take more memory from the system
+	for( const ChildPtr& rChild : m_Running )
+	{
+		const uint64_t CurrentMemory = rChild->Instance.CurrentMemory();
+
+		if( CurrentMemory < rChild->ExpectedMemory )
+			Memory += rChild->ExpectedMemory - CurrentMemory;
+	}
+
+	return Memory;
+
+} // RunningMemory
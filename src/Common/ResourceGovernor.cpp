@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/ResourceGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#endif // _WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+bool ResourceGovernor::Admit( uint64_t ExpectedMemory, size_t NumRunning, uint64_t RunningMemory )
+{
+	m_Constraint = Constraint::None;
+
+	// Something always has to run, or the build would never finish
+	if( NumRunning == 0 )
+		return true;
+
+	Sample( NumRunning );
+
+	// Give up the cores that something else on the system keeps busy
+	const double NumCores = std::max( std::thread::hardware_concurrency(), 1u );
+
+	if( m_OtherLoad >= 1.0 && static_cast< double >( NumRunning ) >= std::max( NumCores - m_OtherLoad, 1.0 ) )
+	{
+		m_Constraint = Constraint::Load;
+		return false;
+	}
+
+	// The system couldn't tell how much memory it has
+	if( m_TotalMemory == 0 )
+		return true;
+
+	// Keep some memory for the rest of the system, including the IDE itself
+	const uint64_t Reserve = std::max( m_TotalMemory / 20, MIN_RESERVE );
+	const uint64_t Needed  = Reserve + RunningMemory + Estimate( ExpectedMemory );
+
+	if( m_AvailableMemory < Needed )
+	{
+		m_Constraint = Constraint::Memory;
+		return false;
+	}
+
+	return true;
+
+} // Admit
+
+//////////////////////////////////////////////////////////////////////////
+
+void ResourceGovernor::Record( uint64_t PeakMemory )
+{
+	if( PeakMemory == 0 )
+		return;
+
+	m_RecordedMemory += PeakMemory;
+	m_NumRecorded    += 1;
+
+} // Record
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t ResourceGovernor::Estimate( uint64_t ExpectedMemory ) const
+{
+	if( ExpectedMemory > 0 )
+		return ExpectedMemory;
+
+	// Processes that never ran before are assumed to be like the ones that did
+	if( m_NumRecorded > 0 )
+		return m_RecordedMemory / m_NumRecorded;
+
+	return DEFAULT_ESTIMATE;
+
+} // Estimate
+
+//////////////////////////////////////////////////////////////////////////
+
+void ResourceGovernor::Sample( size_t NumRunning )
+{
+	const auto Now     = std::chrono::steady_clock::now();
+	const auto Elapsed = Now - m_LastSample;
+
+	if( Elapsed < SAMPLE_INTERVAL )
+		return;
+
+	m_LastSample = Now;
+
+#if defined( _WIN32 )
+
+	MEMORYSTATUSEX Status = { };
+	Status.dwLength       = sizeof( Status );
+
+	if( GlobalMemoryStatusEx( &Status ) )
+	{
+		m_TotalMemory     = Status.ullTotalPhys;
+		m_AvailableMemory = Status.ullAvailPhys;
+	}
+
+#elif defined( __linux__ ) // _WIN32
+
+	// MemAvailable accounts for the caches that the kernel can drop, unlike MemFree
+	if( FILE* pFile = fopen( "/proc/meminfo", "r" ) )
+	{
+		char Line[ 128 ];
+
+		while( fgets( Line, sizeof( Line ), pFile ) )
+		{
+			unsigned long long Value;
+
+			if( sscanf( Line, "MemTotal: %llu kB", &Value ) == 1 )
+				m_TotalMemory = Value * 1024;
+			else if( sscanf( Line, "MemAvailable: %llu kB", &Value ) == 1 )
+				m_AvailableMemory = Value * 1024;
+		}
+
+		fclose( pFile );
+	}
+
+#endif // __linux__
+
+#if defined( __linux__ )
+
+	// The fourth field counts the threads that are runnable right now. Unlike the load average, it no longer includes compilers that already exited.
+	// The running processes of this build and the thread that reads the file are part of it.
+	if( FILE* pFile = fopen( "/proc/loadavg", "r" ) )
+	{
+		unsigned int NumRunnable;
+
+		if( fscanf( pFile, "%*f %*f %*f %u/", &NumRunnable ) == 1 )
+			m_OtherLoad = std::max( static_cast< double >( NumRunnable ) - static_cast< double >( NumRunning ) - 1.0, 0.0 );
+
+		fclose( pFile );
+	}
+
+#elif defined( __APPLE__ ) // __linux__
+
+	// The load average still counts the processes of this build long after they exited, so subtract what this build added over the same period.
+	// The kernel decays the one minute average exponentially, which the share of this build follows.
+	const double Decay = std::exp( -std::chrono::duration< double >( Elapsed ).count() / 60.0 );
+
+	m_BuildLoad = m_BuildLoad * Decay + static_cast< double >( NumRunning ) * ( 1.0 - Decay );
+
+	double Load;
+	if( getloadavg( &Load, 1 ) == 1 )
+		m_OtherLoad = std::max( Load - m_BuildLoad, 0.0 );
+
+#endif // __APPLE__
+
+} // Sample
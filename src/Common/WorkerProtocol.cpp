@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Common/WorkerProtocol.h"
+
+#include "Common/LocalSocket.h"
+
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////
+
+struct MessageHeader
+{
+	uint32_t                    Magic   = WorkerProtocol::MAGIC;
+	uint32_t                    Version = WorkerProtocol::VERSION;
+	WorkerProtocol::MessageType Type    = WorkerProtocol::MessageType::Status;
+	uint32_t                    Padding = 0;
+	uint64_t                    Size    = 0;
+
+}; // MessageHeader
+
+//////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+static void WriteValue( std::string& rBuffer, const T& rValue )
+{
+	rBuffer.append( reinterpret_cast< const char* >( &rValue ), sizeof( T ) );
+
+} // WriteValue
+
+//////////////////////////////////////////////////////////////////////////
+
+static void WriteString( std::string& rBuffer, std::string_view String )
+{
+	WriteValue( rBuffer, static_cast< uint64_t >( String.size() ) );
+	rBuffer.append( String );
+
+} // WriteString
+
+//////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+static bool ReadValue( std::string_view& rBuffer, T& rValue )
+{
+	if( rBuffer.size() < sizeof( T ) )
+		return false;
+
+	memcpy( &rValue, rBuffer.data(), sizeof( T ) );
+	rBuffer.remove_prefix( sizeof( T ) );
+
+	return true;
+
+} // ReadValue
+
+//////////////////////////////////////////////////////////////////////////
+
+static bool ReadString( std::string_view& rBuffer, std::string& rString )
+{
+	uint64_t Size;
+	if( !ReadValue( rBuffer, Size ) || rBuffer.size() < Size )
+		return false;
+
+	rString.assign( rBuffer.data(), static_cast< size_t >( Size ) );
+	rBuffer.remove_prefix( static_cast< size_t >( Size ) );
+
+	return true;
+
+} // ReadString
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Send( LocalSocket& rSocket, MessageType Type, std::string_view Payload )
+{
+	MessageHeader Header;
+	Header.Type = Type;
+	Header.Size = Payload.size();
+
+	return rSocket.Send( &Header, sizeof( Header ) ) && rSocket.Send( Payload.data(), Payload.size() );
+
+} // Send
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< WorkerProtocol::MessageType > WorkerProtocol::Receive( LocalSocket& rSocket, std::string& rPayload )
+{
+	MessageHeader Header;
+	if( !rSocket.Receive( &Header, sizeof( Header ) ) )
+		return std::nullopt;
+
+	// Don't trust the size of a message from a peer that doesn't speak this version of the protocol
+	if( Header.Magic != MAGIC || Header.Version != VERSION || Header.Size > MAX_PAYLOAD_SIZE )
+		return std::nullopt;
+
+	rPayload.resize( static_cast< size_t >( Header.Size ) );
+
+	if( !rSocket.Receive( rPayload.data(), rPayload.size() ) )
+		return std::nullopt;
+
+	return Header.Type;
+
+} // Receive
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string WorkerProtocol::Encode( const StatusReply& rMessage )
+{
+	std::string Payload;
+	WriteValue( Payload, rMessage.Slots );
+	WriteValue( Payload, rMessage.Running );
+
+	return Payload;
+
+} // Encode
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string WorkerProtocol::Encode( const CompileRequest& rMessage )
+{
+	std::string Payload;
+	Payload.reserve( rMessage.Source.size() + 4096 );
+
+	WriteValue( Payload, static_cast< uint32_t >( rMessage.Arguments.size() ) );
+
+	for( const std::string& rArgument : rMessage.Arguments )
+		WriteString( Payload, rArgument );
+
+	WriteString( Payload, rMessage.SourceName );
+	WriteString( Payload, rMessage.Source );
+
+	return Payload;
+
+} // Encode
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string WorkerProtocol::Encode( const CompileReply& rMessage )
+{
+	std::string Payload;
+	Payload.reserve( rMessage.Object.size() + rMessage.Output.size() + 128 );
+
+	WriteValue(  Payload, rMessage.ExitCode );
+	WriteString( Payload, rMessage.Output );
+	WriteString( Payload, rMessage.Object );
+	WriteValue(  Payload, rMessage.Usage );
+
+	return Payload;
+
+} // Encode
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string WorkerProtocol::Encode( const BuildRequest& rMessage )
+{
+	std::string Payload;
+	WriteString( Payload, rMessage.Workspace );
+	WriteValue(  Payload, static_cast< uint32_t >( rMessage.Selections.size() ) );
+
+	for( const std::string& rSelection : rMessage.Selections )
+		WriteString( Payload, rSelection );
+
+	WriteString( Payload, rMessage.Project );
+
+	return Payload;
+
+} // Encode
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string WorkerProtocol::Encode( const BuildReply& rMessage )
+{
+	std::string Payload;
+	WriteValue( Payload, rMessage.ExitCode );
+
+	return Payload;
+
+} // Encode
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Decode( std::string_view Payload, StatusReply& rMessage )
+{
+	return ReadValue( Payload, rMessage.Slots )
+	    && ReadValue( Payload, rMessage.Running );
+
+} // Decode
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Decode( std::string_view Payload, CompileRequest& rMessage )
+{
+	uint32_t NumArguments;
+	if( !ReadValue( Payload, NumArguments ) )
+		return false;
+
+	// Every argument takes at least the size of its length
+	if( NumArguments > Payload.size() / sizeof( uint64_t ) )
+		return false;
+
+	rMessage.Arguments.resize( NumArguments );
+
+	for( std::string& rArgument : rMessage.Arguments )
+	{
+		if( !ReadString( Payload, rArgument ) )
+			return false;
+	}
+
+	return ReadString( Payload, rMessage.SourceName )
+	    && ReadString( Payload, rMessage.Source );
+
+} // Decode
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Decode( std::string_view Payload, CompileReply& rMessage )
+{
+	return ReadValue(  Payload, rMessage.ExitCode )
+	    && ReadString( Payload, rMessage.Output )
+	    && ReadString( Payload, rMessage.Object )
+	    && ReadValue(  Payload, rMessage.Usage );
+
+} // Decode
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Decode( std::string_view Payload, BuildRequest& rMessage )
+{
+	uint32_t NumSelections;
+	if( !ReadString( Payload, rMessage.Workspace ) || !ReadValue( Payload, NumSelections ) )
+		return false;
+
+	if( NumSelections > Payload.size() / sizeof( uint64_t ) )
+		return false;
+
+	rMessage.Selections.resize( NumSelections );
+
+	for( std::string& rSelection : rMessage.Selections )
+	{
+		if( !ReadString( Payload, rSelection ) )
+			return false;
+	}
+
+	return ReadString( Payload, rMessage.Project );
+
+} // Decode
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerProtocol::Decode( std::string_view Payload, BuildReply& rMessage )
+{
+	return ReadValue( Payload, rMessage.ExitCode );
+
+} // Decode
@@ -17,13 +17,86 @@
 
 #include "Application.h"
 
+#include "Build/Diagnostics.h"
 #include "Discord/DiscordRPC.h"
 #include "GUI/Modals/IModal.h"
 #include "GUI/MainWindow.h"
 
 #include <Common/Async/JobSystem.h>
-
+#include <Common/Jobserver.h>
+#include <Common/LocalSocket.h>
+#include <Common/ProcessReactor.h>
+#include <Common/WorkerProtocol.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <future>
 #include <iostream>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::atomic< bool > Interrupted = false;
+
+//////////////////////////////////////////////////////////////////////////
+
+static void OnInterrupt( int Signal )
+{
+	// A second Ctrl+C ends Geno right away
+	signal( Signal, SIG_DFL );
+
+	Interrupted = true;
+
+} // OnInterrupt
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::optional< int > BuildThroughDaemon( const std::filesystem::path& rSocketPath, const std::filesystem::path& rWorkspacePath, const std::vector< std::pair< std::string, std::string > >& rSelections, const std::string& rProjectName )
+{
+	LocalSocket Connection = LocalSocket::Connect( rSocketPath );
+	if( !Connection.IsValid() )
+		return std::nullopt;
+
+	std::error_code              Error;
+	WorkerProtocol::BuildRequest Request;
+	Request.Workspace = std::filesystem::absolute( rWorkspacePath, Error ).lexically_normal().string();
+	Request.Project   = rProjectName;
+
+	for( const auto&[ rColumn, rConfiguration ] : rSelections )
+		Request.Selections.push_back( rColumn + "=" + rConfiguration );
+
+	if( !WorkerProtocol::Send( Connection, WorkerProtocol::MessageType::Build, WorkerProtocol::Encode( Request ) ) )
+		return std::nullopt;
+
+	std::string Payload;
+
+	while( std::optional< WorkerProtocol::MessageType > Type = WorkerProtocol::Receive( Connection, Payload ) )
+	{
+		if( *Type == WorkerProtocol::MessageType::BuildOutput )
+		{
+			std::cout << Payload << std::flush;
+		}
+		else if( WorkerProtocol::BuildReply Reply; *Type == WorkerProtocol::MessageType::BuildReply && WorkerProtocol::Decode( Payload, Reply ) )
+		{
+			return Reply.ExitCode;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// Part of the build may already have been printed, so it's too late to build without the daemon
+	std::cerr << "Lost the connection to geno-buildd on " << rSocketPath << "\n";
+
+	return 2;
+
+} // BuildThroughDaemon
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -38,8 +111,13 @@ Application::~Application( void )
 
 int Application::Run( int NumArgs, char** ppArgs )
 {
+	// Builds from the command line never create a window, so that they run on machines without a display
+	if( NumArgs >= 2 && std::string_view( ppArgs[ 1 ] ) == "--build" )
+		return RunBuild( NumArgs, ppArgs );
+
 	HandleCommandLineArgs( NumArgs, ppArgs );
 
+	Jobserver::Instance().Start( std::thread::hardware_concurrency() );
 	JobSystem::Instance().StartThreads( std::thread::hardware_concurrency() );
 	DiscordRPC::Instance().InitDiscord();
 	auto& rWindow = MainWindow::Instance();
@@ -162,3 +240,158 @@ void Application::HandleCommandLineArgs( int NumArgs, char** ppArgs )
 	}
 
 } // HandleCommandLineArgs
+
+//////////////////////////////////////////////////////////////////////////
+
+int Application::RunBuild( int NumArgs, char** ppArgs )
+{
+
+#if defined( _WIN32 )
+
+	// Geno is a windowed application, which doesn't get the console of the shell that started it
+	if( AttachConsole( ATTACH_PARENT_PROCESS ) )
+	{
+		freopen( "CONOUT$", "w", stdout );
+		freopen( "CONOUT$", "w", stderr );
+	}
+
+#endif // _WIN32
+
+	std::filesystem::path                                WorkspacePath;
+	std::filesystem::path                                DaemonSocketPath;
+	std::string                                          ProjectName;
+	std::vector< std::pair< std::string, std::string > > Selections;
+	int                                                  NumJobs = static_cast< int >( std::thread::hardware_concurrency() );
+
+	for( int i = 1; i < NumArgs; ++i )
+	{
+		const std::string_view Argument = ppArgs[ i ];
+		const bool             HasValue = ( i + 1 ) < NumArgs;
+
+		if( Argument == "--build" && HasValue )
+		{
+			WorkspacePath = ppArgs[ ++i ];
+		}
+		else if( Argument == "--config" && HasValue )
+		{
+			const std::string_view Selection = ppArgs[ ++i ];
+			const size_t           Equals    = Selection.find( '=' );
+
+			if( Equals == std::string_view::npos )
+			{
+				std::cerr << "Expected Column=Value after --config, got '" << Selection << "'\n";
+				return 2;
+			}
+
+			Selections.emplace_back( Selection.substr( 0, Equals ), Selection.substr( Equals + 1 ) );
+		}
+		else if( Argument == "--project" && HasValue )
+		{
+			ProjectName = ppArgs[ ++i ];
+		}
+		else if( Argument == "--daemon" && HasValue )
+		{
+			DaemonSocketPath = ppArgs[ ++i ];
+		}
+		else if( Argument == "-j" && HasValue )
+		{
+			NumJobs = atoi( ppArgs[ ++i ] );
+		}
+		else if( Argument.starts_with( "-j" ) )
+		{
+			NumJobs = atoi( ppArgs[ i ] + 2 );
+		}
+		else
+		{
+			std::cerr << "Usage: " << ppArgs[ 0 ] << " --build <workspace" << Workspace::EXTENSION << "> [--config Column=Value]... [--project Name] [-j N] [--daemon <socket>]\n";
+			return 2;
+		}
+	}
+
+	// geno-buildd keeps the workspace loaded between builds and runs the build with its own jobs
+	if( !DaemonSocketPath.empty() )
+	{
+		if( std::optional< int > ExitCode = BuildThroughDaemon( DaemonSocketPath, WorkspacePath, Selections, ProjectName ) )
+			return *ExitCode;
+
+		std::cerr << "geno-buildd isn't listening on " << DaemonSocketPath << ". Building without it.\n";
+	}
+
+	if( !LoadWorkspace( WorkspacePath ) )
+	{
+		std::cerr << "Failed to load workspace " << WorkspacePath << "\n";
+		return 2;
+	}
+
+	Workspace& rWorkspace = *m_CurrentWorkspace;
+	int        ExitCode   = 0;
+
+	for( const auto&[ rColumn, rConfiguration ] : Selections )
+	{
+		if( !rWorkspace.m_BuildMatrix.Select( rColumn, rConfiguration ) )
+		{
+			std::cerr << "Workspace has no configuration '" << rConfiguration << "' in column '" << rColumn << "'\n";
+			ExitCode = 2;
+		}
+	}
+
+	if( ExitCode == 0 && rWorkspace.m_Projects.empty() )
+	{
+		std::cerr << "Workspace " << WorkspacePath << " has no projects to build\n";
+		ExitCode = 2;
+	}
+	else if( ExitCode == 0 && !ProjectName.empty() && !rWorkspace.ProjectByName( ProjectName ) )
+	{
+		std::cerr << "Workspace " << WorkspacePath << " has no project named '" << ProjectName << "'\n";
+		ExitCode = 2;
+	}
+
+	if( ExitCode == 0 )
+	{
+		const size_t         Jobs = static_cast< size_t >( std::max( NumJobs, 1 ) );
+		std::promise< bool > Finished;
+
+		Jobserver::Instance().Start( Jobs );
+		JobSystem::Instance().StartThreads( Jobs );
+		ProcessReactor::Instance().SetMaxProcesses( Jobs );
+
+		rWorkspace.Events.BuildFinished += [ &Finished ]( Workspace& /*rWorkspace*/, std::filesystem::path /*OutputFile*/, bool Success )
+		{
+			Finished.set_value( Success );
+		};
+
+		// Compilers run in process groups of their own, so the Ctrl+C of the terminal never reaches them. Stopping the build kills them instead.
+		signal( SIGINT,  OnInterrupt );
+		signal( SIGTERM, OnInterrupt );
+
+		if( ProjectName.empty() ) rWorkspace.Build();
+		else                      rWorkspace.BuildProject( ProjectName );
+
+		std::future< bool > Result = Finished.get_future();
+
+		while( Result.wait_for( std::chrono::milliseconds( 10 ) ) != std::future_status::ready )
+		{
+			if( Interrupted.exchange( false ) )
+				rWorkspace.CancelBuild();
+		}
+
+		const bool Success = Result.get();
+
+		// The job that reported the result still uses the workspace until it returns
+		while( rWorkspace.IsBuilding() )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+		const DiagnosticStore& rDiagnostics = DiagnosticStore::Instance();
+
+		if( rDiagnostics.NumErrors() > 0 || rDiagnostics.NumWarnings() > 0 )
+			std::cout << "Errors: " << rDiagnostics.NumErrors() << ", warnings: " << rDiagnostics.NumWarnings() << "\n";
+
+		ExitCode = Success ? 0 : 1;
+	}
+
+	// Configurations that were selected from the command line shouldn't end up in the workspace file, so it's closed without saving
+	m_CurrentWorkspace.reset();
+
+	return ExitCode;
+
+} // RunBuild
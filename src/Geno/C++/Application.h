@@ -51,6 +51,7 @@ public:
 private:
 
 	void HandleCommandLineArgs( int NumArgs, char** ppArgs );
+	int  RunBuild             ( int NumArgs, char** ppArgs );
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "BinaryIO.h"
+
+#include <fstream>
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BinaryIO::ReadFile( const std::filesystem::path& rPath, std::string& rBuffer )
+{
+	std::ifstream Stream( rPath, std::ios::binary | std::ios::ate );
+	if( !Stream.is_open() )
+		return false;
+
+	rBuffer.resize( static_cast< size_t >( Stream.tellg() ) );
+	Stream.seekg( 0 );
+	Stream.read( rBuffer.data(), rBuffer.size() );
+
+	return static_cast< bool >( Stream );
+
+} // ReadFile
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BinaryIO::WriteFile( const std::filesystem::path& rPath, std::string_view Buffer )
+{
+	// Write to a temporary file first so that an interrupted build never leaves a truncated file behind
+	std::filesystem::path TemporaryPath = rPath;
+	TemporaryPath += ".tmp";
+
+	std::error_code Error;
+	std::filesystem::create_directories( rPath.parent_path(), Error );
+
+	{
+		std::ofstream Stream( TemporaryPath, std::ios::binary | std::ios::trunc );
+		if( !Stream.is_open() )
+			return false;
+
+		Stream.write( Buffer.data(), Buffer.size() );
+	}
+
+	std::filesystem::rename( TemporaryPath, rPath, Error );
+
+	return !Error;
+
+} // WriteFile
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BinaryIO::WriteFileIfChanged( const std::filesystem::path& rPath, std::string_view Buffer )
+{
+	// Leave the timestamp of generated sources alone unless their contents actually change
+	std::string Previous;
+	if( ReadFile( rPath, Previous ) && Previous == Buffer )
+		return true;
+
+	return WriteFile( rPath, Buffer );
+
+} // WriteFileIfChanged
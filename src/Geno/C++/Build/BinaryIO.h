@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace BinaryIO
+{
+	template< typename T >
+	inline void WriteValue( std::string& rBuffer, const T& rValue )
+	{
+		rBuffer.append( reinterpret_cast< const char* >( &rValue ), sizeof( T ) );
+
+	} // WriteValue
+
+//////////////////////////////////////////////////////////////////////////
+
+	inline void WriteString( std::string& rBuffer, std::string_view String )
+	{
+		WriteValue( rBuffer, static_cast< uint32_t >( String.size() ) );
+		rBuffer.append( String );
+
+	} // WriteString
+
+//////////////////////////////////////////////////////////////////////////
+
+	template< typename T >
+	inline bool ReadValue( std::string_view& rBuffer, T& rValue )
+	{
+		if( rBuffer.size() < sizeof( T ) )
+			return false;
+
+		memcpy( &rValue, rBuffer.data(), sizeof( T ) );
+		rBuffer.remove_prefix( sizeof( T ) );
+
+		return true;
+
+	} // ReadValue
+
+//////////////////////////////////////////////////////////////////////////
+
+	inline bool ReadString( std::string_view& rBuffer, std::string_view& rString )
+	{
+		uint32_t Size;
+		if( !ReadValue( rBuffer, Size ) || rBuffer.size() < Size )
+			return false;
+
+		rString = rBuffer.substr( 0, Size );
+		rBuffer.remove_prefix( Size );
+
+		return true;
+
+	} // ReadString
+
+//////////////////////////////////////////////////////////////////////////
+
+	inline bool ReadString( std::string_view& rBuffer, std::string& rString )
+	{
+		std::string_view View;
+		if( !ReadString( rBuffer, View ) )
+			return false;
+
+		rString.assign( View );
+
+		return true;
+
+	} // ReadString
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool ReadFile          ( const std::filesystem::path& rPath, std::string& rBuffer );
+	bool WriteFile         ( const std::filesystem::path& rPath, std::string_view Buffer );
+	bool WriteFileIfChanged( const std::filesystem::path& rPath, std::string_view Buffer );
+
+} // ::BinaryIO
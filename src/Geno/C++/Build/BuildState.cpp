@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "BuildState.h"
+
+#include "Build/BinaryIO.h"
+
+#include <Common/Hash.h>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t BUILD_STATE_MAGIC   = 0x31534247; // "GBS1"
+constexpr uint32_t BUILD_STATE_VERSION = 4;
+
+using namespace BinaryIO;
+
+//////////////////////////////////////////////////////////////////////////
+
+BuildState::BuildState( std::filesystem::path Path )
+	: m_Path( std::move( Path ) )
+{
+} // BuildState
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildState::Load( void )
+{
+	std::string FileBuffer;
+	if( !ReadFile( m_Path, FileBuffer ) )
+		return false;
+
+	std::string_view Buffer = FileBuffer;
+	uint32_t         Magic;
+	uint32_t         Version;
+	uint32_t         NumRecords;
+
+	if( !ReadValue( Buffer, Magic ) || Magic != BUILD_STATE_MAGIC || !ReadValue( Buffer, Version ) || Version != BUILD_STATE_VERSION || !ReadValue( Buffer, NumRecords ) )
+	{
+		std::cerr << "Ignoring incompatible build state " << m_Path << "\n";
+		return false;
+	}
+
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Records.clear();
+	m_Records.reserve( NumRecords );
+
+	for( uint32_t i = 0; i < NumRecords; ++i )
+	{
+		std::string Output;
+		Record      Record;
+		uint32_t    NumInputs;
+
+		if( !ReadString( Buffer, Output ) || !ReadString( Buffer, Record.CommandLine ) || !ReadValue( Buffer, Record.OutputTime ) || !ReadValue( Buffer, Record.StartTime ) || !ReadValue( Buffer, Record.Duration ) )
+			return false;
+
+		Process::ResourceUsage& rUsage = Record.Usage;
+
+		if( !ReadValue( Buffer, rUsage.UserTime ) || !ReadValue( Buffer, rUsage.SystemTime ) || !ReadValue( Buffer, rUsage.PeakMemory ) || !ReadValue( Buffer, rUsage.BlockInputs ) || !ReadValue( Buffer, rUsage.BlockOutputs )
+		 || !ReadValue( Buffer, rUsage.VoluntarySwitches ) || !ReadValue( Buffer, rUsage.InvoluntarySwitches ) || !ReadValue( Buffer, NumInputs ) )
+			return false;
+
+		Record.Inputs.resize( NumInputs );
+
+		for( InputStamp& rStamp : Record.Inputs )
+		{
+			if( !ReadValue( Buffer, rStamp.Hash ) || !ReadValue( Buffer, rStamp.Size ) || !ReadValue( Buffer, rStamp.Time ) )
+				return false;
+		}
+
+		m_Records.emplace( std::move( Output ), std::move( Record ) );
+	}
+
+	m_Modified = false;
+	m_FileTime = FileTime( m_Path );
+
+	// Without the header dependencies we can't tell whether an object is up-to-date
+	if( !m_Dependencies.Load( DependenciesPath() ) )
+	{
+		m_Records.clear();
+		return false;
+	}
+
+	return true;
+
+} // Load
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildState::Save( void )
+{
+	std::string Buffer;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		if( !m_Modified && !m_Dependencies.IsModified() )
+			return true;
+
+		WriteValue( Buffer, BUILD_STATE_MAGIC );
+		WriteValue( Buffer, BUILD_STATE_VERSION );
+		WriteValue( Buffer, static_cast< uint32_t >( m_Records.size() ) );
+
+		for( const auto& [ rOutput, rRecord ] : m_Records )
+		{
+			WriteString( Buffer, rOutput );
+			WriteString( Buffer, rRecord.CommandLine );
+			WriteValue( Buffer, rRecord.OutputTime );
+			WriteValue( Buffer, rRecord.StartTime );
+			WriteValue( Buffer, rRecord.Duration );
+			WriteValue( Buffer, rRecord.Usage.UserTime );
+			WriteValue( Buffer, rRecord.Usage.SystemTime );
+			WriteValue( Buffer, rRecord.Usage.PeakMemory );
+			WriteValue( Buffer, rRecord.Usage.BlockInputs );
+			WriteValue( Buffer, rRecord.Usage.BlockOutputs );
+			WriteValue( Buffer, rRecord.Usage.VoluntarySwitches );
+			WriteValue( Buffer, rRecord.Usage.InvoluntarySwitches );
+			WriteValue( Buffer, static_cast< uint32_t >( rRecord.Inputs.size() ) );
+
+			for( const InputStamp& rStamp : rRecord.Inputs )
+			{
+				WriteValue( Buffer, rStamp.Hash );
+				WriteValue( Buffer, rStamp.Size );
+				WriteValue( Buffer, rStamp.Time );
+			}
+		}
+
+		m_Modified = false;
+	}
+
+	// The records are only valid together with the header dependencies, so those must be written first
+	if( !m_Dependencies.Save( DependenciesPath() ) || !WriteFile( m_Path, Buffer ) )
+		return false;
+
+	m_FileTime = FileTime( m_Path );
+
+	return true;
+
+} // Save
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildState::IsStale( void ) const
+{
+	// Another build of the same project wrote its own records since these were loaded or saved
+	return FileTime( m_Path ) != m_FileTime;
+
+} // IsStale
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::string > BuildState::Check( const std::filesystem::path& rOutput, std::span< const std::filesystem::path > Inputs, const std::string& rCommandLine, std::vector< InputStamp >& rStamps )
+{
+	const std::string       Key = rOutput.generic_string();
+	std::optional< Record > Previous;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		if( auto It = m_Records.find( Key ); It != m_Records.end() )
+			Previous = It->second;
+	}
+
+	std::optional< std::string > MissingInput;
+	std::optional< std::string > ChangedInput;
+	bool                         Touched = false;
+
+	rStamps.clear();
+	rStamps.reserve( Inputs.size() );
+
+	for( size_t i = 0; i < Inputs.size(); ++i )
+	{
+		const std::filesystem::path& rInput    = Inputs[ i ];
+		const InputStamp*            pPrevious = ( Previous && i < Previous->Inputs.size() ) ? &Previous->Inputs[ i ] : nullptr;
+		InputStamp&                  rStamp    = rStamps.emplace_back();
+		std::error_code              Error;
+
+		rStamp.Size = std::filesystem::file_size( rInput, Error );
+		rStamp.Time = FileTime( rInput );
+
+		if( Error )
+		{
+			if( !MissingInput )
+				MissingInput = "'" + rInput.string() + "' is missing";
+
+			continue;
+		}
+
+		// Only read the file if it was touched since the last build
+		if( pPrevious && pPrevious->Size == rStamp.Size && pPrevious->Time == rStamp.Time )
+		{
+			rStamp.Hash = pPrevious->Hash;
+			continue;
+		}
+
+		rStamp.Hash = HashFile( rInput ).value_or( 0 );
+
+		if( pPrevious && pPrevious->Hash != rStamp.Hash )
+		{
+			if( !ChangedInput )
+				ChangedInput = "'" + rInput.string() + "' has changed";
+		}
+		else
+		{
+			Touched = true;
+		}
+	}
+
+	if( !Previous )                                      return "no previous build record";
+	if( MissingInput )                                   return MissingInput;
+
+	const int64_t OutputTime = FileTime( rOutput );
+
+	if( OutputTime == 0 )                                return "output is missing";
+	if( OutputTime != Previous->OutputTime )             return "output was modified outside of the build";
+	if( rCommandLine != Previous->CommandLine )          return "command line has changed";
+	if( Inputs.size() != Previous->Inputs.size() )       return "list of inputs has changed";
+	if( ChangedInput )                                   return ChangedInput;
+
+	// Headers are not hashed. Like make, consider them dirty if they were written after the last compile began.
+	if( auto Reason = m_Dependencies.FindNewerDependency( rOutput, Previous->StartTime ) ) return Reason;
+
+	// The content is identical even though some timestamps are not. Remember the new timestamps so that we don't need to hash the inputs again.
+	if( Touched )
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		if( auto It = m_Records.find( Key ); It != m_Records.end() )
+		{
+			It->second.Inputs = rStamps;
+			m_Modified        = true;
+		}
+	}
+
+	return std::nullopt;
+
+} // Check
+
+//////////////////////////////////////////////////////////////////////////
+
+void BuildState::Update( const std::filesystem::path& rOutput, std::vector< InputStamp > Stamps, std::string CommandLine, int64_t StartTime, const Process::ResourceUsage& rUsage )
+{
+	Record Record;
+	Record.CommandLine = std::move( CommandLine );
+	Record.Inputs      = std::move( Stamps );
+	Record.OutputTime  = FileTime( rOutput );
+	Record.StartTime   = StartTime;
+	Record.Duration    = std::chrono::duration_cast< std::chrono::milliseconds >( std::filesystem::file_time_type::duration( Now() - StartTime ) ).count();
+	Record.Usage       = rUsage;
+
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Records.insert_or_assign( rOutput.generic_string(), std::move( Record ) );
+	m_Modified = true;
+
+} // Update
+
+//////////////////////////////////////////////////////////////////////////
+
+void BuildState::Forget( const std::filesystem::path& rOutput )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	if( m_Records.erase( rOutput.generic_string() ) > 0 )
+		m_Modified = true;
+
+} // Forget
+
+//////////////////////////////////////////////////////////////////////////
+
+int64_t BuildState::LastDuration( const std::filesystem::path& rOutput )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	if( auto It = m_Records.find( rOutput.generic_string() ); It != m_Records.end() )
+		return It->second.Duration;
+
+	return 0;
+
+} // LastDuration
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t BuildState::LastPeakMemory( const std::filesystem::path& rOutput )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	if( auto It = m_Records.find( rOutput.generic_string() ); It != m_Records.end() )
+		return It->second.Usage.PeakMemory;
+
+	return 0;
+
+} // LastPeakMemory
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< uint64_t > BuildState::HashFile( const std::filesystem::path& rPath )
+{
+	std::ifstream Stream( rPath, std::ios::binary );
+	if( !Stream.is_open() )
+		return std::nullopt;
+
+	std::array< char, 64 * 1024 > Buffer;
+	uint64_t                      Hash = Hash::FNV1A_OFFSET_BASIS;
+
+	while( Stream )
+	{
+		Stream.read( Buffer.data(), Buffer.size() );
+		Hash = Hash::FNV1a( Buffer.data(), static_cast< size_t >( Stream.gcount() ), Hash );
+	}
+
+	return Hash;
+
+} // HashFile
+
+//////////////////////////////////////////////////////////////////////////
+
+int64_t BuildState::FileTime( const std::filesystem::path& rPath )
+{
+	std::error_code                       Error;
+	const std::filesystem::file_time_type Time = std::filesystem::last_write_time( rPath, Error );
+
+	if( Error )
+		return 0;
+
+	return static_cast< int64_t >( Time.time_since_epoch().count() );
+
+} // FileTime
+
+//////////////////////////////////////////////////////////////////////////
+
+int64_t BuildState::Now( void )
+{
+	return static_cast< int64_t >( std::filesystem::file_time_type::clock::now().time_since_epoch().count() );
+
+} // Now
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path BuildState::DependenciesPath( void ) const
+{
+	return std::filesystem::path( m_Path ).replace_extension( DependencyGraph::EXTENSION );
+
+} // DependenciesPath
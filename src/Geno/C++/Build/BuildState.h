@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Build/DependencyGraph.h"
+
+#include <Common/Macros.h>
+#include <Common/Process.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BuildState
+{
+	GENO_DISABLE_COPY_AND_MOVE( BuildState );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	struct InputStamp
+	{
+		uint64_t Hash = 0;
+		uint64_t Size = 0;
+		int64_t  Time = 0;
+
+	}; // InputStamp
+
+	struct Record
+	{
+		std::string               CommandLine;
+		std::vector< InputStamp > Inputs;
+		int64_t                   OutputTime = 0;
+		int64_t                   StartTime  = 0;
+		int64_t                   Duration   = 0;
+		Process::ResourceUsage    Usage;
+
+	}; // Record
+
+//////////////////////////////////////////////////////////////////////////
+
+	static constexpr std::string_view EXTENSION = ".gbs";
+
+//////////////////////////////////////////////////////////////////////////
+
+	explicit BuildState( std::filesystem::path Path );
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool Load   ( void );
+	bool Save   ( void );
+	bool IsStale( void ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::optional< std::string > Check         ( const std::filesystem::path& rOutput, std::span< const std::filesystem::path > Inputs, const std::string& rCommandLine, std::vector< InputStamp >& rStamps );
+	void                         Update        ( const std::filesystem::path& rOutput, std::vector< InputStamp > Stamps, std::string CommandLine, int64_t StartTime, const Process::ResourceUsage& rUsage = { } );
+	void                         Forget        ( const std::filesystem::path& rOutput );
+	int64_t                      LastDuration  ( const std::filesystem::path& rOutput );
+	uint64_t                     LastPeakMemory( const std::filesystem::path& rOutput );
+
+//////////////////////////////////////////////////////////////////////////
+
+	static std::optional< uint64_t > HashFile( const std::filesystem::path& rPath );
+	static int64_t                   FileTime( const std::filesystem::path& rPath );
+	static int64_t                   Now     ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	const std::filesystem::path& Path        ( void ) const { return m_Path; }
+	DependencyGraph&             Dependencies( void )       { return m_Dependencies; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	std::filesystem::path DependenciesPath( void ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::unordered_map< std::string, Record > m_Records;
+	std::filesystem::path                     m_Path;
+	DependencyGraph                           m_Dependencies;
+	std::mutex                                m_Mutex;
+	int64_t                                   m_FileTime = 0;
+
+	bool                                      m_Modified = false;
+
+}; // BuildState
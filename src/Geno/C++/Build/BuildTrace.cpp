@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "BuildTrace.h"
+
+#include "Build/BinaryIO.h"
+
+#include <Common/Aliases.h>
+#include <Common/Async/JobSystem.h>
+#include <Common/Hash.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <set>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+static int64_t Microseconds( BuildTrace::Clock::duration Duration )
+{
+	return std::chrono::duration_cast< std::chrono::microseconds >( Duration ).count();
+
+} // Microseconds
+
+//////////////////////////////////////////////////////////////////////////
+
+void BuildTrace::Begin( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Events.clear();
+	m_BuildStart = Clock::now();
+
+} // Begin
+
+//////////////////////////////////////////////////////////////////////////
+
+void BuildTrace::Record( std::string_view Category, const std::filesystem::path& rOutput, std::string_view CommandLine, Clock::time_point Start, const Process::ResourceUsage& rUsage )
+{
+	Event Event;
+	Event.Category    = Category;
+	Event.Output      = UTF8Converter().to_bytes( rOutput.generic_wstring() );
+	Event.CommandHash = Hash::FNV1a( CommandLine );
+	Event.Start       = Start;
+	Event.End         = Clock::now();
+	Event.QueueTime   = JobSystem::CurrentJobQueueTime();
+	Event.Lane        = JobSystem::CurrentThreadIndex();
+	Event.Usage       = rUsage;
+
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Events.emplace_back( std::move( Event ) );
+
+} // Record
+
+//////////////////////////////////////////////////////////////////////////
+
+void BuildTrace::PrintSummary( size_t MaxJobs )
+{
+	std::vector< const Event* > Jobs;
+	std::scoped_lock            Lock( m_Mutex );
+
+	for( const Event& rEvent : m_Events )
+	{
+		if( rEvent.Usage.PeakMemory > 0 )
+			Jobs.push_back( &rEvent );
+	}
+
+	if( Jobs.empty() )
+		return;
+
+	// The jobs that need the most memory are the ones that run build machines out of it
+	const size_t NumJobs = std::min( MaxJobs, Jobs.size() );
+	std::partial_sort( Jobs.begin(), Jobs.begin() + NumJobs, Jobs.end(), []( const Event* pA, const Event* pB ) { return pA->Usage.PeakMemory > pB->Usage.PeakMemory; } );
+
+	std::cout << "Peak memory of the " << NumJobs << " largest jobs:\n";
+
+	for( size_t i = 0; i < NumJobs; ++i )
+	{
+		const Process::ResourceUsage& rUsage = Jobs[ i ]->Usage;
+		char                          Line[ 128 ];
+
+		snprintf( Line, sizeof( Line ), "%8" PRIu64 " MiB %8.2f s user %7.2f s sys  ", rUsage.PeakMemory >> 20, rUsage.UserTime / 1e6, rUsage.SystemTime / 1e6 );
+
+		std::cout << Line << std::filesystem::path( Jobs[ i ]->Output ).filename().string() << "\n";
+	}
+
+} // PrintSummary
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildTrace::Write( const std::filesystem::path& rDirectory, std::string_view Name )
+{
+	std::vector< Event > Events;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		Events = std::move( m_Events );
+		m_Events.clear();
+	}
+
+	if( Events.empty() )
+		return true;
+
+	std::sort( Events.begin(), Events.end(), []( const Event& rA, const Event& rB ) { return rA.End < rB.End; } );
+
+	std::filesystem::path TracePath = rDirectory / Name;
+	TracePath += TRACE_EXTENSION;
+
+	const bool Success = WriteChromeTrace( TracePath, Events ) && WriteNinjaLog( rDirectory / NINJA_LOG_NAME, Events );
+
+	if( !Success )
+		std::cerr << "Failed to write the build trace to " << rDirectory << "\n";
+
+	return Success;
+
+} // Write
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildTrace::WriteChromeTrace( const std::filesystem::path& rPath, const std::vector< Event >& rEvents )
+{
+	rapidjson::StringBuffer                      Buffer;
+	rapidjson::Writer< rapidjson::StringBuffer > Writer( Buffer );
+	std::set< size_t >                           Lanes;
+
+	Writer.StartObject();
+	Writer.Key( "displayTimeUnit" );
+	Writer.String( "ms" );
+	Writer.Key( "traceEvents" );
+	Writer.StartArray();
+
+	for( size_t i = 0; i < rEvents.size(); ++i )
+	{
+		const Event&      rEvent = rEvents[ i ];
+		const std::string Name   = std::filesystem::path( rEvent.Output ).filename().string();
+		const int64_t     Start  = Microseconds( rEvent.Start - m_BuildStart );
+		const int64_t     Queued = Start - Microseconds( rEvent.QueueTime );
+
+		Lanes.insert( rEvent.Lane );
+
+		// The job itself, on the lane of the worker thread that ran it
+		Writer.StartObject();
+		Writer.Key( "name" ); Writer.String( Name.c_str() );
+		Writer.Key( "cat" );  Writer.String( rEvent.Category.c_str() );
+		Writer.Key( "ph" );   Writer.String( "X" );
+		Writer.Key( "ts" );   Writer.Int64( Start );
+		Writer.Key( "dur" );  Writer.Int64( Microseconds( rEvent.End - rEvent.Start ) );
+		Writer.Key( "pid" );  Writer.Int( 0 );
+		Writer.Key( "tid" );  Writer.Uint64( rEvent.Lane );
+		Writer.Key( "args" );
+		Writer.StartObject();
+		Writer.Key( "output" );   Writer.String( rEvent.Output.c_str() );
+		Writer.Key( "queue_us" ); Writer.Int64( Microseconds( rEvent.QueueTime ) );
+
+		// Only jobs that ran a process have any resource usage
+		if( rEvent.Usage.PeakMemory > 0 )
+		{
+			Writer.Key( "user_us" );     Writer.Int64( rEvent.Usage.UserTime );
+			Writer.Key( "sys_us" );      Writer.Int64( rEvent.Usage.SystemTime );
+			Writer.Key( "peak_rss_kb" ); Writer.Uint64( rEvent.Usage.PeakMemory >> 10 );
+			Writer.Key( "blk_in" );      Writer.Uint64( rEvent.Usage.BlockInputs );
+			Writer.Key( "blk_out" );     Writer.Uint64( rEvent.Usage.BlockOutputs );
+			Writer.Key( "vcsw" );        Writer.Uint64( rEvent.Usage.VoluntarySwitches );
+			Writer.Key( "ivcsw" );       Writer.Uint64( rEvent.Usage.InvoluntarySwitches );
+		}
+
+		Writer.EndObject();
+		Writer.EndObject();
+
+		// The time it spent waiting in the queue, as an async slice since those overlap
+		for( const auto& [ pPhase, Time ] : { std::pair( "b", Queued ), std::pair( "e", Start ) } )
+		{
+			Writer.StartObject();
+			Writer.Key( "name" ); Writer.String( Name.c_str() );
+			Writer.Key( "cat" );  Writer.String( "queue" );
+			Writer.Key( "ph" );   Writer.String( pPhase );
+			Writer.Key( "id" );   Writer.Uint64( i );
+			Writer.Key( "ts" );   Writer.Int64( Time );
+			Writer.Key( "pid" );  Writer.Int( 0 );
+			Writer.Key( "tid" );  Writer.Uint64( rEvent.Lane );
+			Writer.EndObject();
+		}
+	}
+
+	for( size_t Lane : Lanes )
+	{
+		const std::string LaneName = Lane > 0 ? "Worker " + std::to_string( Lane ) : std::string( "Main" );
+
+		Writer.StartObject();
+		Writer.Key( "name" ); Writer.String( "thread_name" );
+		Writer.Key( "ph" );   Writer.String( "M" );
+		Writer.Key( "pid" );  Writer.Int( 0 );
+		Writer.Key( "tid" );  Writer.Uint64( Lane );
+		Writer.Key( "args" );
+		Writer.StartObject();
+		Writer.Key( "name" ); Writer.String( LaneName.c_str() );
+		Writer.EndObject();
+		Writer.EndObject();
+	}
+
+	Writer.EndArray();
+	Writer.EndObject();
+
+	return BinaryIO::WriteFile( rPath, std::string_view( Buffer.GetString(), Buffer.GetSize() ) );
+
+} // WriteChromeTrace
+
+//////////////////////////////////////////////////////////////////////////
+
+bool BuildTrace::WriteNinjaLog( const std::filesystem::path& rPath, const std::vector< Event >& rEvents )
+{
+	// Same layout as ninja's own log so that tools like ninjatracing can read it. Times are in milliseconds since the start of the build.
+	std::string Buffer = "# ninja log v5\n";
+	char        Line[ 64 ];
+
+	for( const Event& rEvent : rEvents )
+	{
+		const auto Start = std::chrono::duration_cast< std::chrono::milliseconds >( rEvent.Start - m_BuildStart ).count();
+		const auto End   = std::chrono::duration_cast< std::chrono::milliseconds >( rEvent.End   - m_BuildStart ).count();
+
+		snprintf( Line, sizeof( Line ), "%" PRId64 "\t%" PRId64 "\t0\t", static_cast< int64_t >( Start ), static_cast< int64_t >( End ) );
+		Buffer += Line;
+		Buffer += rEvent.Output;
+
+		snprintf( Line, sizeof( Line ), "\t%016" PRIx64 "\n", rEvent.CommandHash );
+		Buffer += Line;
+	}
+
+	return BinaryIO::WriteFile( rPath, Buffer );
+
+} // WriteNinjaLog
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/Macros.h>
+#include <Common/Process.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BuildTrace
+{
+	GENO_SINGLETON( BuildTrace );
+
+	BuildTrace( void ) = default;
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Event
+	{
+		std::string            Category;
+		std::string            Output;
+		uint64_t               CommandHash = 0;
+		Clock::time_point      Start;
+		Clock::time_point      End;
+		Clock::duration        QueueTime   = { };
+		size_t                 Lane        = 0;
+		Process::ResourceUsage Usage;
+
+	}; // Event
+
+//////////////////////////////////////////////////////////////////////////
+
+	static constexpr std::string_view TRACE_EXTENSION = ".trace.json";
+	static constexpr std::string_view NINJA_LOG_NAME  = ".ninja_log";
+
+//////////////////////////////////////////////////////////////////////////
+
+	void Begin       ( void );
+	void Record      ( std::string_view Category, const std::filesystem::path& rOutput, std::string_view CommandLine, Clock::time_point Start, const Process::ResourceUsage& rUsage = { } );
+	void PrintSummary( size_t MaxJobs );
+	bool Write       ( const std::filesystem::path& rDirectory, std::string_view Name );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	bool WriteChromeTrace( const std::filesystem::path& rPath, const std::vector< Event >& rEvents );
+	bool WriteNinjaLog   ( const std::filesystem::path& rPath, const std::vector< Event >& rEvents );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::vector< Event > m_Events;
+	Clock::time_point    m_BuildStart;
+	std::mutex           m_Mutex;
+
+}; // BuildTrace
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "CompilationDatabase.h"
+
+#include "Build/BinaryIO.h"
+#include "Compilers/ICompiler.h"
+#include "Components/Workspace.h"
+
+#include <Common/Aliases.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <rapidjson/document.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ImportedProject
+{
+	std::string                          Name;
+	std::vector< std::filesystem::path > Files;
+	std::vector< std::filesystem::path > IncludeDirs;
+	std::vector< std::string >           Defines;
+	std::unordered_set< std::wstring >   SeenFiles;
+	std::unordered_set< std::wstring >   SeenIncludeDirs;
+	std::unordered_set< std::string >    SeenDefines;
+
+}; // ImportedProject
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string_view StringOf( const rapidjson::Value& rValue )
+{
+	return std::string_view( rValue.GetString(), rValue.GetStringLength() );
+
+} // StringOf
+
+//////////////////////////////////////////////////////////////////////////
+
+static void SplitCommandLine( std::string_view CommandLine, std::vector< std::string >& rArguments )
+{
+#if defined( _WIN32 )
+	// Backslashes are path separators on Windows and only escape quotes
+	auto IsEscape = [ CommandLine ]( size_t Index ) { return CommandLine[ Index ] == '\\' && Index + 1 < CommandLine.size() && CommandLine[ Index + 1 ] == '"'; };
+#else // _WIN32
+	auto IsEscape = [ CommandLine ]( size_t Index ) { return CommandLine[ Index ] == '\\' && Index + 1 < CommandLine.size(); };
+#endif // !_WIN32
+
+	std::string Argument;
+	bool        InArgument = false;
+	char        Quote      = 0;
+
+	rArguments.clear();
+
+	for( size_t i = 0; i < CommandLine.size(); ++i )
+	{
+		const char Char = CommandLine[ i ];
+
+		if( Quote == '\'' )
+		{
+			if( Char == Quote ) Quote     = 0;
+			else                Argument += Char;
+		}
+		else if( Quote == '"' )
+		{
+			if(      IsEscape( i ) ) Argument += CommandLine[ ++i ];
+			else if( Char == Quote ) Quote     = 0;
+			else                     Argument += Char;
+		}
+		else if( IsEscape( i ) )
+		{
+			Argument  += CommandLine[ ++i ];
+			InArgument = true;
+		}
+		else if( Char == '"' || Char == '\'' )
+		{
+			Quote      = Char;
+			InArgument = true;
+		}
+		else if( Char == ' ' || Char == '\t' || Char == '\r' || Char == '\n' )
+		{
+			if( InArgument )
+				rArguments.push_back( std::exchange( Argument, std::string() ) );
+
+			InArgument = false;
+		}
+		else
+		{
+			Argument  += Char;
+			InArgument = true;
+		}
+	}
+
+	if( InArgument )
+		rArguments.push_back( std::move( Argument ) );
+
+} // SplitCommandLine
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string_view CMakeTargetName( std::string_view OutputPath )
+{
+	// CMake places the objects of each target in CMakeFiles/<Target>.dir/
+	constexpr std::string_view Prefix = "CMakeFiles/";
+	constexpr std::string_view Suffix = ".dir/";
+
+	const size_t Begin = OutputPath.find( Prefix );
+	if( Begin == std::string_view::npos )
+		return std::string_view();
+
+	const size_t End = OutputPath.find( Suffix, Begin + Prefix.size() );
+	if( End == std::string_view::npos )
+		return std::string_view();
+
+	return OutputPath.substr( Begin + Prefix.size(), End - Begin - Prefix.size() );
+
+} // CMakeTargetName
+
+//////////////////////////////////////////////////////////////////////////
+
+static bool IsWithin( const std::filesystem::path& rPath, const std::filesystem::path& rDirectory )
+{
+	return std::mismatch( rDirectory.begin(), rDirectory.end(), rPath.begin(), rPath.end() ).first == rDirectory.end();
+
+} // IsWithin
+
+//////////////////////////////////////////////////////////////////////////
+
+bool CompilationDatabase::Export( Workspace& rWorkspace, const std::filesystem::path& rPath )
+{
+	// Stream to a temporary file first so that tools never read a partially written database
+	std::filesystem::path TemporaryPath = rPath;
+	TemporaryPath += ".tmp";
+
+	std::ofstream Stream( TemporaryPath, std::ios::binary | std::ios::trunc );
+	if( !Stream.is_open() )
+	{
+		std::cerr << "Failed to open " << TemporaryPath << " for writing\n";
+		return false;
+	}
+
+	const Configuration                                  WorkspaceConfiguration = rWorkspace.m_BuildMatrix.CurrentConfiguration();
+	UTF8Converter                                        UTF8;
+	rapidjson::OStreamWrapper                            StreamWrapper( Stream );
+	rapidjson::PrettyWriter< rapidjson::OStreamWrapper > Writer( StreamWrapper );
+	size_t                                               NumEntries = 0;
+
+	Writer.StartArray();
+
+	for( Project& rProject : rWorkspace.m_Projects )
+	{
+		// Resolve the configuration the same way that a build does
+		Configuration Combined = rProject.m_LocalConfiguration;
+		Combined.Override( WorkspaceConfiguration );
+
+		if( !Combined.m_OutputDir )
+			Combined.m_OutputDir = rProject.m_Location;
+
+		const ResolvedConfiguration::Ptr Config = ResolvedConfiguration::Make( std::move( Combined ) );
+
+		if( !Config->m_Compiler )
+		{
+			std::cerr << "Skipping project '" << rProject.m_Name << "'. No compiler active!\n";
+			continue;
+		}
+
+		const std::string Directory = UTF8.to_bytes( rProject.m_Location.wstring() );
+
+		for( const FileFilter& rFileFilter : rProject.m_FileFilters )
+		{
+			const ResolvedConfiguration::Ptr FilterConfig = rProject.FilterConfiguration( Config, rFileFilter );
+
+			for( const std::filesystem::path& rFile : rFileFilter.Files )
+			{
+				if( !Project::IsSourceFile( rFile ) )
+					continue;
+
+				const ResolvedConfiguration::Ptr FileConfig = rProject.FileConfiguration( FilterConfig, rFile );
+				const std::string                File       = UTF8.to_bytes( rFile.wstring() );
+				const std::string                Output     = UTF8.to_bytes( ICompiler::GetCompilerOutputPath( *FileConfig, rFile ).wstring() );
+				const auto                       Arguments  = FileConfig->m_Compiler->CompilerArguments( *FileConfig, rFile );
+
+				Writer.StartObject();
+				Writer.Key( "directory" ); Writer.String( Directory.data(), static_cast< rapidjson::SizeType >( Directory.size() ) );
+				Writer.Key( "arguments" );
+				Writer.StartArray();
+				for( const std::string& rArgument : Arguments )
+					Writer.String( rArgument.data(), static_cast< rapidjson::SizeType >( rArgument.size() ) );
+				Writer.EndArray();
+				Writer.Key( "file" );      Writer.String( File.data(),      static_cast< rapidjson::SizeType >( File.size() ) );
+				Writer.Key( "output" );    Writer.String( Output.data(),    static_cast< rapidjson::SizeType >( Output.size() ) );
+				Writer.EndObject();
+
+				++NumEntries;
+			}
+		}
+	}
+
+	Writer.EndArray();
+	Stream.close();
+
+	if( !Stream )
+	{
+		std::cerr << "Failed to write " << TemporaryPath << "\n";
+		return false;
+	}
+
+	std::error_code Error;
+	std::filesystem::rename( TemporaryPath, rPath, Error );
+
+	if( Error )
+	{
+		std::cerr << "Failed to write " << rPath << ": " << Error.message() << "\n";
+		return false;
+	}
+
+	std::cout << "Exported " << NumEntries << " compile commands to " << rPath << "\n";
+
+	return true;
+
+} // Export
+
+//////////////////////////////////////////////////////////////////////////
+
+bool CompilationDatabase::Import( Workspace& rWorkspace, const std::filesystem::path& rPath )
+{
+	const auto  Begin = std::chrono::steady_clock::now();
+	std::string Buffer;
+
+	if( !BinaryIO::ReadFile( rPath, Buffer ) )
+	{
+		std::cerr << "Failed to read " << rPath << "\n";
+		return false;
+	}
+
+	// Parse in place to avoid copying every string of large databases
+	rapidjson::Document Document;
+	Document.ParseInsitu( Buffer.data() );
+
+	if( Document.HasParseError() || !Document.IsArray() )
+	{
+		std::cerr << "Failed to parse " << rPath << ". Expected an array of compile commands.\n";
+		return false;
+	}
+
+	const std::string                         DefaultName = rPath.parent_path().filename().string();
+	UTF8Converter                             UTF8;
+	std::vector< ImportedProject >            Projects;
+	std::unordered_map< std::string, size_t > ProjectIndices;
+	std::vector< std::string >                Arguments;
+
+	for( const rapidjson::Value& rEntry : Document.GetArray() )
+	{
+		if( !rEntry.IsObject() )
+			continue;
+
+		auto Directory = rEntry.FindMember( "directory" );
+		auto File      = rEntry.FindMember( "file" );
+		auto Output    = rEntry.FindMember( "output" );
+		auto ArgList   = rEntry.FindMember( "arguments" );
+		auto Command   = rEntry.FindMember( "command" );
+
+		if( File == rEntry.MemberEnd() || !File->value.IsString() )
+			continue;
+
+		// Relative paths in an entry are relative to its working directory
+		std::filesystem::path WorkingDirectory = rPath.parent_path();
+
+		if( Directory != rEntry.MemberEnd() && Directory->value.IsString() )
+			WorkingDirectory = WorkingDirectory / UTF8.from_bytes( Directory->value.GetString(), Directory->value.GetString() + Directory->value.GetStringLength() );
+
+		auto ResolvePath = [ & ]( std::string_view String )
+		{
+			return ( WorkingDirectory / UTF8.from_bytes( String.data(), String.data() + String.size() ) ).lexically_normal();
+		};
+
+		Arguments.clear();
+
+		if( ArgList != rEntry.MemberEnd() && ArgList->value.IsArray() )
+		{
+			for( const rapidjson::Value& rArgument : ArgList->value.GetArray() )
+			{
+				if( rArgument.IsString() )
+					Arguments.emplace_back( StringOf( rArgument ) );
+			}
+		}
+		else if( Command != rEntry.MemberEnd() && Command->value.IsString() )
+		{
+			SplitCommandLine( StringOf( Command->value ), Arguments );
+		}
+
+		// Options of cl-style drivers may also start with a slash, which would otherwise be mistaken for absolute paths
+		const std::filesystem::path Driver      = Arguments.empty() ? std::filesystem::path() : std::filesystem::path( Arguments.front() ).stem();
+		const bool                  SlashOption = ( Driver == "cl" || Driver == "clang-cl" );
+
+		// Objects are grouped into projects by the CMake target that they belong to
+		std::string OutputPath = ( Output != rEntry.MemberEnd() && Output->value.IsString() ) ? std::string( StringOf( Output->value ) ) : std::string();
+
+		for( size_t i = 0; OutputPath.empty() && i < Arguments.size(); ++i )
+		{
+			if(      Arguments[ i ] == "-o" && i + 1 < Arguments.size() ) OutputPath = Arguments[ i + 1 ];
+			else if( Arguments[ i ].starts_with( "-Fo" ) && SlashOption ) OutputPath = Arguments[ i ].substr( 3 );
+			else if( Arguments[ i ].starts_with( "/Fo" ) && SlashOption ) OutputPath = Arguments[ i ].substr( 3 );
+		}
+
+		std::replace( OutputPath.begin(), OutputPath.end(), '\\', '/' );
+
+		std::string ProjectName = std::string( CMakeTargetName( OutputPath ) );
+		if( ProjectName.empty() )
+			ProjectName = DefaultName.empty() ? std::string( "Imported" ) : DefaultName;
+
+		auto [ ProjectIndex, Inserted ] = ProjectIndices.try_emplace( ProjectName, Projects.size() );
+		if( Inserted )
+			Projects.emplace_back().Name = ProjectName;
+
+		ImportedProject&            rProject = Projects[ ProjectIndex->second ];
+		const std::filesystem::path FilePath = ResolvePath( StringOf( File->value ) );
+
+		// Databases list a file once per configuration that compiles it
+		if( rProject.SeenFiles.insert( FilePath.wstring() ).second )
+			rProject.Files.push_back( FilePath );
+
+		for( size_t i = 0; i < Arguments.size(); ++i )
+		{
+			const std::string& rArgument = Arguments[ i ];
+			const bool         Include   = rArgument.starts_with( "-I" ) || ( SlashOption && rArgument.starts_with( "/I" ) );
+			const bool         Define    = rArgument.starts_with( "-D" ) || ( SlashOption && rArgument.starts_with( "/D" ) );
+
+			if( !Include && !Define )
+				continue;
+
+			// The value may either be attached to the option or be the next argument
+			std::string_view Value = std::string_view( rArgument ).substr( 2 );
+			if( Value.empty() && i + 1 < Arguments.size() )
+				Value = Arguments[ ++i ];
+
+			if( Value.empty() )
+				continue;
+
+			if( Include )
+			{
+				std::filesystem::path IncludeDir = ResolvePath( Value );
+
+				if( rProject.SeenIncludeDirs.insert( IncludeDir.wstring() ).second )
+					rProject.IncludeDirs.push_back( std::move( IncludeDir ) );
+			}
+			else if( rProject.SeenDefines.emplace( Value ).second )
+			{
+				rProject.Defines.emplace_back( Value );
+			}
+		}
+	}
+
+	size_t NumProjects = 0;
+	size_t NumFiles    = 0;
+
+	for( ImportedProject& rImported : Projects )
+	{
+		if( rWorkspace.ProjectByName( rImported.Name ) )
+		{
+			std::cerr << "Skipping project '" << rImported.Name << "'. A project with that name already exists.\n";
+			continue;
+		}
+
+		// File filters mirror the directories below the closest folder that contains every file
+		std::filesystem::path Root = rImported.Files.front().parent_path();
+
+		for( const std::filesystem::path& rFile : rImported.Files )
+		{
+			while( !IsWithin( rFile, Root ) && Root.has_relative_path() )
+				Root = Root.parent_path();
+		}
+
+		Project&                                   rProject = rWorkspace.NewProject( rWorkspace.m_Location, rImported.Name );
+		std::unordered_map< std::wstring, size_t > FilterIndices;
+
+		// New projects already come with the unnamed filter
+		for( size_t i = 0; i < rProject.m_FileFilters.size(); ++i )
+			FilterIndices.emplace( rProject.m_FileFilters[ i ].Name.wstring(), i );
+
+		for( std::filesystem::path& rrFile : rImported.Files )
+		{
+			std::filesystem::path FilterName = rrFile.parent_path().lexically_relative( Root );
+			if( FilterName == "." )
+				FilterName.clear();
+
+			auto [ FilterIndex, Inserted ] = FilterIndices.try_emplace( FilterName.wstring(), rProject.m_FileFilters.size() );
+			if( Inserted )
+			{
+				FileFilter& rFileFilter = rProject.m_FileFilters.emplace_back();
+				rFileFilter.Name        = FilterName;
+				rFileFilter.Path        = rrFile.parent_path().lexically_relative( rProject.m_Location );
+			}
+
+			rProject.m_FileFilters[ FilterIndex->second ].Files.push_back( std::move( rrFile ) );
+		}
+
+		rProject.m_LocalConfiguration.m_IncludeDirs = std::move( rImported.IncludeDirs );
+		rProject.m_LocalConfiguration.m_Defines     = std::move( rImported.Defines );
+
+		rProject.SortFileFilters();
+		rProject.Serialize();
+
+		++NumProjects;
+		NumFiles += rImported.SeenFiles.size();
+	}
+
+	rWorkspace.Serialize();
+
+	const auto Duration = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - Begin );
+
+	std::cout << "Imported " << NumFiles << " files into " << NumProjects << " projects from " << rPath << " in " << Duration.count() << " ms\n";
+
+	return true;
+
+} // Import
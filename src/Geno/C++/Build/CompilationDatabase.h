@@ -15,28 +15,19 @@
  * 3. This notice may not be removed or altered from any source distribution.
  */
 
-#include "Common/Async/Job.h"
+#pragma once
+#include <filesystem>
+#include <string_view>
 
-//////////////////////////////////////////////////////////////////////////
+class Workspace;
 
-void Job::AddDependency( std::weak_ptr< Job > Job )
+namespace CompilationDatabase
 {
-	m_Dependencies.emplace_back( std::move( Job ) );
-
-} // AddDependency
+	constexpr std::string_view FILE_NAME = "compile_commands.json";
 
 //////////////////////////////////////////////////////////////////////////
 
-bool Job::CanRun( void ) const
-{
-	for( auto& rDependency : m_Dependencies )
-	{
-		auto JobPtr = rDependency.lock();
-
-		if( JobPtr && !JobPtr->m_HasFinishedRunning )
-			return false;
-	}
-
-	return true;
+	bool Export( Workspace& rWorkspace, const std::filesystem::path& rPath );
+	bool Import( Workspace& rWorkspace, const std::filesystem::path& rPath );
 
-} // CanRun
+} // ::CompilationDatabase
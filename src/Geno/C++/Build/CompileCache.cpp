@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "CompileCache.h"
+
+#include "Build/BinaryIO.h"
+#include "Build/BuildState.h"
+#include "Compilers/Toolchain.h"
+
+#include <Common/Hash.h>
+#include <Common/LocalAppData.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#else // _WIN32
+#include <unistd.h>
+#endif // !_WIN32
+
+#if defined( __linux__ )
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif // __linux__
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t COMPILE_CACHE_MAGIC   = 0x31494347; // "GCI1"
+constexpr uint32_t COMPILE_CACHE_VERSION = 1;
+
+using namespace BinaryIO;
+
+//////////////////////////////////////////////////////////////////////////
+
+static int64_t CurrentTime( void )
+{
+	return std::chrono::duration_cast< std::chrono::seconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+
+} // CurrentTime
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string TemporarySuffix( void )
+{
+	// The cache is shared by geno-buildd and every IDE or CLI instance, so thread ids alone can collide
+#if defined( _WIN32 )
+	const uint64_t ProcessId = GetCurrentProcessId();
+#else // _WIN32
+	const uint64_t ProcessId = static_cast< uint64_t >( getpid() );
+#endif // !_WIN32
+
+	return ".tmp" + std::to_string( ProcessId ) + "-" + std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() ) );
+
+} // TemporarySuffix
+
+//////////////////////////////////////////////////////////////////////////
+
+CompileCache::CompileCache( void )
+{
+	if( !LocalAppData::Instance().Path().empty() )
+		m_Path = LocalAppData::Instance().Path() / "CompileCache";
+
+} // CompileCache
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< CompileCache::Key > CompileCache::MakeKey( const std::filesystem::path& rPreprocessedFile, std::string_view CommandLine )
+{
+	if( m_Path.empty() )
+		return std::nullopt;
+
+	// The first argument of the command line is the compiler executable
+	std::string_view Program = CommandLine.substr( 0, CommandLine.find( ' ' ) );
+
+	if( CommandLine.starts_with( '"' ) )
+		Program = CommandLine.substr( 1, CommandLine.find( '"', 1 ) - 1 );
+
+	std::error_code           Error;
+	std::optional< uint64_t > Identity = Toolchain::Instance().Identity( Program );
+	std::optional< uint64_t > Content  = BuildState::HashFile( rPreprocessedFile );
+	const uintmax_t           Size     = std::filesystem::file_size( rPreprocessedFile, Error );
+
+	if( !Identity || !Content || Error )
+		return std::nullopt;
+
+	Key Key;
+	Key.Hash = Hash::Combine( Hash::Combine( Hash::FNV1a( CommandLine ), *Content ), *Identity );
+
+	WriteValue( Key.Inputs, *Identity );
+	WriteValue( Key.Inputs, *Content );
+	WriteValue( Key.Inputs, static_cast< uint64_t >( Size ) );
+	Key.Inputs.append( CommandLine );
+
+	return Key;
+
+} // MakeKey
+
+//////////////////////////////////////////////////////////////////////////
+
+bool CompileCache::Fetch( const Key& rKey, const std::filesystem::path& rObjectFile, const std::filesystem::path& rDependencyFile )
+{
+	const uint64_t              Key     = rKey.Hash;
+	const std::filesystem::path Path    = EntryPath( Key );
+	std::filesystem::path       KeyPath = Path;
+	std::string                 Inputs;
+
+	KeyPath += ".key";
+
+	// A different compile that happens to hash to the same entry is a miss
+	const bool SameInputs = ReadFile( KeyPath, Inputs ) && Inputs == rKey.Inputs;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		LoadIndex();
+
+		if( !SameInputs || !m_Entries.contains( Key ) )
+		{
+			++m_TotalStatistics.Misses;
+			++m_BuildStatistics.Misses;
+			m_Modified = true;
+
+			return false;
+		}
+	}
+
+	std::filesystem::path DependencyPath = Path;
+	DependencyPath += ".deps";
+
+	const bool Restored = Materialize( Path, rObjectFile ) && ( rDependencyFile.empty() || Materialize( DependencyPath, rDependencyFile ) );
+
+	std::scoped_lock Lock( m_Mutex );
+
+	if( Restored )
+	{
+		++m_TotalStatistics.Hits;
+		++m_BuildStatistics.Hits;
+	}
+	else
+	{
+		// The entry was removed from the disk behind our back
+		if( auto It = m_Entries.find( Key ); It != m_Entries.end() )
+		{
+			m_TotalSize -= std::min( m_TotalSize, It->second.Size );
+			m_Entries.erase( It );
+		}
+
+		++m_TotalStatistics.Misses;
+		++m_BuildStatistics.Misses;
+	}
+
+	if( auto It = m_Entries.find( Key ); It != m_Entries.end() )
+		It->second.LastUse = CurrentTime();
+
+	m_Modified = true;
+
+	return Restored;
+
+} // Fetch
+
+//////////////////////////////////////////////////////////////////////////
+
+void CompileCache::Store( const Key& rKey, const std::filesystem::path& rObjectFile, const std::filesystem::path& rDependencyFile )
+{
+	const uint64_t              Key            = rKey.Hash;
+	const std::filesystem::path Path           = EntryPath( Key );
+	std::filesystem::path       DependencyPath = Path;
+	std::filesystem::path       KeyPath        = Path;
+	std::filesystem::path       TemporaryPath  = Path;
+	std::error_code             Error;
+
+	DependencyPath += ".deps";
+	KeyPath        += ".key";
+	TemporaryPath  += TemporarySuffix();
+
+	// Readers in other processes must never see a partially written key
+	if( !WriteFile( TemporaryPath, rKey.Inputs ) )
+		return;
+
+	std::filesystem::rename( TemporaryPath, KeyPath, Error );
+	if( Error )
+		return;
+
+	// The dependency file goes first since the presence of the object is what makes the entry valid
+	if( !rDependencyFile.empty() && std::filesystem::exists( rDependencyFile, Error ) )
+	{
+		if( !Materialize( rDependencyFile, TemporaryPath ) )
+			return;
+
+		std::filesystem::rename( TemporaryPath, DependencyPath, Error );
+		if( Error )
+			return;
+	}
+
+	if( !Materialize( rObjectFile, TemporaryPath ) )
+		return;
+
+	std::filesystem::rename( TemporaryPath, Path, Error );
+	if( Error )
+		return;
+
+	const uint64_t ObjectSize     = std::filesystem::file_size( Path, Error );
+	const uint64_t DependencySize = std::filesystem::file_size( DependencyPath, Error );
+	const uint64_t Size           = ObjectSize + ( Error ? 0 : DependencySize ) + rKey.Inputs.size();
+
+	std::scoped_lock Lock( m_Mutex );
+
+	LoadIndex();
+
+	Entry& rEntry = m_Entries[ Key ];
+
+	m_TotalSize     -= std::min( m_TotalSize, rEntry.Size );
+	m_TotalSize     += Size;
+	rEntry.Size      = Size;
+	rEntry.LastUse   = CurrentTime();
+	m_Modified       = true;
+
+	if( m_TotalSize > m_MaxSize )
+		Evict();
+
+} // Store
+
+//////////////////////////////////////////////////////////////////////////
+
+bool CompileCache::Save( void )
+{
+	std::string Buffer;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		if( !m_Modified || m_Path.empty() )
+			return true;
+
+		WriteValue( Buffer, COMPILE_CACHE_MAGIC );
+		WriteValue( Buffer, COMPILE_CACHE_VERSION );
+		WriteValue( Buffer, m_TotalStatistics.Hits );
+		WriteValue( Buffer, m_TotalStatistics.Misses );
+		WriteValue( Buffer, m_TotalStatistics.Evictions );
+		WriteValue( Buffer, static_cast< uint32_t >( m_Entries.size() ) );
+
+		for( const auto& [ Key, rEntry ] : m_Entries )
+		{
+			WriteValue( Buffer, Key );
+			WriteValue( Buffer, rEntry.Size );
+			WriteValue( Buffer, rEntry.LastUse );
+		}
+
+		m_Modified = false;
+	}
+
+	return WriteFile( m_Path / "index", Buffer );
+
+} // Save
+
+//////////////////////////////////////////////////////////////////////////
+
+CompileCache::Statistics CompileCache::TakeBuildStatistics( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return std::exchange( m_BuildStatistics, Statistics() );
+
+} // TakeBuildStatistics
+
+//////////////////////////////////////////////////////////////////////////
+
+CompileCache::Statistics CompileCache::TotalStatistics( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return m_TotalStatistics;
+
+} // TotalStatistics
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t CompileCache::TotalSize( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	LoadIndex();
+
+	return m_TotalSize;
+
+} // TotalSize
+
+//////////////////////////////////////////////////////////////////////////
+
+bool CompileCache::Materialize( const std::filesystem::path& rSource, const std::filesystem::path& rDestination )
+{
+	std::error_code Error;
+
+	// Never write through an existing hard link, since that would modify the cached copy as well
+	std::filesystem::remove( rDestination, Error );
+	std::filesystem::create_directories( rDestination.parent_path(), Error );
+
+#if defined( __linux__ )
+
+	// Prefer a copy-on-write clone on file systems that support it
+	if( int Source = open( rSource.c_str(), O_RDONLY | O_CLOEXEC ); Source >= 0 )
+	{
+		int  Destination = open( rDestination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+		bool Cloned      = false;
+
+		if( Destination >= 0 )
+		{
+			Cloned = ioctl( Destination, FICLONE, Source ) == 0;
+			close( Destination );
+
+			if( !Cloned )
+				unlink( rDestination.c_str() );
+		}
+
+		close( Source );
+
+		if( Cloned )
+			return true;
+	}
+
+#endif // __linux__
+
+	std::filesystem::create_hard_link( rSource, rDestination, Error );
+	if( !Error )
+		return true;
+
+	return std::filesystem::copy_file( rSource, rDestination, Error ) && !Error;
+
+} // Materialize
+
+//////////////////////////////////////////////////////////////////////////
+
+void CompileCache::LoadIndex( void )
+{
+	if( m_Loaded || m_Path.empty() )
+		return;
+
+	m_Loaded = true;
+
+	std::string FileBuffer;
+	if( ReadFile( m_Path / "index", FileBuffer ) )
+	{
+		std::string_view Buffer = FileBuffer;
+		uint32_t         Magic;
+		uint32_t         Version;
+		uint32_t         NumEntries;
+
+		if( ReadValue( Buffer, Magic ) && Magic == COMPILE_CACHE_MAGIC && ReadValue( Buffer, Version ) && Version == COMPILE_CACHE_VERSION
+		 && ReadValue( Buffer, m_TotalStatistics.Hits ) && ReadValue( Buffer, m_TotalStatistics.Misses ) && ReadValue( Buffer, m_TotalStatistics.Evictions )
+		 && ReadValue( Buffer, NumEntries ) )
+		{
+			m_Entries.reserve( NumEntries );
+
+			for( uint32_t i = 0; i < NumEntries; ++i )
+			{
+				uint64_t Key;
+				Entry    Entry;
+
+				if( !ReadValue( Buffer, Key ) || !ReadValue( Buffer, Entry.Size ) || !ReadValue( Buffer, Entry.LastUse ) )
+					break;
+
+				m_Entries.emplace( Key, Entry );
+				m_TotalSize += Entry.Size;
+			}
+
+			return;
+		}
+	}
+
+	// Without an index, rebuild it from the entries on disk so that they can still be evicted
+	std::error_code Error;
+
+	for( const std::filesystem::directory_entry& rFile : std::filesystem::recursive_directory_iterator( m_Path, Error ) )
+	{
+		const std::filesystem::path& rPath = rFile.path();
+
+		if( !rFile.is_regular_file( Error ) || rPath.has_extension() || rPath.filename() == "index" )
+			continue;
+
+		const std::string Name = rPath.filename().string();
+		char*             pEnd = nullptr;
+		const uint64_t    Key  = strtoull( Name.c_str(), &pEnd, 16 );
+
+		if( *pEnd != '\0' )
+			continue;
+
+		std::filesystem::path DependencyPath = rPath;
+		std::filesystem::path KeyPath        = rPath;
+		DependencyPath += ".deps";
+		KeyPath        += ".key";
+
+		Entry Entry;
+		Entry.Size = rFile.file_size( Error );
+
+		if( const uint64_t DependencySize = std::filesystem::file_size( DependencyPath, Error ); !Error )
+			Entry.Size += DependencySize;
+
+		if( const uint64_t KeySize = std::filesystem::file_size( KeyPath, Error ); !Error )
+			Entry.Size += KeySize;
+
+		m_Entries.emplace( Key, Entry );
+		m_TotalSize += Entry.Size;
+	}
+
+	m_Modified = true;
+
+} // LoadIndex
+
+//////////////////////////////////////////////////////////////////////////
+
+void CompileCache::Evict( void )
+{
+	std::vector< std::pair< int64_t, uint64_t > > Entries;
+	Entries.reserve( m_Entries.size() );
+
+	for( const auto& [ Key, rEntry ] : m_Entries )
+		Entries.emplace_back( rEntry.LastUse, Key );
+
+	std::sort( Entries.begin(), Entries.end() );
+
+	// Leave some headroom so that we don't need to evict again on the very next store
+	const uint64_t TargetSize = m_MaxSize / 10 * 9;
+
+	for( const auto& [ LastUse, Key ] : Entries )
+	{
+		if( m_TotalSize <= TargetSize )
+			break;
+
+		const std::filesystem::path Path           = EntryPath( Key );
+		std::filesystem::path       DependencyPath = Path;
+		std::filesystem::path       KeyPath        = Path;
+		std::error_code             Error;
+
+		DependencyPath += ".deps";
+		KeyPath        += ".key";
+
+		std::filesystem::remove( Path, Error );
+		std::filesystem::remove( DependencyPath, Error );
+		std::filesystem::remove( KeyPath, Error );
+
+		m_TotalSize -= std::min( m_TotalSize, m_Entries[ Key ].Size );
+		m_Entries.erase( Key );
+
+		++m_TotalStatistics.Evictions;
+		++m_BuildStatistics.Evictions;
+	}
+
+	m_Modified = true;
+
+} // Evict
+
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompileCache::EntryPath( uint64_t Key ) const
+{
+	char Name[ 17 ];
+	snprintf( Name, std::size( Name ), "%016llx", static_cast< unsigned long long >( Key ) );
+
+	return m_Path / std::string_view( Name, 2 ) / Name;
+
+} // EntryPath
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/Macros.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class CompileCache
+{
+	GENO_SINGLETON( CompileCache );
+
+	CompileCache( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	struct Statistics
+	{
+		uint64_t Hits      = 0;
+		uint64_t Misses    = 0;
+		uint64_t Evictions = 0;
+
+	}; // Statistics
+
+	// The hash names the entry. The inputs it was made from are stored next to the entry, so that a hash collision is a miss instead of a wrong object.
+	struct Key
+	{
+		uint64_t    Hash = 0;
+		std::string Inputs;
+
+	}; // Key
+
+//////////////////////////////////////////////////////////////////////////
+
+	static constexpr uint64_t DEFAULT_MAX_SIZE = 5ull * 1024 * 1024 * 1024;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::optional< Key > MakeKey( const std::filesystem::path& rPreprocessedFile, std::string_view CommandLine );
+	bool                 Fetch  ( const Key& rKey, const std::filesystem::path& rObjectFile, const std::filesystem::path& rDependencyFile );
+	void                 Store  ( const Key& rKey, const std::filesystem::path& rObjectFile, const std::filesystem::path& rDependencyFile );
+	bool                 Save   ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	Statistics TakeBuildStatistics( void );
+	Statistics TotalStatistics    ( void );
+	uint64_t   TotalSize          ( void );
+	bool       IsEnabled          ( void ) const { return !m_Path.empty(); }
+
+//////////////////////////////////////////////////////////////////////////
+
+	static bool Materialize( const std::filesystem::path& rSource, const std::filesystem::path& rDestination );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	struct Entry
+	{
+		uint64_t Size    = 0;
+		int64_t  LastUse = 0;
+
+	}; // Entry
+
+//////////////////////////////////////////////////////////////////////////
+
+	void                  LoadIndex( void );
+	void                  Evict    ( void );
+	std::filesystem::path EntryPath( uint64_t Key ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::unordered_map< uint64_t, Entry > m_Entries;
+	std::filesystem::path                 m_Path;
+	std::mutex                            m_Mutex;
+
+	Statistics                            m_TotalStatistics;
+	Statistics                            m_BuildStatistics;
+	uint64_t                              m_TotalSize = 0;
+	uint64_t                              m_MaxSize   = DEFAULT_MAX_SIZE;
+	bool                                  m_Loaded    = false;
+	bool                                  m_Modified  = false;
+
+}; // CompileCache
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "DependencyGraph.h"
+
+#include "Build/BinaryIO.h"
+#include "Build/BuildState.h"
+
+#include <Common/Aliases.h>
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t DEPENDENCY_GRAPH_MAGIC   = 0x31474447; // "GDG1"
+constexpr uint32_t DEPENDENCY_GRAPH_VERSION = 1;
+
+using namespace BinaryIO;
+
+//////////////////////////////////////////////////////////////////////////
+
+bool DependencyGraph::Load( const std::filesystem::path& rPath )
+{
+	std::string FileBuffer;
+	if( !ReadFile( rPath, FileBuffer ) )
+		return false;
+
+	std::string_view Buffer = FileBuffer;
+	uint32_t         Magic;
+	uint32_t         Version;
+	uint32_t         NumNodes;
+	uint32_t         NumOutputs;
+
+	if( !ReadValue( Buffer, Magic ) || Magic != DEPENDENCY_GRAPH_MAGIC || !ReadValue( Buffer, Version ) || Version != DEPENDENCY_GRAPH_VERSION || !ReadValue( Buffer, NumNodes ) )
+		return false;
+
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Nodes.clear();
+	m_NodeIndices.clear();
+	m_Edges.clear();
+
+	m_Nodes.resize( NumNodes );
+	m_NodeIndices.reserve( NumNodes );
+
+	for( uint32_t i = 0; i < NumNodes; ++i )
+	{
+		if( !ReadString( Buffer, m_Nodes[ i ] ) )
+			return false;
+
+		m_NodeIndices.emplace( m_Nodes[ i ], i );
+	}
+
+	m_NodeTimes.assign( NumNodes, UNKNOWN_TIME );
+
+	if( !ReadValue( Buffer, NumOutputs ) )
+		return false;
+
+	m_Edges.reserve( NumOutputs );
+
+	for( uint32_t i = 0; i < NumOutputs; ++i )
+	{
+		uint32_t Output;
+		uint32_t NumDependencies;
+
+		if( !ReadValue( Buffer, Output ) || !ReadValue( Buffer, NumDependencies ) || Output >= NumNodes || Buffer.size() < NumDependencies * sizeof( uint32_t ) )
+			return false;
+
+		std::vector< uint32_t >& rDependencies = m_Edges[ Output ];
+		rDependencies.resize( NumDependencies );
+
+		memcpy( rDependencies.data(), Buffer.data(), NumDependencies * sizeof( uint32_t ) );
+		Buffer.remove_prefix( NumDependencies * sizeof( uint32_t ) );
+
+		for( uint32_t Dependency : rDependencies )
+		{
+			if( Dependency >= NumNodes )
+				return false;
+		}
+	}
+
+	m_Modified = false;
+
+	return true;
+
+} // Load
+
+//////////////////////////////////////////////////////////////////////////
+
+bool DependencyGraph::Save( const std::filesystem::path& rPath )
+{
+	std::string Buffer;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		// Only store the nodes that are still referenced so that stale headers don't accumulate over time
+		constexpr uint32_t      UNUSED = ~0u;
+		std::vector< uint32_t > Remap( m_Nodes.size(), UNUSED );
+		std::vector< uint32_t > UsedNodes;
+
+		auto Use = [ & ]( uint32_t Node )
+		{
+			if( Remap[ Node ] == UNUSED )
+			{
+				Remap[ Node ] = static_cast< uint32_t >( UsedNodes.size() );
+				UsedNodes.push_back( Node );
+			}
+		};
+
+		for( const auto& [ Output, rDependencies ] : m_Edges )
+		{
+			Use( Output );
+
+			for( uint32_t Dependency : rDependencies )
+				Use( Dependency );
+		}
+
+		WriteValue( Buffer, DEPENDENCY_GRAPH_MAGIC );
+		WriteValue( Buffer, DEPENDENCY_GRAPH_VERSION );
+		WriteValue( Buffer, static_cast< uint32_t >( UsedNodes.size() ) );
+
+		for( uint32_t Node : UsedNodes )
+			WriteString( Buffer, m_Nodes[ Node ] );
+
+		WriteValue( Buffer, static_cast< uint32_t >( m_Edges.size() ) );
+
+		for( const auto& [ Output, rDependencies ] : m_Edges )
+		{
+			WriteValue( Buffer, Remap[ Output ] );
+			WriteValue( Buffer, static_cast< uint32_t >( rDependencies.size() ) );
+
+			for( uint32_t Dependency : rDependencies )
+				WriteValue( Buffer, Remap[ Dependency ] );
+		}
+
+		m_Modified = false;
+	}
+
+	return WriteFile( rPath, Buffer );
+
+} // Save
+
+//////////////////////////////////////////////////////////////////////////
+
+void DependencyGraph::SetDependencies( const std::filesystem::path& rOutput, const std::vector< std::filesystem::path >& rDependencies )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	std::vector< uint32_t >& rEdges = m_Edges[ Intern( rOutput.generic_string() ) ];
+	rEdges.clear();
+	rEdges.reserve( rDependencies.size() );
+
+	for( const std::filesystem::path& rDependency : rDependencies )
+		rEdges.push_back( Intern( rDependency.lexically_normal().generic_string() ) );
+
+	m_Modified = true;
+
+} // SetDependencies
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::string > DependencyGraph::FindNewerDependency( const std::filesystem::path& rOutput, int64_t Time )
+{
+	struct Dependency
+	{
+		uint32_t    Node;
+		int64_t     Time;
+		std::string Path;
+
+	}; // Dependency
+
+	std::vector< Dependency > Dependencies;
+
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		auto Node = m_NodeIndices.find( rOutput.generic_string() );
+		if( Node == m_NodeIndices.end() )
+			return std::nullopt;
+
+		auto Edges = m_Edges.find( Node->second );
+		if( Edges == m_Edges.end() )
+			return std::nullopt;
+
+		Dependencies.reserve( Edges->second.size() );
+
+		for( uint32_t Dependency : Edges->second )
+			Dependencies.push_back( { Dependency, m_NodeTimes[ Dependency ], m_Nodes[ Dependency ] } );
+	}
+
+	// Most headers are shared between many translation units, so each one is only stat'd once per build
+	bool Resolved = false;
+
+	for( Dependency& rDependency : Dependencies )
+	{
+		if( rDependency.Time == UNKNOWN_TIME )
+		{
+			rDependency.Time = BuildState::FileTime( rDependency.Path );
+			Resolved         = true;
+		}
+	}
+
+	if( Resolved )
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		for( const Dependency& rDependency : Dependencies )
+			m_NodeTimes[ rDependency.Node ] = rDependency.Time;
+	}
+
+	for( const Dependency& rDependency : Dependencies )
+	{
+		if( rDependency.Time == 0 )    return "'" + rDependency.Path + "' is missing";
+		if( rDependency.Time > Time )  return "'" + rDependency.Path + "' has changed";
+	}
+
+	return std::nullopt;
+
+} // FindNewerDependency
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t DependencyGraph::NumEdges( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	size_t NumEdges = 0;
+
+	for( const auto& [ Output, rDependencies ] : m_Edges )
+		NumEdges += rDependencies.size();
+
+	return NumEdges;
+
+} // NumEdges
+
+//////////////////////////////////////////////////////////////////////////
+
+bool DependencyGraph::IsModified( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return m_Modified;
+
+} // IsModified
+
+//////////////////////////////////////////////////////////////////////////
+
+void DependencyGraph::ResetTimes( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	// Headers may have been written since the graph was last used, so a graph that is kept between builds must look them up again
+	std::fill( m_NodeTimes.begin(), m_NodeTimes.end(), UNKNOWN_TIME );
+
+} // ResetTimes
+
+//////////////////////////////////////////////////////////////////////////
+
+std::vector< std::filesystem::path > DependencyGraph::ParseMakeDependencies( std::string_view Contents )
+{
+	std::vector< std::filesystem::path > Dependencies;
+	std::string                          Current;
+	bool                                 InTarget = true;
+
+	auto Flush = [ & ]( void )
+	{
+		if( !Current.empty() && !InTarget )
+			Dependencies.emplace_back( UTF8Converter().from_bytes( Current ) );
+
+		Current.clear();
+	};
+
+	for( size_t i = 0; i < Contents.size(); ++i )
+	{
+		const char Char = Contents[ i ];
+		const char Next = ( i + 1 < Contents.size() ) ? Contents[ i + 1 ] : '\0';
+
+		switch( Char )
+		{
+			case '\\':
+			{
+				if( Next == '\n' )                                                            { Flush(); i += 1; }
+				else if( Next == '\r' && i + 2 < Contents.size() && Contents[ i + 2 ] == '\n' ) { Flush(); i += 2; }
+				else if( Next == ' ' || Next == '#' )                                          { Current += Next; i += 1; }
+				else                                                                           { Current += Char; }
+
+			} break;
+
+			case '$':
+			{
+				Current += Char;
+
+				if( Next == '$' )
+					i += 1;
+
+			} break;
+
+			case ':':
+			{
+				// Drive letters on Windows are followed by a separator, whereas the target is followed by whitespace
+				if( InTarget && ( Next == ' ' || Next == '\t' || Next == '\r' || Next == '\n' || Next == '\0' ) )
+				{
+					Current.clear();
+					InTarget = false;
+				}
+				else
+				{
+					Current += Char;
+				}
+
+			} break;
+
+			case ' ':
+			case '\t':
+			case '\r':
+			{
+				Flush();
+
+			} break;
+
+			case '\n':
+			{
+				Flush();
+				InTarget = true;
+
+			} break;
+
+			default:
+			{
+				Current += Char;
+
+			} break;
+		}
+	}
+
+	Flush();
+
+	return Dependencies;
+
+} // ParseMakeDependencies
+
+//////////////////////////////////////////////////////////////////////////
+
+std::vector< std::filesystem::path > DependencyGraph::ParseMSVCDependencies( std::string_view Contents )
+{
+	std::vector< std::filesystem::path > Dependencies;
+	rapidjson::Document                  Document;
+
+	Document.Parse( Contents.data(), Contents.size() );
+
+	if( Document.HasParseError() || !Document.IsObject() )
+		return Dependencies;
+
+	auto Data = Document.FindMember( "Data" );
+	if( Data == Document.MemberEnd() || !Data->value.IsObject() )
+		return Dependencies;
+
+	auto Includes = Data->value.FindMember( "Includes" );
+	if( Includes == Data->value.MemberEnd() || !Includes->value.IsArray() )
+		return Dependencies;
+
+	UTF8Converter UTF8;
+
+	for( const rapidjson::Value& rInclude : Includes->value.GetArray() )
+	{
+		if( rInclude.IsString() )
+			Dependencies.emplace_back( UTF8.from_bytes( rInclude.GetString(), rInclude.GetString() + rInclude.GetStringLength() ) );
+	}
+
+	return Dependencies;
+
+} // ParseMSVCDependencies
+
+//////////////////////////////////////////////////////////////////////////
+
+uint32_t DependencyGraph::Intern( std::string Path )
+{
+	auto [ It, Inserted ] = m_NodeIndices.try_emplace( std::move( Path ), static_cast< uint32_t >( m_Nodes.size() ) );
+
+	if( Inserted )
+	{
+		m_Nodes.push_back( It->first );
+		m_NodeTimes.push_back( UNKNOWN_TIME );
+	}
+
+	return It->second;
+
+} // Intern
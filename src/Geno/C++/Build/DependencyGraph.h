@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/Macros.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class DependencyGraph
+{
+	GENO_DISABLE_COPY_AND_MOVE( DependencyGraph );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	static constexpr std::string_view EXTENSION = ".gdeps";
+
+//////////////////////////////////////////////////////////////////////////
+
+	DependencyGraph( void ) = default;
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool Load( const std::filesystem::path& rPath );
+	bool Save( const std::filesystem::path& rPath );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void                         SetDependencies    ( const std::filesystem::path& rOutput, const std::vector< std::filesystem::path >& rDependencies );
+	std::optional< std::string > FindNewerDependency( const std::filesystem::path& rOutput, int64_t Time );
+	size_t                       NumEdges           ( void );
+	bool                         IsModified         ( void );
+	void                         ResetTimes         ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	static std::vector< std::filesystem::path > ParseMakeDependencies( std::string_view Contents );
+	static std::vector< std::filesystem::path > ParseMSVCDependencies( std::string_view Contents );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	uint32_t Intern( std::string Path );
+
+//////////////////////////////////////////////////////////////////////////
+
+	static constexpr int64_t UNKNOWN_TIME = -1;
+
+	std::vector< std::string >                              m_Nodes;
+	std::vector< int64_t >                                  m_NodeTimes;
+	std::unordered_map< std::string, uint32_t >             m_NodeIndices;
+	std::unordered_map< uint32_t, std::vector< uint32_t > > m_Edges;
+	std::mutex                                              m_Mutex;
+
+	bool                                                    m_Modified = false;
+
+}; // DependencyGraph
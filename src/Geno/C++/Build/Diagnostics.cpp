@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Diagnostics.h"
+
+#include <Common/Hash.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Removes the color codes that compilers emit when -fdiagnostics-color=always is set
+static void StripEscapeSequences( std::string_view Line, std::string& rResult )
+{
+	rResult.clear();
+
+	for( size_t i = 0; i < Line.size(); ++i )
+	{
+		if( Line[ i ] == '\x1B' && i + 1 < Line.size() && Line[ i + 1 ] == '[' )
+		{
+			// Parameters and intermediate bytes are followed by a single final byte in the range @ to ~
+			for( i += 2; i < Line.size() && ( Line[ i ] < '@' || Line[ i ] > '~' ); ++i );
+			continue;
+		}
+
+		rResult += Line[ i ];
+	}
+
+	// Output that was written on Windows ends every line with a carriage return
+	if( !rResult.empty() && rResult.back() == '\r' )
+		rResult.pop_back();
+
+} // StripEscapeSequences
+
+//////////////////////////////////////////////////////////////////////////
+
+void DiagnosticStore::Clear( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	m_Strings.clear();
+	m_StringIds.clear();
+	m_Entries.clear();
+	m_Notes.clear();
+	m_Index.clear();
+
+	m_NumErrors   = 0;
+	m_NumWarnings = 0;
+
+	m_Generation.fetch_add( 1, std::memory_order_release );
+
+} // Clear
+
+//////////////////////////////////////////////////////////////////////////
+
+void DiagnosticStore::Add( const Diagnostic& rDiagnostic, std::span< const Diagnostic > Notes, const std::filesystem::path& rTranslationUnit )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	Entry NewEntry;
+	NewEntry.File    = Intern( rDiagnostic.File );
+	NewEntry.Message = Intern( rDiagnostic.Message );
+	NewEntry.Line    = rDiagnostic.Line;
+	NewEntry.Column  = rDiagnostic.Column;
+	NewEntry.Level   = rDiagnostic.Level;
+
+	const Key DiagnosticKey = { NewEntry.File, NewEntry.Message, NewEntry.Line, NewEntry.Column, NewEntry.Level };
+
+	// The include stack differs between translation units, so only the first one is kept
+	if( auto It = m_Index.find( DiagnosticKey ); It != m_Index.end() )
+	{
+		m_Entries[ It->second ].Occurrences += 1;
+		m_Generation.fetch_add( 1, std::memory_order_release );
+		return;
+	}
+
+	NewEntry.TranslationUnit = Intern( rTranslationUnit.generic_string() );
+	NewEntry.FirstNote       = static_cast< uint32_t >( m_Notes.size() );
+	NewEntry.NumNotes        = static_cast< uint32_t >( Notes.size() );
+
+	for( const Diagnostic& rNote : Notes )
+	{
+		Entry& rEntry  = m_Notes.emplace_back();
+		rEntry.File    = Intern( rNote.File );
+		rEntry.Message = Intern( rNote.Message );
+		rEntry.Line    = rNote.Line;
+		rEntry.Column  = rNote.Column;
+		rEntry.Level   = rNote.Level;
+	}
+
+	switch( NewEntry.Level )
+	{
+		case Severity::Error:   ++m_NumErrors;   break;
+		case Severity::Warning: ++m_NumWarnings; break;
+		case Severity::Note:                     break;
+	}
+
+	m_Index.emplace( DiagnosticKey, static_cast< uint32_t >( m_Entries.size() ) );
+	m_Entries.push_back( NewEntry );
+
+	m_Generation.fetch_add( 1, std::memory_order_release );
+
+} // Add
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticStore::Diagnostic DiagnosticStore::Get( size_t Index ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return Index < m_Entries.size() ? Materialize( m_Entries[ Index ] ) : Diagnostic();
+
+} // Get
+
+//////////////////////////////////////////////////////////////////////////
+
+std::vector< DiagnosticStore::Diagnostic > DiagnosticStore::Notes( size_t Index ) const
+{
+	std::scoped_lock          Lock( m_Mutex );
+	std::vector< Diagnostic > Result;
+
+	if( Index < m_Entries.size() )
+	{
+		const Entry& rEntry = m_Entries[ Index ];
+
+		Result.reserve( rEntry.NumNotes );
+
+		for( uint32_t i = 0; i < rEntry.NumNotes; ++i )
+			Result.push_back( Materialize( m_Notes[ rEntry.FirstNote + i ] ) );
+	}
+
+	return Result;
+
+} // Notes
+
+//////////////////////////////////////////////////////////////////////////
+
+uint32_t DiagnosticStore::Occurrences( size_t Index ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return Index < m_Entries.size() ? m_Entries[ Index ].Occurrences : 0;
+
+} // Occurrences
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string DiagnosticStore::TranslationUnit( size_t Index ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return Index < m_Entries.size() ? m_Strings[ m_Entries[ Index ].TranslationUnit ] : std::string();
+
+} // TranslationUnit
+
+//////////////////////////////////////////////////////////////////////////
+
+std::vector< uint32_t > DiagnosticStore::Filter( bool Errors, bool Warnings, bool Notes ) const
+{
+	std::scoped_lock        Lock( m_Mutex );
+	std::vector< uint32_t > Result;
+
+	Result.reserve( m_Entries.size() );
+
+	for( uint32_t i = 0; i < static_cast< uint32_t >( m_Entries.size() ); ++i )
+	{
+		switch( m_Entries[ i ].Level )
+		{
+			case Severity::Error:   if( Errors )   Result.push_back( i ); break;
+			case Severity::Warning: if( Warnings ) Result.push_back( i ); break;
+			case Severity::Note:    if( Notes )    Result.push_back( i ); break;
+		}
+	}
+
+	return Result;
+
+} // Filter
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t DiagnosticStore::Size( void ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return m_Entries.size();
+
+} // Size
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t DiagnosticStore::NumErrors( void ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return m_NumErrors;
+
+} // NumErrors
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t DiagnosticStore::NumWarnings( void ) const
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	return m_NumWarnings;
+
+} // NumWarnings
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t DiagnosticStore::KeyHash::operator()( const Key& rKey ) const
+{
+	uint64_t Result = Hash::FNV1A_OFFSET_BASIS;
+	Result          = Hash::Combine( Result, ( static_cast< uint64_t >( rKey.File ) << 32 ) | rKey.Message );
+	Result          = Hash::Combine( Result, ( static_cast< uint64_t >( rKey.Line ) << 32 ) | rKey.Column );
+	Result          = Hash::Combine( Result, static_cast< uint64_t >( rKey.Level ) );
+
+	return static_cast< size_t >( Result );
+
+} // operator()
+
+//////////////////////////////////////////////////////////////////////////
+
+uint32_t DiagnosticStore::Intern( std::string_view String )
+{
+	if( auto It = m_StringIds.find( String ); It != m_StringIds.end() )
+		return It->second;
+
+	const uint32_t Id = static_cast< uint32_t >( m_Strings.size() );
+	m_StringIds.emplace( m_Strings.emplace_back( String ), Id );
+
+	return Id;
+
+} // Intern
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticStore::Diagnostic DiagnosticStore::Materialize( const Entry& rEntry ) const
+{
+	Diagnostic Result;
+	Result.File    = m_Strings[ rEntry.File ];
+	Result.Line    = rEntry.Line;
+	Result.Column  = rEntry.Column;
+	Result.Level   = rEntry.Level;
+	Result.Message = m_Strings[ rEntry.Message ];
+
+	return Result;
+
+} // Materialize
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticParser::DiagnosticParser( LineParser Parser, std::filesystem::path TranslationUnit )
+	: m_Parser         ( std::move( Parser ) )
+	, m_TranslationUnit( std::move( TranslationUnit ) )
+{
+} // DiagnosticParser
+
+//////////////////////////////////////////////////////////////////////////
+
+void DiagnosticParser::ParseLine( std::string_view Line )
+{
+	DiagnosticStore::Diagnostic Diagnostic;
+
+	StripEscapeSequences( Line, m_Line );
+
+	switch( m_Parser( m_Line, Diagnostic ) )
+	{
+		case LineKind::Diagnostic:
+		{
+			// Notes belong to the diagnostic before them, unless there is none
+			if( Diagnostic.Level == DiagnosticStore::Severity::Note && m_Current )
+			{
+				m_Notes.insert( m_Notes.end(), std::make_move_iterator( m_Context.begin() ), std::make_move_iterator( m_Context.end() ) );
+				m_Notes.push_back( std::move( Diagnostic ) );
+				m_Context.clear();
+				break;
+			}
+
+			Finish();
+
+			m_Current = std::move( Diagnostic );
+			m_Notes   = std::move( m_Context );
+
+			m_Context.clear();
+
+		} break;
+
+		case LineKind::Context:
+		{
+			m_Context.push_back( std::move( Diagnostic ) );
+
+		} break;
+
+		case LineKind::Other:
+			break;
+	}
+
+} // ParseLine
+
+//////////////////////////////////////////////////////////////////////////
+
+void DiagnosticParser::Finish( void )
+{
+	if( !m_Current )
+		return;
+
+	DiagnosticStore::Instance().Add( *m_Current, m_Notes, m_TranslationUnit );
+
+	m_Current.reset();
+	m_Notes.clear();
+
+} // Finish
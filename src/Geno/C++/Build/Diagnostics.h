@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/Macros.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The diagnostics that the compilers reported during the last build. A diagnostic that many translation units report, like a warning in a common header,
+// is only stored once.
+class DiagnosticStore
+{
+	GENO_SINGLETON( DiagnosticStore );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	enum class Severity : uint8_t
+	{
+		Note,
+		Warning,
+		Error,
+
+	}; // Severity
+
+	struct Diagnostic
+	{
+		std::string File;            // Empty for diagnostics without a location, like most linker errors
+		uint32_t    Line   = 0;      // 1-based, or 0 if unknown
+		uint32_t    Column = 0;      // 1-based, or 0 if unknown
+		Severity    Level  = Severity::Error;
+		std::string Message;
+
+	}; // Diagnostic
+
+//////////////////////////////////////////////////////////////////////////
+
+	DiagnosticStore( void ) = default;
+
+//////////////////////////////////////////////////////////////////////////
+
+	void Clear( void );
+	void Add  ( const Diagnostic& rDiagnostic, std::span< const Diagnostic > Notes, const std::filesystem::path& rTranslationUnit );
+
+//////////////////////////////////////////////////////////////////////////
+
+	Diagnostic                Get            ( size_t Index ) const;
+	std::vector< Diagnostic > Notes          ( size_t Index ) const;
+	uint32_t                  Occurrences    ( size_t Index ) const;
+	std::string               TranslationUnit( size_t Index ) const;
+	std::vector< uint32_t >   Filter         ( bool Errors, bool Warnings, bool Notes ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	size_t   Size       ( void ) const;
+	size_t   NumErrors  ( void ) const;
+	size_t   NumWarnings( void ) const;
+	uint64_t Generation ( void ) const { return m_Generation.load( std::memory_order_acquire ); }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	// Strings are interned, so that a diagnostic is only a few integers
+	struct Entry
+	{
+		uint32_t File            = 0;
+		uint32_t Message         = 0;
+		uint32_t Line            = 0;
+		uint32_t Column          = 0;
+		uint32_t TranslationUnit = 0;
+		uint32_t FirstNote       = 0;
+		uint32_t NumNotes        = 0;
+		uint32_t Occurrences     = 1;
+		Severity Level           = Severity::Error;
+
+	}; // Entry
+
+	struct Key
+	{
+		uint32_t File    = 0;
+		uint32_t Message = 0;
+		uint32_t Line    = 0;
+		uint32_t Column  = 0;
+		Severity Level   = Severity::Error;
+
+		bool operator==( const Key& rOther ) const = default;
+
+	}; // Key
+
+	struct KeyHash
+	{
+		size_t operator()( const Key& rKey ) const;
+
+	}; // KeyHash
+
+//////////////////////////////////////////////////////////////////////////
+
+	uint32_t   Intern     ( std::string_view String );
+	Diagnostic Materialize( const Entry& rEntry ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::deque< std::string >                        m_Strings     = { }; // A deque never moves its elements, so the views in m_StringIds stay valid
+	std::unordered_map< std::string_view, uint32_t > m_StringIds   = { };
+	std::vector< Entry >                             m_Entries     = { };
+	std::vector< Entry >                             m_Notes       = { };
+	std::unordered_map< Key, uint32_t, KeyHash >     m_Index       = { };
+	mutable std::mutex                               m_Mutex       = { };
+	std::atomic< uint64_t >                          m_Generation  = 0;
+	size_t                                           m_NumErrors   = 0;
+	size_t                                           m_NumWarnings = 0;
+
+}; // DiagnosticStore
+
+//////////////////////////////////////////////////////////////////////////
+
+// Turns the output of a compiler into diagnostics, one line at a time as it arrives
+class DiagnosticParser
+{
+public:
+
+	enum class LineKind
+	{
+		Other,
+		Diagnostic,
+		Context, // Leads up to the next diagnostic, like an include stack or a template instantiation
+
+	}; // LineKind
+
+	// Parses a single line of compiler output, without any terminal escape sequences
+	using LineParser = std::function< LineKind( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	DiagnosticParser( LineParser Parser, std::filesystem::path TranslationUnit );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void ParseLine( std::string_view Line );
+	void Finish   ( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	LineParser                                   m_Parser;
+	std::filesystem::path                        m_TranslationUnit;
+	std::string                                  m_Line;
+	std::optional< DiagnosticStore::Diagnostic > m_Current;
+	std::vector< DiagnosticStore::Diagnostic >   m_Notes;
+	std::vector< DiagnosticStore::Diagnostic >   m_Context;
+
+}; // DiagnosticParser
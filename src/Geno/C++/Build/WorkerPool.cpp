@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "WorkerPool.h"
+
+#include "Build/BinaryIO.h"
+
+#include <Common/Async/JobSystem.h>
+#include <Common/LocalSocket.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+//////////////////////////////////////////////////////////////////////////
+
+WorkerPool::WorkerPool( void )
+{
+	const char* pWorkers = getenv( "GENO_WORKERS" );
+	if( pWorkers == nullptr )
+		return;
+
+	for( std::string_view Workers = pWorkers; !Workers.empty(); )
+	{
+		const size_t           Separator = Workers.find( ':' );
+		const std::string_view Socket    = Workers.substr( 0, Separator );
+
+		if( !Socket.empty() )
+			m_Workers.emplace_back().Socket = Socket;
+
+		Workers.remove_prefix( Separator == std::string_view::npos ? Workers.size() : Separator + 1 );
+	}
+
+} // WorkerPool
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::shared_future< WorkerPool::Result > > WorkerPool::Compile( Process::Arguments Arguments, const std::filesystem::path& rPreprocessedPath, const std::filesystem::path& rOutputPath )
+{
+	WorkerProtocol::CompileRequest Request;
+	Request.Arguments  = std::move( Arguments );
+	Request.SourceName = rPreprocessedPath.filename().string();
+
+	if( !BinaryIO::ReadFile( rPreprocessedPath, Request.Source ) )
+		return std::nullopt;
+
+	Worker* pWorker = Reserve();
+	if( !pWorker )
+		return std::nullopt;
+
+	std::promise< Result >       Promise;
+	std::shared_future< Result > Future = Promise.get_future().share();
+
+	// The thread mostly waits for the worker, and there are never more of them than the workers have slots
+	std::thread( [ this, pWorker, Request = std::move( Request ), rOutputPath, Promise = std::move( Promise ) ]( void ) mutable
+		{
+			Result Outcome = Run( *pWorker, Request, rOutputPath );
+
+			Release( *pWorker, !Outcome.Delivered );
+
+			Promise.set_value( std::move( Outcome ) );
+
+			// The job that waits for the object can run now
+			JobSystem::Instance().FutureFulfilled();
+
+		} ).detach();
+
+	return Future;
+
+} // Compile
+
+//////////////////////////////////////////////////////////////////////////
+
+WorkerPool::Worker* WorkerPool::Reserve( void )
+{
+	std::scoped_lock Lock( m_Mutex );
+	const auto       Now   = std::chrono::steady_clock::now();
+	Worker*          pBest = nullptr;
+
+	for( Worker& rWorker : m_Workers )
+	{
+		if( Now < rWorker.RetryTime )
+			continue;
+
+		if( rWorker.Slots == 0 && !QueryStatus( rWorker ) )
+		{
+			rWorker.RetryTime = Now + RETRY_INTERVAL;
+			continue;
+		}
+
+		if( rWorker.InFlight >= rWorker.Slots )
+			continue;
+
+		// Prefer the worker that is least busy relative to its size
+		if( !pBest || uint64_t( rWorker.InFlight ) * pBest->Slots < uint64_t( pBest->InFlight ) * rWorker.Slots )
+			pBest = &rWorker;
+	}
+
+	if( pBest )
+		++pBest->InFlight;
+
+	return pBest;
+
+} // Reserve
+
+//////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::Release( Worker& rWorker, bool Failed )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	--rWorker.InFlight;
+
+	// Ask again once the worker is given another chance, since it may have been restarted with a different number of slots
+	if( Failed )
+	{
+		rWorker.Slots     = 0;
+		rWorker.RetryTime = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+	}
+
+} // Release
+
+//////////////////////////////////////////////////////////////////////////
+
+bool WorkerPool::QueryStatus( Worker& rWorker )
+{
+	LocalSocket Socket = LocalSocket::Connect( rWorker.Socket );
+	if( !Socket.IsValid() )
+	{
+		std::cerr << "Worker " << rWorker.Socket << " is unreachable. Compiling locally instead.\n";
+		return false;
+	}
+
+	Socket.SetTimeout( STATUS_TIMEOUT );
+
+	std::string                 Payload;
+	WorkerProtocol::StatusReply Reply;
+
+	if( !WorkerProtocol::Send( Socket, WorkerProtocol::MessageType::Status )
+	 || WorkerProtocol::Receive( Socket, Payload ) != WorkerProtocol::MessageType::StatusReply
+	 || !WorkerProtocol::Decode( Payload, Reply )
+	 || Reply.Slots == 0 )
+	{
+		std::cerr << "Worker " << rWorker.Socket << " didn't answer. Compiling locally instead.\n";
+		return false;
+	}
+
+	rWorker.Slots = Reply.Slots;
+
+	return true;
+
+} // QueryStatus
+
+//////////////////////////////////////////////////////////////////////////
+
+WorkerPool::Result WorkerPool::Run( Worker& rWorker, const WorkerProtocol::CompileRequest& rRequest, const std::filesystem::path& rOutputPath )
+{
+	Result                       Outcome;
+	WorkerProtocol::CompileReply Reply;
+	std::string                  Payload;
+
+	Outcome.StartTime = std::chrono::steady_clock::now();
+
+	// Connections aren't reused, so that a worker that restarts between two files is never noticed
+	LocalSocket Socket = LocalSocket::Connect( rWorker.Socket );
+
+	if( !Socket.IsValid()
+	 || !WorkerProtocol::Send( Socket, WorkerProtocol::MessageType::Compile, WorkerProtocol::Encode( rRequest ) )
+	 || WorkerProtocol::Receive( Socket, Payload ) != WorkerProtocol::MessageType::CompileReply
+	 || !WorkerProtocol::Decode( Payload, Reply ) )
+	{
+		std::cerr << "Lost the connection to worker " << rWorker.Socket << ". Compiling locally instead.\n";
+		return Outcome;
+	}
+
+	if( Reply.ExitCode == 0 && !BinaryIO::WriteFile( rOutputPath, Reply.Object ) )
+	{
+		std::cerr << "Failed to write " << rOutputPath << ", which worker " << rWorker.Socket << " compiled\n";
+		return Outcome;
+	}
+
+	Outcome.Delivered = true;
+	Outcome.ExitCode  = Reply.ExitCode;
+	Outcome.Output    = std::move( Reply.Output );
+	Outcome.Usage     = Reply.Usage;
+
+	return Outcome;
+
+} // Run
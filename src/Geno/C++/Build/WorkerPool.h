@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/Macros.h>
+#include <Common/Process.h>
+#include <Common/WorkerProtocol.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Hands compiles out to geno-worker daemons, like distcc does. The sockets of the workers are listed in the GENO_WORKERS environment variable,
+// separated by colons. Every file goes to the worker with the most free slots. When all workers are busy or unreachable, files are compiled locally.
+class WorkerPool
+{
+	GENO_SINGLETON( WorkerPool );
+
+	WorkerPool( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	struct Result
+	{
+		bool                                  Delivered = false; // False if the worker failed, in which case the file should be compiled locally
+		int                                   ExitCode  = -1;
+		std::string                           Output;
+		Process::ResourceUsage                Usage;
+		std::chrono::steady_clock::time_point StartTime = { };
+
+	}; // Result
+
+//////////////////////////////////////////////////////////////////////////
+
+	// How long a worker that couldn't be reached is left alone
+	static constexpr std::chrono::seconds RETRY_INTERVAL = std::chrono::seconds( 10 );
+
+	// How long to wait for a worker to say how many slots it has
+	static constexpr int                  STATUS_TIMEOUT = 2000;
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Compiles the preprocessed file on a worker and writes the object to rOutputPath. The arguments refer to the source and object files through
+	// the placeholders in WorkerProtocol. Returns nothing if no worker has a free slot.
+	std::optional< std::shared_future< Result > > Compile( Process::Arguments Arguments, const std::filesystem::path& rPreprocessedPath, const std::filesystem::path& rOutputPath );
+
+//////////////////////////////////////////////////////////////////////////
+
+	bool HasWorkers( void ) const { return !m_Workers.empty(); }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	struct Worker
+	{
+		std::filesystem::path                 Socket;
+		uint32_t                              Slots     = 0; // 0 until the worker was asked
+		uint32_t                              InFlight  = 0;
+		std::chrono::steady_clock::time_point RetryTime = { };
+
+	}; // Worker
+
+//////////////////////////////////////////////////////////////////////////
+
+	Worker* Reserve    ( void );
+	void    Release    ( Worker& rWorker, bool Failed );
+	bool    QueryStatus( Worker& rWorker );
+	Result  Run        ( Worker& rWorker, const WorkerProtocol::CompileRequest& rRequest, const std::filesystem::path& rOutputPath );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::vector< Worker > m_Workers = { }; // Never resized after construction, so pointers to workers stay valid
+	std::mutex            m_Mutex   = { };
+
+}; // WorkerPool
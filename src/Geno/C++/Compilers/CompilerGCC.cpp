@@ -17,58 +17,353 @@
 
 #include "CompilerGCC.h"
 
+#include "Build/BinaryIO.h"
+#include "Build/DependencyGraph.h"
+
+#include "Common/WorkerProtocol.h"
+
+#include <cctype>
+#include <optional>
+#include <utility>
+
 //////////////////////////////////////////////////////////////////////////
 
-std::wstring CompilerGCC::MakeCompilerCommandLineString( const Configuration& rConfiguration, const std::filesystem::path& rFilePath )
+static void AddCodeGenerationOptions( Process::Arguments& rArguments, const Configuration& rConfiguration )
 {
-	std::wstring Command;
-	Command.reserve( 1024 );
+	// Optimization level
+	if( rConfiguration.m_Optimization )
+	{
+		switch( *rConfiguration.m_Optimization )
+		{
+			case Configuration::Optimization::Off:        { rArguments.push_back( "-O0" ); } break;
+			case Configuration::Optimization::FavorSize:  { rArguments.push_back( "-Os" ); } break;
+			case Configuration::Optimization::FavorSpeed: { rArguments.push_back( "-O2" ); } break;
+			case Configuration::Optimization::Full:       { rArguments.push_back( "-O3" ); } break;
+		}
+	}
 
-	// Start with GCC executable
-	Command += L"g++";
+	// User-defined compiler flags
+	rArguments.insert( rArguments.end(), rConfiguration.m_CompilerFlags.begin(), rConfiguration.m_CompilerFlags.end() );
 
-	// Make it so that we compile separately.
-	Command += L" -c";
+} // AddCodeGenerationOptions
+
+//////////////////////////////////////////////////////////////////////////
 
+static void AddSourceOptions( Process::Arguments& rArguments, const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath )
+{
 	// Language
 	const auto FileExtension = rFilePath.extension();
-	if     ( FileExtension == ".c"   ) Command += L" -x c";
-	else if( FileExtension == ".cpp" ) Command += L" -x c++";
-	else if( FileExtension == ".cxx" ) Command += L" -x c++";
-	else if( FileExtension == ".cc"  ) Command += L" -x c++";
-	else if( FileExtension == ".asm" ) Command += L" -x assembler";
-	else                               Command += L" -x none";
+	rArguments.push_back( "-x" );
+	if     ( FileExtension == ".c"   ) rArguments.push_back( "c" );
+	else if( FileExtension == ".cpp" ) rArguments.push_back( "c++" );
+	else if( FileExtension == ".cxx" ) rArguments.push_back( "c++" );
+	else if( FileExtension == ".cc"  ) rArguments.push_back( "c++" );
+	else if( FileExtension == ".asm" ) rArguments.push_back( "assembler" );
+	else                               rArguments.push_back( "none" );
+
+	// These predefine macros such as __OPTIMIZE__, so the preprocessor needs them too
+	AddCodeGenerationOptions( rArguments, rConfiguration );
+
+	// User-defined preprocessor defines and include directories
+	rArguments.insert( rArguments.end(), rConfiguration.PreprocessorOptions().begin(), rConfiguration.PreprocessorOptions().end() );
+
+	// Include the precompiled header before anything else. GCC picks up the .gch file next to it.
+	if( ICompiler::UsesPrecompiledHeader( rConfiguration, rFilePath ) )
+	{
+		rArguments.push_back( "-include" );
+		rArguments.push_back( ICompiler::PathArgument( ICompiler::GetPrecompiledHeaderPath( rConfiguration ) ) );
+		rArguments.push_back( "-Winvalid-pch" );
+	}
+
+} // AddSourceOptions
+
+//////////////////////////////////////////////////////////////////////////
+
+// Parses "severity: message" after the location of a diagnostic
+static bool ParseSeverity( std::string_view Text, DiagnosticStore::Diagnostic& rDiagnostic )
+{
+	static constexpr std::pair< std::string_view, DiagnosticStore::Severity > SEVERITIES[] =
+	{
+		{ "fatal error: ", DiagnosticStore::Severity::Error },
+		{ "error: ",       DiagnosticStore::Severity::Error },
+		{ "warning: ",     DiagnosticStore::Severity::Warning },
+		{ "note: ",        DiagnosticStore::Severity::Note },
+		{ "remark: ",      DiagnosticStore::Severity::Note },
+	};
+
+	for( const auto&[ rPrefix, Level ] : SEVERITIES )
+	{
+		if( Text.starts_with( rPrefix ) )
+		{
+			rDiagnostic.Level   = Level;
+			rDiagnostic.Message = Text.substr( rPrefix.size() );
+			return true;
+		}
+	}
+
+	return false;
+
+} // ParseSeverity
+
+//////////////////////////////////////////////////////////////////////////
+
+// Parses "file:line[:column]" followed by a colon, and returns what comes after it
+static std::optional< std::string_view > ParseLocation( std::string_view Text, DiagnosticStore::Diagnostic& rDiagnostic )
+{
+	// Skip the drive letter of absolute Windows paths
+	const size_t Start = ( Text.size() > 2 && Text[ 1 ] == ':' && ( Text[ 2 ] == '\\' || Text[ 2 ] == '/' ) ) ? 2 : 0;
+
+	for( size_t Colon = Text.find( ':', Start ); Colon != std::string_view::npos; Colon = Text.find( ':', Colon + 1 ) )
+	{
+		uint32_t Numbers[ 2 ] = { };
+		size_t   NumNumbers   = 0;
+		size_t   End          = Colon;
+
+		while( NumNumbers < std::size( Numbers ) && End + 1 < Text.size() && std::isdigit( static_cast< unsigned char >( Text[ End + 1 ] ) ) )
+		{
+			for( ++End; End < Text.size() && std::isdigit( static_cast< unsigned char >( Text[ End ] ) ); ++End )
+				Numbers[ NumNumbers ] = Numbers[ NumNumbers ] * 10 + ( Text[ End ] - '0' );
+
+			++NumNumbers;
+
+			if( End >= Text.size() || Text[ End ] != ':' )
+				break;
+		}
+
+		if( NumNumbers == 0 || End >= Text.size() || Text[ End ] != ':' )
+			continue;
+
+		rDiagnostic.File   = Text.substr( 0, Colon );
+		rDiagnostic.Line   = Numbers[ 0 ];
+		rDiagnostic.Column = Numbers[ 1 ];
+
+		Text.remove_prefix( End + 1 );
+
+		while( !Text.empty() && Text.front() == ' ' )
+			Text.remove_prefix( 1 );
+
+		return Text;
+	}
+
+	return std::nullopt;
+
+} // ParseLocation
+
+//////////////////////////////////////////////////////////////////////////
+
+Toolchain::InfoPtr CompilerGCC::ProbeToolchain( const Configuration& /*rConfiguration*/ )
+{
+	return Toolchain::Instance().GCC( "g++" );
+
+} // ProbeToolchain
+
+//////////////////////////////////////////////////////////////////////////
 
-	// TODO: Defines
+Process::Arguments CompilerGCC::MakePreprocessorOptions( const Configuration& rConfiguration )
+{
+	Process::Arguments Arguments;
+	Arguments.reserve( rConfiguration.m_Defines.size() + rConfiguration.m_IncludeDirs.size() );
+
+	// User-defined preprocessor defines
+	for( const std::string& rDefine : rConfiguration.m_Defines )
+	{
+		Arguments.push_back( "-D" + rDefine );
+	}
+
+	// User-defined include directories
+	for( const std::filesystem::path& rIncludeDir : rConfiguration.m_IncludeDirs )
+	{
+		Arguments.push_back( "-I" + PathArgument( rIncludeDir ) );
+	}
+
+	return Arguments;
+
+} // MakePreprocessorOptions
+
+//////////////////////////////////////////////////////////////////////////
+
+Process::Arguments CompilerGCC::MakeCompilerArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath )
+{
+	const std::filesystem::path OutputPath = GetCompilerOutputPath( rConfiguration, rFilePath );
+	Process::Arguments          Arguments;
+	Arguments.reserve( 16 + rConfiguration.PreprocessorOptions().size() );
+
+	// Start with GCC executable
+	Arguments.push_back( "g++" );
+
+	// Make it so that we compile separately.
+	Arguments.push_back( "-c" );
+
+	// Options that affect the preprocessed output
+	AddSourceOptions( Arguments, rConfiguration, rFilePath );
 
 	// Verbosity
 	if( rConfiguration.m_Verbose )
 	{
 		// Time the execution of each subprocess
-		Command += L" -time";
+		Arguments.push_back( "-time" );
 
 		// Verbose logging
-		Command += L" -v";
+		Arguments.push_back( "-v" );
+	}
+
+	// Keep the debug info in .dwo files next to the objects so that the linker doesn't have to process it
+	if( rConfiguration.m_SplitDebugInfo.value_or( false ) )
+	{
+		const Toolchain::InfoPtr ToolchainInfo = ProbeToolchain( rConfiguration );
+
+		Arguments.push_back( "-g" );
+
+		// Fall back to regular debug info on compilers that are too old
+		if( !ToolchainInfo || ToolchainInfo->Supports( "-gsplit-dwarf" ) )
+			Arguments.push_back( "-gsplit-dwarf" );
 	}
 
+	// Write the user headers that the file includes to a depfile
+	Arguments.push_back( "-MMD" );
+	Arguments.push_back( "-MF" );
+	Arguments.push_back( PathArgument( GetDependencyFilePath( OutputPath ) ) );
+
 	// Set output file
-	Command += L" -o " + GetCompilerOutputPath( rConfiguration, rFilePath ).wstring();
+	Arguments.push_back( "-o" );
+	Arguments.push_back( PathArgument( OutputPath ) );
 
 	// Finally, the input source file
-	Command += L" " + rFilePath.wstring();
+	Arguments.push_back( PathArgument( rFilePath ) );
 
-	return Command;
+	return Arguments;
 
-} // MakeCompilerCommandLineString
+} // MakeCompilerArguments
 
 //////////////////////////////////////////////////////////////////////////
 
-std::wstring CompilerGCC::MakeLinkerCommandLineString( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind )
+Process::Arguments CompilerGCC::MakePreprocessorArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath, const std::filesystem::path& rOutputPath )
 {
-	std::wstring Command;
-	Command.reserve( 256 );
+	Process::Arguments Arguments;
+	Arguments.reserve( 16 + rConfiguration.PreprocessorOptions().size() );
 
-	UTF8Converter UTF8;
+	// Start with GCC executable
+	Arguments.push_back( "g++" );
+
+	// Stop after the preprocessing stage
+	Arguments.push_back( "-E" );
+
+	// Options that affect the preprocessed output
+	AddSourceOptions( Arguments, rConfiguration, rFilePath );
+
+	// Write the depfile of the object here, since a worker that compiles the preprocessed file can't
+	Arguments.push_back( "-MMD" );
+	Arguments.push_back( "-MF" );
+	Arguments.push_back( PathArgument( GetDependencyFilePath( GetCompilerOutputPath( rConfiguration, rFilePath ) ) ) );
+
+	// Set output file
+	Arguments.push_back( "-o" );
+	Arguments.push_back( PathArgument( rOutputPath ) );
+
+	// Finally, the input source file
+	Arguments.push_back( PathArgument( rFilePath ) );
+
+	return Arguments;
+
+} // MakePreprocessorArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< Process::Arguments > CompilerGCC::MakeRemoteCompilerArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath )
+{
+	// The .dwo files that go along with the objects would stay on the worker
+	if( rConfiguration.m_SplitDebugInfo.value_or( false ) )
+		return std::nullopt;
+
+	Process::Arguments Arguments;
+	Arguments.reserve( 16 );
+
+	// Start with GCC executable
+	Arguments.push_back( "g++" );
+
+	// Make it so that we compile separately.
+	Arguments.push_back( "-c" );
+
+	// The source is already preprocessed, which GCC has to be told since the worker names the file after the preprocessed output
+	const auto FileExtension = rFilePath.extension();
+	Arguments.push_back( "-x" );
+	if     ( FileExtension == ".c"   ) Arguments.push_back( "cpp-output" );
+	else if( FileExtension == ".cpp" ) Arguments.push_back( "c++-cpp-output" );
+	else if( FileExtension == ".cxx" ) Arguments.push_back( "c++-cpp-output" );
+	else if( FileExtension == ".cc"  ) Arguments.push_back( "c++-cpp-output" );
+	else                               return std::nullopt;
+
+	// Options such as -march=native depend on the machine that runs the compiler
+	for( const std::string& rFlag : rConfiguration.m_CompilerFlags )
+	{
+		if( rFlag.ends_with( "=native" ) )
+			return std::nullopt;
+	}
+
+	AddCodeGenerationOptions( Arguments, rConfiguration );
+
+	// Verbosity
+	if( rConfiguration.m_Verbose )
+	{
+		// Time the execution of each subprocess
+		Arguments.push_back( "-time" );
+
+		// Verbose logging
+		Arguments.push_back( "-v" );
+	}
+
+	// Set output file
+	Arguments.push_back( "-o" );
+	Arguments.emplace_back( WorkerProtocol::OUTPUT_PLACEHOLDER );
+
+	// Finally, the preprocessed source file
+	Arguments.emplace_back( WorkerProtocol::INPUT_PLACEHOLDER );
+
+	return Arguments;
+
+} // MakeRemoteCompilerArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+Process::Arguments CompilerGCC::MakePrecompiledHeaderArguments( const ResolvedConfiguration& rConfiguration )
+{
+	const std::filesystem::path OutputPath = GetPrecompiledHeaderOutputPath( rConfiguration );
+	Process::Arguments          Arguments;
+	Arguments.reserve( 16 + rConfiguration.PreprocessorOptions().size() );
+
+	// Start with GCC executable
+	Arguments.push_back( "g++" );
+
+	// Compile the header into a .gch file
+	Arguments.push_back( "-x" );
+	Arguments.push_back( "c++-header" );
+
+	// The precompiled header can only be used if it was built with the same options
+	AddCodeGenerationOptions( Arguments, rConfiguration );
+	Arguments.insert( Arguments.end(), rConfiguration.PreprocessorOptions().begin(), rConfiguration.PreprocessorOptions().end() );
+
+	// Write the user headers that the precompiled header includes to a depfile
+	Arguments.push_back( "-MMD" );
+	Arguments.push_back( "-MF" );
+	Arguments.push_back( PathArgument( GetDependencyFilePath( OutputPath ) ) );
+
+	// Set output file
+	Arguments.push_back( "-o" );
+	Arguments.push_back( PathArgument( OutputPath ) );
+
+	// Finally, the generated wrapper header
+	Arguments.push_back( PathArgument( GetPrecompiledHeaderSourcePath( rConfiguration ) ) );
+
+	return Arguments;
+
+} // MakePrecompiledHeaderArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+Process::Arguments CompilerGCC::MakeLinkerArguments( const ResolvedConfiguration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind )
+{
+	Process::Arguments Arguments;
+	Arguments.reserve( 16 + InputFiles.size() );
 
 	switch( Kind )
 	{
@@ -76,59 +371,85 @@ std::wstring CompilerGCC::MakeLinkerCommandLineString( const Configuration& rCon
 		case Project::Kind::DynamicLibrary:
 		{
 			// Start with GCC executable
-			Command += L"g++";
+			Arguments.push_back( "g++" );
 
 			// Create a shared library
 			if( Kind == Project::Kind::DynamicLibrary )
-				Command += L" -shared";
+				Arguments.push_back( "-shared" );
 
-			// User-defined library directories
-			for( const std::filesystem::path& rLibraryDirectory : rConfiguration.m_LibraryDirs )
+			// Linker
+			switch( rConfiguration.m_Linker.value_or( Configuration::Linker::Default ) )
 			{
-				Command += L" -L" + rLibraryDirectory.wstring();
+				case Configuration::Linker::BFD:  { Arguments.push_back( "-fuse-ld=bfd" );  } break;
+				case Configuration::Linker::Gold: { Arguments.push_back( "-fuse-ld=gold" ); } break;
+				case Configuration::Linker::LLD:  { Arguments.push_back( "-fuse-ld=lld" );  } break;
+				case Configuration::Linker::Mold: { Arguments.push_back( "-fuse-ld=mold" ); } break;
+				default:                          {                                         } break;
 			}
 
-			// Link libraries
-			for( const std::string& rLibrary : rConfiguration.m_Libraries )
+			// Let the linker build an index of the split debug info. BFD doesn't support it.
+			if( rConfiguration.m_SplitDebugInfo.value_or( false ) )
+			{
+				switch( rConfiguration.m_Linker.value_or( Configuration::Linker::Default ) )
+				{
+					case Configuration::Linker::Gold:
+					case Configuration::Linker::LLD:
+					case Configuration::Linker::Mold: { Arguments.push_back( "-Wl,--gdb-index" ); } break;
+					default:                          {                                           } break;
+				}
+			}
+
+			// User-defined library directories
+			for( const std::filesystem::path& rLibraryDirectory : rConfiguration.m_LibraryDirs )
 			{
-				Command += L" -l" + UTF8.from_bytes( rLibrary );
+				Arguments.push_back( "-L" + PathArgument( rLibraryDirectory ) );
 			}
 
 			// Set output file
-			Command += L" -o " + GetLinkerOutputPath( rConfiguration, rOutputName, Kind ).wstring();
+			Arguments.push_back( "-o" );
+			Arguments.push_back( PathArgument( GetLinkerOutputPath( rConfiguration, rOutputName, Kind ) ) );
 
-			// Finally, set the object files
+			// Set the object files. They must come before the libraries, since the linker only takes what is already missing from a static library.
 			for( const std::filesystem::path& rInputFile : InputFiles )
-				Command += L" " + rInputFile.wstring();
+				Arguments.push_back( PathArgument( rInputFile ) );
+
+			// Finally, link libraries
+			for( const std::string& rLibrary : rConfiguration.m_Libraries )
+			{
+				Arguments.push_back( "-l" + rLibrary );
+			}
 
 		} break;
 
 		case Project::Kind::StaticLibrary:
 		{
 			// Start with AR executable
-			Command += L"bin/ar";
+			Arguments.push_back( "bin/ar" );
 
 			// Command: Replace existing or insert new file(s) into the archive
-			Command += L" r";
+			std::string Command = "r";
 
 			// Use full path names when matching
-			Command += L'P';
-
-			// Only replace files that are newer than current archive contents
-			Command += L'u';
+			Command += 'P';
 
 			// Do not warn if the library had to be created
-			Command += L'c';
+			Command += 'c';
 
 			// Create an archive index (cf. ranlib)
-			Command += L's';
+			Command += 's';
+
+			// Only store the paths of the object files rather than copying them into the archive
+			if( rConfiguration.m_ThinArchives.value_or( false ) )
+				Command += 'T';
+
+			Arguments.push_back( std::move( Command ) );
 
 			// Set output file
-			Command += L" " + GetLinkerOutputPath( rConfiguration, rOutputName, Kind ).wstring();
+			Arguments.push_back( PathArgument( GetLinkerOutputPath( rConfiguration, rOutputName, Kind ) ) );
 
 			// Set input files
 			for( const std::filesystem::path& rInputFile : InputFiles )
-				Command += L" " + rInputFile.wstring();
+				Arguments.push_back( PathArgument( rInputFile ) );
 
 		} break;
 
@@ -137,6 +458,126 @@ std::wstring CompilerGCC::MakeLinkerCommandLineString( const Configuration& rCon
 		} break;
 	}
 
-	return Command;
+	return Arguments;
+
+} // MakeLinkerArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::vector< std::filesystem::path > > CompilerGCC::ReadDependencies( const std::filesystem::path& rDependencyFile )
+{
+	std::string Contents;
+	if( !BinaryIO::ReadFile( rDependencyFile, Contents ) )
+		return std::nullopt;
+
+	return DependencyGraph::ParseMakeDependencies( Contents );
+
+} // ReadDependencies
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerGCC::GetDependencyFilePath( const std::filesystem::path& rOutputPath )
+{
+	return std::filesystem::path( rOutputPath ) += ".d";
+
+} // GetDependencyFilePath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerGCC::GetPrecompiledHeaderSourcePath( const Configuration& rConfiguration )
+{
+	return GetPrecompiledHeaderPath( rConfiguration );
+
+} // GetPrecompiledHeaderSourcePath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerGCC::GetPrecompiledHeaderOutputPath( const Configuration& rConfiguration )
+{
+	return GetPrecompiledHeaderPath( rConfiguration ) += ".gch";
+
+} // GetPrecompiledHeaderOutputPath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerGCC::GetPrecompiledHeaderObjectPath( const Configuration& /*rConfiguration*/ )
+{
+	// GCC doesn't produce an object file for the precompiled header
+	return std::filesystem::path();
+
+} // GetPrecompiledHeaderObjectPath
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticParser::LineKind CompilerGCC::ParseDiagnostic( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) const
+{
+	// In file included from a.h:1,
+	//                  from b.cpp:2:
+	for( std::string_view Prefix : { "In file included from ", "from " } )
+	{
+		const size_t Start = Line.find_first_not_of( ' ' );
+
+		if( Start == std::string_view::npos || Line.substr( Start ).rfind( Prefix, 0 ) != 0 )
+			continue;
+
+		// The location ends with a comma when it isn't the last one, so it won't parse as is
+		std::string Location = std::string( Line.substr( Start + Prefix.size() ) );
+		if( !Location.empty() && Location.back() == ',' )
+			Location.back() = ':';
+
+		if( ParseLocation( Location, rDiagnostic ) )
+		{
+			rDiagnostic.Level   = DiagnosticStore::Severity::Note;
+			rDiagnostic.Message = "In file included from here";
+			return DiagnosticParser::LineKind::Context;
+		}
+	}
+
+	// Quoted source code and the carets below it are indented, which no path is
+	if( Line.starts_with( ' ' ) )
+		return DiagnosticParser::LineKind::Other;
+
+	if( std::optional< std::string_view > Text = ParseLocation( Line, rDiagnostic ) )
+	{
+		if( ParseSeverity( *Text, rDiagnostic ) )
+			return DiagnosticParser::LineKind::Diagnostic;
+
+		// a.cpp:8:6:   required from here
+		rDiagnostic.Level   = DiagnosticStore::Severity::Note;
+		rDiagnostic.Message = *Text;
+		return DiagnosticParser::LineKind::Context;
+	}
+
+	// Everything else starts with a file or program name
+	const size_t Separator = Line.find( ": " );
+	if( Separator == std::string_view::npos || Separator == 0 )
+		return DiagnosticParser::LineKind::Other;
+
+	const std::string_view Name = Line.substr( 0, Separator );
+	const std::string_view Text = Line.substr( Separator + 2 );
+
+	// a.cpp: In function 'int main()':
+	if( ( Text.starts_with( "In " ) || Text.starts_with( "At " ) ) && Text.ends_with( ':' ) )
+	{
+		rDiagnostic.File    = Name;
+		rDiagnostic.Level   = DiagnosticStore::Severity::Note;
+		rDiagnostic.Message = Text.substr( 0, Text.size() - 1 );
+		return DiagnosticParser::LineKind::Context;
+	}
+
+	// g++: error: a.cpp: No such file or directory
+	if( ParseSeverity( Text, rDiagnostic ) )
+		return DiagnosticParser::LineKind::Diagnostic;
+
+	// /usr/bin/ld: a.o: in function `main':
+	// /usr/bin/ld: a.cpp:(.text+0x5): undefined reference to `f()'
+	if( Text.find( "undefined reference to " ) != std::string_view::npos || Text.find( "multiple definition of " ) != std::string_view::npos )
+	{
+		rDiagnostic.Level   = DiagnosticStore::Severity::Error;
+		rDiagnostic.Message = Text;
+		return DiagnosticParser::LineKind::Diagnostic;
+	}
+
+	return DiagnosticParser::LineKind::Other;
 
-} // MakeLinkerCommandLineString
+} // ParseDiagnostic
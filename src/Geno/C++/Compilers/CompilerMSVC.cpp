@@ -19,198 +19,288 @@
 
 #include "CompilerMSVC.h"
 
+#include "Build/BinaryIO.h"
+#include "Build/DependencyGraph.h"
 #include "Components/Project.h"
 
 #include <Common/Process.h>
 
-#include <Windows.h>
+#include <cstdio>
+#include <utility>
 
 //////////////////////////////////////////////////////////////////////////
 
-static std::wstring GetHostString( void )
+static void AddSourceOptions( Process::Arguments& rArguments, const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath )
 {
-	switch( Configuration::HostArchitecture() )
+	// Language-specific options
+	const auto FileExtension = rFilePath.extension();
+	if( FileExtension == ".c" )
+	{
+		rArguments.push_back( "/std:c11" );
+	}
+	else if( FileExtension == ".cpp" || FileExtension == ".cxx" || FileExtension == ".cc" )
 	{
-		case Configuration::Architecture::x86:    return L"Hostx86";
-		case Configuration::Architecture::x86_64: return L"Hostx64";
-		default:                                  return L"Hostx64";
+		rArguments.push_back( "/std:c++latest" );
+		rArguments.push_back( "/D" );
+		rArguments.push_back( "_HAS_EXCEPTIONS=0" );
 	}
 
-} // GetHostString
+	// Optimization level
+	if( rConfiguration.m_Optimization )
+	{
+		switch( *rConfiguration.m_Optimization )
+		{
+			case Configuration::Optimization::Off:        { rArguments.push_back( "/Od" ); } break;
+			case Configuration::Optimization::FavorSize:  { rArguments.push_back( "/O1" ); } break;
+			case Configuration::Optimization::FavorSpeed: { rArguments.push_back( "/O2" ); } break;
+			case Configuration::Optimization::Full:       { rArguments.push_back( "/Ox" ); } break;
+		}
+	}
+
+	// User-defined compiler flags
+	rArguments.insert( rArguments.end(), rConfiguration.m_CompilerFlags.begin(), rConfiguration.m_CompilerFlags.end() );
+
+	// Defines and include directories
+	rArguments.insert( rArguments.end(), rConfiguration.PreprocessorOptions().begin(), rConfiguration.PreprocessorOptions().end() );
+
+} // AddSourceOptions
 
 //////////////////////////////////////////////////////////////////////////
 
-static std::wstring GetTargetString( const Configuration::Architecture Architecture )
+static void AddInputFile( Process::Arguments& rArguments, const std::filesystem::path& rFilePath )
 {
-	switch( Architecture )
-	{
-		case Configuration::Architecture::x86:    return L"x86";
-		case Configuration::Architecture::x86_64: return L"x64";
-		default:                                  return GetTargetString( Configuration::HostArchitecture() );
-	}
+	const auto FileExtension = rFilePath.extension();
+	if     ( FileExtension == ".c"   ) rArguments.push_back( "/Tc" );
+	else if( FileExtension == ".cpp" ) rArguments.push_back( "/Tp" );
+	else if( FileExtension == ".cxx" ) rArguments.push_back( "/Tp" );
+	else if( FileExtension == ".cc"  ) rArguments.push_back( "/Tp" );
+	else                               return;
+
+	rArguments.push_back( ICompiler::PathArgument( rFilePath ) );
 
-} // GetTargetString
+} // AddInputFile
 
 //////////////////////////////////////////////////////////////////////////
 
-static std::filesystem::path FindProgramFilesX86Dir( void )
+// Parses "severity [code]: message" after the location of a diagnostic
+static bool ParseSeverity( std::string_view Text, DiagnosticStore::Diagnostic& rDiagnostic )
 {
-	if( DWORD ProgramFilesLength = GetEnvironmentVariableW( L"ProgramFiles(x86)", nullptr, 0 ) )
+	static constexpr std::pair< std::string_view, DiagnosticStore::Severity > SEVERITIES[] =
 	{
-		std::wstring ProgramFilesBuffer;
-		ProgramFilesBuffer.resize( ProgramFilesLength );
+		{ "fatal error", DiagnosticStore::Severity::Error },
+		{ "error",       DiagnosticStore::Severity::Error },
+		{ "warning",     DiagnosticStore::Severity::Warning },
+		{ "note",        DiagnosticStore::Severity::Note },
+	};
 
-		GetEnvironmentVariableW( L"ProgramFiles(x86)", ProgramFilesBuffer.data(), ProgramFilesLength );
+	// cl : Command line warning D9025 : overriding '/W3' with '/W4'
+	if( Text.starts_with( "Command line " ) )
+		Text.remove_prefix( std::size( "Command line " ) - 1 );
 
-		// Remove extra null-terminator
-		ProgramFilesBuffer.pop_back();
-
-		return ProgramFilesBuffer;
+	for( const auto&[ rPrefix, Level ] : SEVERITIES )
+	{
+		if( !Text.starts_with( rPrefix ) || Text.size() == rPrefix.size() || ( Text[ rPrefix.size() ] != ' ' && Text[ rPrefix.size() ] != ':' ) )
+			continue;
+
+		// The code stays in the message, since it's what people search for
+		std::string_view Message = Text.substr( rPrefix.size() );
+		if( Message.starts_with( ": " ) )
+			Message.remove_prefix( 2 );
+		while( Message.starts_with( ' ' ) )
+			Message.remove_prefix( 1 );
+
+		rDiagnostic.Level   = Level;
+		rDiagnostic.Message = Message;
+		return true;
 	}
 
-	return std::filesystem::path();
+	return false;
+
+} // ParseSeverity
+
+//////////////////////////////////////////////////////////////////////////
+
+Toolchain::InfoPtr CompilerMSVC::ProbeToolchain( const Configuration& rConfiguration )
+{
+	return Toolchain::Instance().MSVC( rConfiguration.m_Architecture.value_or( Configuration::HostArchitecture() ) );
 
-} // FindProgramFilesX86Dir
+} // ProbeToolchain
 
 //////////////////////////////////////////////////////////////////////////
 
-static std::filesystem::path FindMSVCDir( const std::filesystem::path& rProgramFilesX86 )
+Process::Arguments CompilerMSVC::MakePreprocessorOptions( const Configuration& rConfiguration )
 {
-	const std::filesystem::path VSWhereLocation = rProgramFilesX86 / "Microsoft Visual Studio" / "Installer" / "vswhere.exe";
-	if( std::filesystem::exists( VSWhereLocation ) )
+	const Toolchain::InfoPtr ToolchainInfo = ProbeToolchain( rConfiguration );
+	Process::Arguments       Arguments;
+
+	// Add user-defined preprocessor defines
+	for( const std::string& rDefine : rConfiguration.m_Defines )
+	{
+		Arguments.push_back( "/D" );
+		Arguments.push_back( rDefine );
+	}
+
+	// Set standard include directories
+	if( ToolchainInfo )
 	{
-		// Run vswhere.exe to get the installation path of Visual Studio
-		int                Result;
-		std::wstring       VSWhereLocationFull = VSWhereLocation.wstring() + L" -legacy -prerelease -latest -property installationPath";
-		Process            VSWhereProcess = Process( VSWhereLocationFull );
-		const std::wstring VSWhereOutput = VSWhereProcess.OutputOf( Result );
-		if( Result == 0 )
+		for( const std::filesystem::path& rIncludeDir : ToolchainInfo->SystemIncludeDirs )
 		{
-			// Trim trailing newlines
-			const std::filesystem::path VisualStudioLocation( VSWhereOutput.begin(), VSWhereOutput.end() - 2 );
-			if( std::filesystem::exists( VisualStudioLocation ) )
-			{
-				for( const std::filesystem::directory_entry& rMSVCDir : std::filesystem::directory_iterator( VisualStudioLocation / "VC" / "Tools" / "MSVC" ) )
-				{
-					// Just choose the first best version
-					if( true )
-						return rMSVCDir;
-				}
-			}
+			Arguments.push_back( "/I" + PathArgument( rIncludeDir ) );
 		}
 	}
 
-	return std::filesystem::path();
+	// Add user-defined include directories
+	for( const std::filesystem::path& rIncludeDir : rConfiguration.m_IncludeDirs )
+	{
+		Arguments.push_back( "/I" + PathArgument( rIncludeDir ) );
+	}
 
-} // FindMSVCDir
+	return Arguments;
+
+} // MakePreprocessorOptions
 
 //////////////////////////////////////////////////////////////////////////
 
-static std::wstring FindWindowsSDKVersion( const Configuration& rConfiguration, const std::filesystem::path& rProgramFilesX86 )
+Process::Arguments CompilerMSVC::MakeCompilerArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath )
 {
-	const std::wstring Target = GetTargetString( rConfiguration.m_Architecture.value_or( Configuration::HostArchitecture() ) );
+	const Toolchain::InfoPtr ToolchainInfo = ProbeToolchain( rConfiguration );
+
+	if( !ToolchainInfo )
+		return { };
 
-	for( const std::filesystem::directory_entry& rDirectory : std::filesystem::directory_iterator( rProgramFilesX86 / "Windows Kits" / "10" / "Lib" ) )
+	const std::filesystem::path OutputPath = GetCompilerOutputPath( rConfiguration, rFilePath );
+	Process::Arguments          Arguments;
+	Arguments.push_back( PathArgument( ToolchainInfo->Executable ) );
+	Arguments.push_back( "/nologo" );
+
+	// Compile (don't just preprocess)
+	Arguments.push_back( "/c" );
+
+	// Options that affect the preprocessed output
+	AddSourceOptions( Arguments, rConfiguration, rFilePath );
+
+	// Force-include the precompiled header. The name must match the one that it was created with exactly.
+	if( UsesPrecompiledHeader( rConfiguration, rFilePath ) )
 	{
-		const std::filesystem::path DirectoryPath = rDirectory.path();
+		const std::string HeaderName = UTF8Converter().to_bytes( GetPrecompiledHeaderPath( rConfiguration ).generic_wstring() );
 
-		if( std::filesystem::exists( DirectoryPath / "um" / Target / "kernel32.lib" ) )
-			return DirectoryPath.filename();
+		Arguments.push_back( "/FI" + HeaderName );
+		Arguments.push_back( "/Yu" + HeaderName );
+		Arguments.push_back( "/Fp" + PathArgument( GetPrecompiledHeaderOutputPath( rConfiguration ) ) );
 	}
 
-	return std::wstring();
+	// Write the headers that the file includes to a JSON file
+	Arguments.push_back( "/sourceDependencies" );
+	Arguments.push_back( PathArgument( GetDependencyFilePath( OutputPath ) ) );
+
+	// Set output file
+	Arguments.push_back( "/Fo" + PathArgument( OutputPath ) );
+
+	// Set input file
+	AddInputFile( Arguments, rFilePath );
+
+	return Arguments;
 
-} // FindWindowsSDKVersion
+} // MakeCompilerArguments
 
 //////////////////////////////////////////////////////////////////////////
 
-std::wstring CompilerMSVC::MakeCompilerCommandLineString( const Configuration& rConfiguration, const std::filesystem::path& rFilePath )
+Process::Arguments CompilerMSVC::MakePreprocessorArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath, const std::filesystem::path& rOutputPath )
 {
-	const std::filesystem::path ProgramFilesX86 = FindProgramFilesX86Dir();
-	const std::filesystem::path MSVCDir         = FindMSVCDir( ProgramFilesX86 );
-	const std::wstring          Host            = GetHostString();
-	const std::wstring          Target          = GetTargetString( rConfiguration.m_Architecture.value_or( Configuration::HostArchitecture() ) );
-	UTF8Converter               UTF8;
+	const Toolchain::InfoPtr ToolchainInfo = ProbeToolchain( rConfiguration );
 
-	std::wstring CommandLine;
-	CommandLine += L"\"" + ( MSVCDir / "bin" / Host / Target / "cl.exe" ).wstring() + L"\"";
-	CommandLine += L" /nologo";
+	if( !ToolchainInfo )
+		return { };
 
-	// Compile (don't just preprocess)
-	CommandLine += L" /c";
+	Process::Arguments Arguments;
+	Arguments.push_back( PathArgument( ToolchainInfo->Executable ) );
+	Arguments.push_back( "/nologo" );
 
-	// Language-specific options
-	const auto FileExtension = rFilePath.extension();
-	if     ( FileExtension == ".c"   ) CommandLine += L" /std:c11";
-	else if( FileExtension == ".cpp" ) CommandLine += L" /std:c++latest /D _HAS_EXCEPTIONS=0";
-	else if( FileExtension == ".cxx" ) CommandLine += L" /std:c++latest /D _HAS_EXCEPTIONS=0";
-	else if( FileExtension == ".cc"  ) CommandLine += L" /std:c++latest /D _HAS_EXCEPTIONS=0";
+	// Preprocess to a file
+	Arguments.push_back( "/P" );
 
-	// Add user-defined preprocessor defines
-	for( const std::string& rDefine : rConfiguration.m_Defines )
-	{
-		CommandLine += L" /D \"" + UTF8.from_bytes( rDefine ) + L"\"";
-	}
+	// Options that affect the preprocessed output
+	AddSourceOptions( Arguments, rConfiguration, rFilePath );
 
-	// Set standard include directories
-	// TODO: Add these to the "Windows" system default configuration's m_IncludeDirs?
-	{
-		const std::wstring          WindowsSDKVersion    = FindWindowsSDKVersion( rConfiguration, ProgramFilesX86 );
-		const std::filesystem::path WindowsSDKIncludeDir = ProgramFilesX86 / "Windows Kits" / "10" / "Include" / WindowsSDKVersion;
+	// Include the contents of the precompiled header
+	if( UsesPrecompiledHeader( rConfiguration, rFilePath ) )
+		Arguments.push_back( "/FI" + UTF8Converter().to_bytes( GetPrecompiledHeaderPath( rConfiguration ).generic_wstring() ) );
 
-		CommandLine += L" /I\"" + ( MSVCDir / "include"             ).wstring() + L"\"";
-		CommandLine += L" /I\"" + ( WindowsSDKIncludeDir / "ucrt"   ).wstring() + L"\"";
-		CommandLine += L" /I\"" + ( WindowsSDKIncludeDir / "um"     ).wstring() + L"\"";
-		CommandLine += L" /I\"" + ( WindowsSDKIncludeDir / "shared" ).wstring() + L"\"";
-	}
+	// Set output file
+	Arguments.push_back( "/Fi" + PathArgument( rOutputPath ) );
 
-	// Add user-defined include directories
-	for( const std::filesystem::path& rIncludeDir : rConfiguration.m_IncludeDirs )
-	{
-		CommandLine += L" /I\"" + rIncludeDir.wstring() + L"\"";
-	}
+	// Set input file
+	AddInputFile( Arguments, rFilePath );
 
-	// Set output file
-	CommandLine += L" /Fo\"" + GetCompilerOutputPath( rConfiguration, rFilePath ).wstring() + L"\"";
+	return Arguments;
+
+} // MakePreprocessorArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+Process::Arguments CompilerMSVC::MakePrecompiledHeaderArguments( const ResolvedConfiguration& rConfiguration )
+{
+	const Toolchain::InfoPtr    ToolchainInfo = ProbeToolchain( rConfiguration );
+	const std::filesystem::path SourcePath    = GetPrecompiledHeaderSourcePath( rConfiguration );
+	const std::filesystem::path OutputPath    = GetPrecompiledHeaderOutputPath( rConfiguration );
+
+	if( !ToolchainInfo )
+		return { };
+
+	Process::Arguments Arguments;
+	Arguments.push_back( PathArgument( ToolchainInfo->Executable ) );
+	Arguments.push_back( "/nologo" );
+
+	// Compile the generated source file that includes the header
+	Arguments.push_back( "/c" );
+
+	// The precompiled header can only be used if it was built with the same options
+	AddSourceOptions( Arguments, rConfiguration, SourcePath );
+
+	// Create the precompiled header from everything up to and including the wrapper header
+	Arguments.push_back( "/Yc" + UTF8Converter().to_bytes( GetPrecompiledHeaderPath( rConfiguration ).generic_wstring() ) );
+	Arguments.push_back( "/Fp" + PathArgument( OutputPath ) );
+
+	// Write the headers that the precompiled header includes to a JSON file
+	Arguments.push_back( "/sourceDependencies" );
+	Arguments.push_back( PathArgument( GetDependencyFilePath( OutputPath ) ) );
+
+	// Set output file. This object needs to be linked with the rest of the project.
+	Arguments.push_back( "/Fo" + PathArgument( GetPrecompiledHeaderObjectPath( rConfiguration ) ) );
 
 	// Set input file
-	if     ( FileExtension == ".c"   ) CommandLine += L" /Tc \"" + rFilePath.wstring() + L"\"";
-	else if( FileExtension == ".cpp" ) CommandLine += L" /Tp \"" + rFilePath.wstring() + L"\"";
-	else if( FileExtension == ".cxx" ) CommandLine += L" /Tp \"" + rFilePath.wstring() + L"\"";
-	else if( FileExtension == ".cc"  ) CommandLine += L" /Tp \"" + rFilePath.wstring() + L"\"";
+	AddInputFile( Arguments, SourcePath );
 
-	return CommandLine;
+	return Arguments;
 
-} // MakeCompilerCommandLineString
+} // MakePrecompiledHeaderArguments
 
 //////////////////////////////////////////////////////////////////////////
 
-std::wstring CompilerMSVC::MakeLinkerCommandLineString( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind )
+Process::Arguments CompilerMSVC::MakeLinkerArguments( const ResolvedConfiguration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind )
 {
-	const std::filesystem::path ProgramFilesX86   = FindProgramFilesX86Dir();
-	const std::filesystem::path MSVCDir           = FindMSVCDir( ProgramFilesX86 );
-	const std::filesystem::path OutputPath        = GetLinkerOutputPath( rConfiguration, rOutputName, Kind );
-	const std::wstring          WindowsSDKVersion = FindWindowsSDKVersion( rConfiguration, ProgramFilesX86 );
-	const std::wstring          Host              = GetHostString();
-	const std::wstring          Target            = GetTargetString( rConfiguration.m_Architecture.value_or( Configuration::HostArchitecture() ) );
-	std::wstring                CommandLine;
+	const Toolchain::InfoPtr    ToolchainInfo = ProbeToolchain( rConfiguration );
+	const std::filesystem::path OutputPath    = GetLinkerOutputPath( rConfiguration, rOutputName, Kind );
+	Process::Arguments          Arguments;
 
-	CommandLine += L"\"" + ( MSVCDir / "bin" / Host / Target / "link.exe" ).wstring() + L"\"";
+	if( !ToolchainInfo )
+		return { };
+
+	Arguments.push_back( PathArgument( ToolchainInfo->Executable.parent_path() / "link.exe" ) );
 
 	switch( Kind )
 	{
-		case Project::Kind::Application:    { CommandLine += L" /SUBSYSTEM:CONSOLE /OUT:\"" + OutputPath.wstring() + L"\""; } break;
-		case Project::Kind::StaticLibrary:  { CommandLine += L" /LIB /OUT:\"" + OutputPath.wstring() + L"\"";               } break;
-		case Project::Kind::DynamicLibrary: { CommandLine += L" /DLL /OUT:\"" + OutputPath.wstring() + L"\"";               } break;
+		case Project::Kind::Application:    { Arguments.push_back( "/SUBSYSTEM:CONSOLE" ); } break;
+		case Project::Kind::StaticLibrary:  { Arguments.push_back( "/LIB" );               } break;
+		case Project::Kind::DynamicLibrary: { Arguments.push_back( "/DLL" );               } break;
 	}
 
+	Arguments.push_back( "/OUT:" + PathArgument( OutputPath ) );
+
 	// Add standard library paths
+	for( const std::filesystem::path& rLibraryDirectory : ToolchainInfo->SystemLibraryDirs )
 	{
-		const std::filesystem::path WindowsSDKLibraryDir = ProgramFilesX86 / "Windows Kits" / "10" / "Lib" / WindowsSDKVersion;
-
-		CommandLine += L" /LIBPATH:\"" + ( MSVCDir / "lib" / Target               ).wstring() + L"\"";
-		CommandLine += L" /LIBPATH:\"" + ( WindowsSDKLibraryDir / "um" / Target   ).wstring() + L"\"";
-		CommandLine += L" /LIBPATH:\"" + ( WindowsSDKLibraryDir / "ucrt" / Target ).wstring() + L"\"";
+		Arguments.push_back( "/LIBPATH:" + PathArgument( rLibraryDirectory ) );
 	}
 
 	// Add user-defined library paths
@@ -219,7 +309,7 @@ std::wstring CompilerMSVC::MakeLinkerCommandLineString( const Configuration& rCo
 		// Get rid of trailing slashes. It's not allowed in MSVC
 		const std::filesystem::path Path = ( rLibraryDirectory / L"NUL" ).parent_path();
 
-		CommandLine += L" /LIBPATH:\"" + Path.wstring() + L"\"";
+		Arguments.push_back( "/LIBPATH:" + PathArgument( Path ) );
 	}
 
 	// Add input files
@@ -229,24 +319,24 @@ std::wstring CompilerMSVC::MakeLinkerCommandLineString( const Configuration& rCo
 		if( !Library.has_extension() )
 			Library.replace_extension( ".lib" );
 
-		CommandLine += L" \"" + Library.wstring() + L"\"";
+		Arguments.push_back( PathArgument( Library ) );
 	}
 
 	// Add all object files
 	for( const std::filesystem::path& rInputFile : InputFiles )
 	{
-		CommandLine += L" \"" + rInputFile.wstring() + L".obj\"";
+		Arguments.push_back( PathArgument( rInputFile ) );
 	}
 
 	// Miscellaneous options
-	CommandLine += L" /NOLOGO";
+	Arguments.push_back( "/NOLOGO" );
 
 	if( rConfiguration.m_Architecture )
 	{
 		switch( *rConfiguration.m_Architecture )
 		{
 			case Configuration::Architecture::x86_64:
-				CommandLine += L" /MACHINE:x64";
+				Arguments.push_back( "/MACHINE:x64" );
 				break;
 
 			default:
@@ -254,8 +344,84 @@ std::wstring CompilerMSVC::MakeLinkerCommandLineString( const Configuration& rCo
 		}
 	}
 
-	return CommandLine;
+	return Arguments;
+
+} // MakeLinkerArguments
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::vector< std::filesystem::path > > CompilerMSVC::ReadDependencies( const std::filesystem::path& rDependencyFile )
+{
+	std::string Contents;
+	if( !BinaryIO::ReadFile( rDependencyFile, Contents ) )
+		return std::nullopt;
+
+	return DependencyGraph::ParseMSVCDependencies( Contents );
+
+} // ReadDependencies
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerMSVC::GetDependencyFilePath( const std::filesystem::path& rOutputPath )
+{
+	return std::filesystem::path( rOutputPath ) += ".json";
+
+} // GetDependencyFilePath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerMSVC::GetPrecompiledHeaderSourcePath( const Configuration& rConfiguration )
+{
+	return GetPrecompiledHeaderPath( rConfiguration ).replace_extension( ".cpp" );
+
+} // GetPrecompiledHeaderSourcePath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerMSVC::GetPrecompiledHeaderOutputPath( const Configuration& rConfiguration )
+{
+	return GetPrecompiledHeaderPath( rConfiguration ).replace_extension( ".pch" );
+
+} // GetPrecompiledHeaderOutputPath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path CompilerMSVC::GetPrecompiledHeaderObjectPath( const Configuration& rConfiguration )
+{
+	return GetPrecompiledHeaderPath( rConfiguration ).replace_extension( ".obj" );
+
+} // GetPrecompiledHeaderObjectPath
+
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticParser::LineKind CompilerMSVC::ParseDiagnostic( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) const
+{
+	// a.cpp(12,5): error C2065: 'x': undeclared identifier
+	if( const size_t Close = Line.find( "): " ); Close != std::string_view::npos )
+	{
+		const size_t Open = Line.rfind( '(', Close );
+
+		// The column may be followed by the end of a range, as in (12,5-9)
+		unsigned int LineNumber = 0;
+		unsigned int Column     = 0;
+
+		if( Open != std::string_view::npos && Open > 0 && sscanf( std::string( Line.substr( Open + 1, Close - Open - 1 ) ).c_str(), "%u,%u", &LineNumber, &Column ) >= 1 && ParseSeverity( Line.substr( Close + 3 ), rDiagnostic ) )
+		{
+			rDiagnostic.File   = Line.substr( 0, Open );
+			rDiagnostic.Line   = LineNumber;
+			rDiagnostic.Column = Column;
+			return DiagnosticParser::LineKind::Diagnostic;
+		}
+	}
+
+	// LINK : fatal error LNK1104: cannot open file 'a.lib'
+	// a.obj : error LNK2019: unresolved external symbol f referenced in function main
+	if( const size_t Separator = Line.find( " : " ); Separator != std::string_view::npos && ParseSeverity( Line.substr( Separator + 3 ), rDiagnostic ) )
+		return DiagnosticParser::LineKind::Diagnostic;
+
+	return DiagnosticParser::LineKind::Other;
 
-} // MakeLinkerCommandLineString
+} // ParseDiagnostic
 
 #endif // _WIN32
@@ -25,14 +25,30 @@ class CompilerMSVC : public ICompiler
 {
 public:
 
-	std::string_view GetName( void ) const override { return "MSVC"; }
+	std::string_view   GetName                ( void ) const override { return "MSVC"; }
+	Toolchain::InfoPtr ProbeToolchain         ( const Configuration& rConfiguration ) override;
+	Process::Arguments MakePreprocessorOptions( const Configuration& rConfiguration ) override;
 
 //////////////////////////////////////////////////////////////////////////
 
 private:
 
-	std::wstring MakeCompilerCommandLineString( const Configuration& rConfiguration, const std::filesystem::path& rFilePath ) override;
-	std::wstring MakeLinkerCommandLineString  ( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind ) override;
+	Process::Arguments MakeCompilerArguments         ( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath ) override;
+	Process::Arguments MakePreprocessorArguments     ( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath, const std::filesystem::path& rOutputPath ) override;
+	Process::Arguments MakePrecompiledHeaderArguments( const ResolvedConfiguration& rConfiguration ) override;
+	Process::Arguments MakeLinkerArguments           ( const ResolvedConfiguration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind ) override;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::optional< std::vector< std::filesystem::path > > ReadDependencies     ( const std::filesystem::path& rDependencyFile ) override;
+	std::filesystem::path                                 GetDependencyFilePath( const std::filesystem::path& rOutputPath ) override;
+	DiagnosticParser::LineKind                            ParseDiagnostic      ( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) const override;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::filesystem::path GetPrecompiledHeaderSourcePath( const Configuration& rConfiguration ) override;
+	std::filesystem::path GetPrecompiledHeaderOutputPath( const Configuration& rConfiguration ) override;
+	std::filesystem::path GetPrecompiledHeaderObjectPath( const Configuration& rConfiguration ) override;
 
 }; // CompilerMSVC
 
@@ -17,40 +17,413 @@
 
 #include "ICompiler.h"
 
+#include "Build/BinaryIO.h"
+#include "Build/BuildState.h"
+#include "Build/BuildTrace.h"
+#include "Build/CompileCache.h"
+#include "Build/WorkerPool.h"
+
+#include "Common/Async/JobSystem.h"
+#include "Common/OutputBuffer.h"
 #include "Common/Platform/Win32/Win32Error.h"
 #include "Common/Platform/Win32/Win32ProcessInfo.h"
 #include "Common/LocalAppData.h"
 #include "Common/Process.h"
+#include "Common/ProcessReactor.h"
 
+#include <chrono>
 #include <future>
+#include <iostream>
+
+//////////////////////////////////////////////////////////////////////////
+
+static void ReplaceAll( std::string& rString, std::string_view From, std::string_view To )
+{
+	if( From.empty() )
+		return;
+
+	for( size_t Position = rString.find( From ); Position != std::string::npos; Position = rString.find( From, Position + To.size() ) )
+		rString.replace( Position, From.size(), To );
+
+} // ReplaceAll
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::optional< CompileCache::Key > MakeCacheKey( const std::filesystem::path& rFilePath, const std::filesystem::path& rOutputPath, const std::filesystem::path& rPreprocessedPath, std::string CommandLine )
+{
+	// The output paths differ between the permutations of the build matrix but don't affect the contents of the object
+	UTF8Converter UTF8;
+	ReplaceAll( CommandLine, UTF8.to_bytes( rOutputPath.wstring() ), "<output>" );
+	ReplaceAll( CommandLine, UTF8.to_bytes( rFilePath.wstring() ),   "<input>" );
+
+	return CompileCache::Instance().MakeKey( rPreprocessedPath, CommandLine );
+
+} // MakeCacheKey
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ICompiler::CompileTask
+{
+	ResolvedConfiguration::Ptr            Config;
+	std::filesystem::path                 FilePath;
+	std::filesystem::path                 OutputPath;
+	std::filesystem::path                 DependencyPath;
+	Process::Arguments                    Arguments;
+	std::string                           CommandLine;
+	std::vector< BuildState::InputStamp > Stamps;
+	std::shared_ptr< BuildState >         State;
+	OutputCallback                        Callback;
+	std::optional< CompileCache::Key >    CacheKey;
+	std::optional< Process::Arguments >   RemoteArguments;
+	Process::ResourceUsage                Usage;
+	int64_t                               StartTime = 0;
+	BuildTrace::Clock::time_point         Start;
+
+}; // CompileTask
 
 //////////////////////////////////////////////////////////////////////////
 
-std::optional< std::filesystem::path > ICompiler::Compile( const Configuration& rConfiguration, const std::filesystem::path& rFilePath )
+void ICompiler::Precompile( ResolvedConfiguration::Ptr Configuration, std::shared_ptr< BuildState > State, OutputCallback Callback )
 {
-	const std::wstring CommandLine    = MakeCompilerCommandLineString( rConfiguration, rFilePath );
-	Process            CompileProcess = Process( CommandLine );
-	const int          ExitCode       = CompileProcess.ResultOf();
+	const ResolvedConfiguration&          rConfiguration = *Configuration;
+	const std::filesystem::path&          rHeader        = *rConfiguration.m_PrecompiledHeader;
+	const std::filesystem::path           HeaderPath     = GetPrecompiledHeaderPath( rConfiguration );
+	const std::filesystem::path           SourcePath     = GetPrecompiledHeaderSourcePath( rConfiguration );
+	const std::filesystem::path           OutputPath     = GetPrecompiledHeaderOutputPath( rConfiguration );
+	const std::filesystem::path           DependencyPath = GetDependencyFilePath( OutputPath );
+	const Process::Arguments              Arguments      = MakePrecompiledHeaderArguments( rConfiguration );
+	std::string                           CommandUTF8    = Process::JoinArguments( Arguments );
+	UTF8Converter                         UTF8;
+	std::vector< BuildState::InputStamp > Stamps;
 
-	if( ExitCode == 0 )
-		return GetCompilerOutputPath( rConfiguration, rFilePath );
+	// The header is included through a generated wrapper so that the precompiled output can live in the output directory
+	if( !BinaryIO::WriteFileIfChanged( HeaderPath, "#include \"" + UTF8.to_bytes( rHeader.generic_wstring() ) + "\"\n" )
+	 || ( SourcePath != HeaderPath && !BinaryIO::WriteFileIfChanged( SourcePath, "#include \"" + UTF8.to_bytes( HeaderPath.generic_wstring() ) + "\"\n" ) ) )
+	{
+		std::cerr << "Failed to write precompiled header wrapper " << HeaderPath << "\n";
+		Callback( std::nullopt );
+		return;
+	}
 
-	return std::nullopt;
+	if( auto Reason = State->Check( OutputPath, std::span( &rHeader, 1 ), CommandUTF8, Stamps ) )
+	{
+		if( rConfiguration.m_Explain.value_or( false ) )
+			std::cout << "Precompiling " << rHeader.filename() << " because " << *Reason << "\n";
+	}
+	else
+	{
+		Callback( GetPrecompiledHeaderObjectPath( rConfiguration ) );
+		return;
+	}
+
+	const int64_t   StartTime = BuildState::Now();
+	std::error_code Error;
+
+	std::filesystem::remove( OutputPath, Error );
+
+	auto Diagnostics = std::make_shared< DiagnosticParser >( MakeDiagnosticParser( rHeader ) );
+	auto Precompiled = ProcessReactor::Instance().Launch( Arguments, JobSystem::CurrentCancellationToken(), State->LastPeakMemory( OutputPath ), [ Diagnostics ]( std::string_view Line ) { Diagnostics->ParseLine( Line ); } );
+
+	JobSystem::Instance().Continue( Precompiled, [ this, Configuration, State, Callback = std::move( Callback ), Diagnostics, SourcePath, OutputPath, DependencyPath, CommandUTF8 = std::move( CommandUTF8 ), Stamps = std::move( Stamps ), StartTime ]( const ProcessReactor::Result& rResult ) mutable
+		{
+			Diagnostics->Finish();
+
+			rResult.Output.WriteTo( std::cout );
+
+			BuildTrace::Instance().Record( "precompile", OutputPath, CommandUTF8, rResult.StartTime, rResult.Usage );
+
+			if( rResult.ExitCode == 0 )
+			{
+				if( auto Dependencies = ReadDependencies( DependencyPath ) )
+				{
+					std::erase( *Dependencies, SourcePath );
+
+					State->Dependencies().SetDependencies( OutputPath, *Dependencies );
+				}
+
+				State->Update( OutputPath, std::move( Stamps ), std::move( CommandUTF8 ), StartTime, rResult.Usage );
+
+				Callback( GetPrecompiledHeaderObjectPath( *Configuration ) );
+			}
+			else
+			{
+				State->Forget( OutputPath );
+
+				Callback( std::nullopt );
+			}
+		} );
+
+} // Precompile
+
+//////////////////////////////////////////////////////////////////////////
+
+void ICompiler::Compile( ResolvedConfiguration::Ptr Configuration, const std::filesystem::path& rFilePath, std::shared_ptr< BuildState > State, OutputCallback Callback )
+{
+	const ResolvedConfiguration& rConfiguration = *Configuration;
+
+	CompileTaskPtr Task  = std::make_shared< CompileTask >();
+	Task->Config         = std::move( Configuration );
+	Task->FilePath       = rFilePath;
+	Task->OutputPath     = GetCompilerOutputPath( rConfiguration, rFilePath );
+	Task->DependencyPath = GetDependencyFilePath( Task->OutputPath );
+	Task->Arguments      = MakeCompilerArguments( rConfiguration, rFilePath );
+	Task->CommandLine    = Process::JoinArguments( Task->Arguments );
+	Task->State          = std::move( State );
+	Task->Callback       = std::move( Callback );
+
+	// Skip the compiler entirely if neither the source file nor the command line changed since the last build
+	if( auto Reason = Task->State->Check( Task->OutputPath, std::span( &rFilePath, 1 ), Task->CommandLine, Task->Stamps ) )
+	{
+		if( rConfiguration.m_Explain.value_or( false ) )
+			std::cout << "Compiling " << rFilePath.filename() << " because " << *Reason << "\n";
+	}
+	else
+	{
+		Task->Callback( Task->OutputPath );
+		return;
+	}
+
+	Task->StartTime = BuildState::Now();
+	Task->Start     = BuildTrace::Clock::now();
+
+	if( WorkerPool::Instance().HasWorkers() )
+		Task->RemoteArguments = MakeRemoteCompilerArguments( rConfiguration, rFilePath );
+
+	// The cache doesn't store the .dwo files that go along with the objects
+	const bool UseCache = CompileCache::Instance().IsEnabled() && !rConfiguration.m_SplitDebugInfo.value_or( false );
+
+	// Both the cache and the workers start from the preprocessed file
+	if( !UseCache && !Task->RemoteArguments )
+	{
+		RunCompiler( std::move( Task ) );
+		return;
+	}
+
+	std::filesystem::path PreprocessedPath = Task->OutputPath;
+	PreprocessedPath += ".i";
+
+	// The preprocessor writes the depfile, which may be hard linked into the compile cache from an earlier hit
+	std::error_code Error;
+	std::filesystem::remove( Task->DependencyPath, Error );
+
+	auto Preprocessed = ProcessReactor::Instance().Launch( MakePreprocessorArguments( rConfiguration, rFilePath, PreprocessedPath ), JobSystem::CurrentCancellationToken() );
+
+	JobSystem::Instance().Continue( Preprocessed, [ this, Task, PreprocessedPath, UseCache ]( const ProcessReactor::Result& rResult )
+		{
+			std::error_code Error;
+
+			if( rResult.ExitCode == 0 && UseCache )
+				Task->CacheKey = MakeCacheKey( Task->FilePath, Task->OutputPath, PreprocessedPath, Task->CommandLine );
+
+			if( Task->CacheKey && CompileCache::Instance().Fetch( *Task->CacheKey, Task->OutputPath, Task->DependencyPath ) )
+			{
+				std::filesystem::remove( PreprocessedPath, Error );
+
+				BuildTrace::Instance().Record( "cache", Task->OutputPath, Task->CommandLine, Task->Start );
+
+				FinishCompile( Task, true );
+			}
+			else if( rResult.ExitCode == 0 && Task->RemoteArguments )
+			{
+				RunRemoteCompiler( Task, PreprocessedPath );
+			}
+			else
+			{
+				std::filesystem::remove( PreprocessedPath, Error );
+
+				RunCompiler( Task );
+			}
+		} );
 
 } // Compile
 
 //////////////////////////////////////////////////////////////////////////
 
-std::optional< std::filesystem::path > ICompiler::Link( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind )
+void ICompiler::RunCompiler( CompileTaskPtr Task )
 {
-	const std::wstring CommandLine    = MakeLinkerCommandLineString( rConfiguration, InputFiles, rOutputName, Kind );
-	Process            LinkProcess    = Process( CommandLine );
-	const int          ExitCode       = LinkProcess.ResultOf();
+	std::error_code Error;
+
+	// The previous object and depfile may be hard linked into the compile cache. Make sure that the compiler doesn't write through them.
+	std::filesystem::remove( Task->OutputPath, Error );
+	std::filesystem::remove( Task->DependencyPath, Error );
+
+	// Diagnostics are parsed as the output arrives, so that they show up while the compiler is still running
+	auto Diagnostics = std::make_shared< DiagnosticParser >( MakeDiagnosticParser( Task->FilePath ) );
+	auto Compiled    = ProcessReactor::Instance().Launch( Task->Arguments, JobSystem::CurrentCancellationToken(), Task->State->LastPeakMemory( Task->OutputPath ), [ Diagnostics ]( std::string_view Line ) { Diagnostics->ParseLine( Line ); } );
+
+	JobSystem::Instance().Continue( Compiled, [ this, Task, Diagnostics ]( const ProcessReactor::Result& rResult )
+		{
+			Diagnostics->Finish();
+
+			// Print everything at once so that the output of parallel compiles doesn't interleave
+			rResult.Output.WriteTo( std::cout );
 
-	if( ExitCode == 0 )
-		return GetLinkerOutputPath( rConfiguration, rOutputName, Kind );
+			BuildTrace::Instance().Record( "compile", Task->OutputPath, Task->CommandLine, rResult.StartTime, rResult.Usage );
 
-	return std::nullopt;
+			Task->Usage = rResult.Usage;
+
+			const bool Success = rResult.ExitCode == 0;
+
+			if( Success && Task->CacheKey )
+				CompileCache::Instance().Store( *Task->CacheKey, Task->OutputPath, Task->DependencyPath );
+
+			FinishCompile( Task, Success );
+		} );
+
+} // RunCompiler
+
+//////////////////////////////////////////////////////////////////////////
+
+void ICompiler::RunRemoteCompiler( CompileTaskPtr Task, std::filesystem::path PreprocessedPath )
+{
+	std::error_code Error;
+	auto            Compiled = WorkerPool::Instance().Compile( *Task->RemoteArguments, PreprocessedPath, Task->OutputPath );
+
+	// Every worker is busy, so the local machine might as well do its share
+	if( !Compiled )
+	{
+		std::filesystem::remove( PreprocessedPath, Error );
+
+		RunCompiler( std::move( Task ) );
+		return;
+	}
+
+	JobSystem::Instance().Continue( *Compiled, [ this, Task, PreprocessedPath ]( const WorkerPool::Result& rResult )
+		{
+			std::error_code Error;
+			std::filesystem::remove( PreprocessedPath, Error );
+
+			if( !rResult.Delivered )
+			{
+				RunCompiler( Task );
+				return;
+			}
+
+			DiagnosticParser Diagnostics = MakeDiagnosticParser( Task->FilePath );
+			OutputBuffer     Lines( [ &Diagnostics ]( std::string_view Line ) { Diagnostics.ParseLine( Line ); } );
+
+			Lines.Append( rResult.Output );
+			Lines.Flush();
+			Diagnostics.Finish();
+
+			std::cout << rResult.Output;
+
+			BuildTrace::Instance().Record( "remote", Task->OutputPath, Task->CommandLine, rResult.StartTime, rResult.Usage );
+
+			Task->Usage = rResult.Usage;
+
+			const bool Success = rResult.ExitCode == 0;
+
+			if( Success && Task->CacheKey )
+				CompileCache::Instance().Store( *Task->CacheKey, Task->OutputPath, Task->DependencyPath );
+
+			FinishCompile( Task, Success );
+		} );
+
+} // RunRemoteCompiler
+
+//////////////////////////////////////////////////////////////////////////
+
+void ICompiler::FinishCompile( CompileTaskPtr Task, bool Success )
+{
+	if( Success )
+	{
+		if( auto Dependencies = ReadDependencies( Task->DependencyPath ) )
+		{
+			// GCC lists the source file itself as the first dependency
+			std::erase( *Dependencies, Task->FilePath );
+
+			// Objects must be rebuilt whenever the precompiled header is
+			if( UsesPrecompiledHeader( *Task->Config, Task->FilePath ) )
+				Dependencies->push_back( GetPrecompiledHeaderOutputPath( *Task->Config ) );
+
+			Task->State->Dependencies().SetDependencies( Task->OutputPath, *Dependencies );
+		}
+
+		Task->State->Update( Task->OutputPath, std::move( Task->Stamps ), Task->CommandLine, Task->StartTime, Task->Usage );
+
+		Task->Callback( Task->OutputPath );
+	}
+	else
+	{
+		Task->State->Forget( Task->OutputPath );
+
+		Task->Callback( std::nullopt );
+	}
+
+} // FinishCompile
+
+//////////////////////////////////////////////////////////////////////////
+
+DiagnosticParser ICompiler::MakeDiagnosticParser( const std::filesystem::path& rTranslationUnit ) const
+{
+	return DiagnosticParser( [ this ]( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) { return ParseDiagnostic( Line, rDiagnostic ); }, rTranslationUnit );
+
+} // MakeDiagnosticParser
+
+//////////////////////////////////////////////////////////////////////////
+
+void ICompiler::Link( ResolvedConfiguration::Ptr Configuration, std::vector< std::filesystem::path > InputFiles, std::vector< std::filesystem::path > Libraries, std::wstring OutputName, Project::Kind Kind, std::shared_ptr< BuildState > State, OutputCallback Callback )
+{
+	const ResolvedConfiguration&          rConfiguration = *Configuration;
+	const std::filesystem::path           OutputPath     = GetLinkerOutputPath( rConfiguration, OutputName, Kind );
+	const Process::Arguments              Arguments      = MakeLinkerArguments( rConfiguration, InputFiles, OutputName, Kind );
+	std::string                           CommandUTF8    = Process::JoinArguments( Arguments );
+	std::vector< std::filesystem::path >  Inputs         = std::move( InputFiles );
+	std::vector< BuildState::InputStamp > Stamps;
+
+	// The linker finds the libraries of other projects through the library directories, so they aren't on the command line. They are inputs all the same.
+	Inputs.insert( Inputs.end(), Libraries.begin(), Libraries.end() );
+
+	// Relinking is only necessary if any of the object files or libraries changed
+	if( auto Reason = State->Check( OutputPath, Inputs, CommandUTF8, Stamps ) )
+	{
+		if( rConfiguration.m_Explain.value_or( false ) )
+			std::cout << "Linking " << OutputPath.filename() << " because " << *Reason << "\n";
+	}
+	else
+	{
+		Callback( OutputPath );
+		return;
+	}
+
+	const int64_t   StartTime = BuildState::Now();
+	std::error_code Error;
+
+	// Archivers add to existing archives, which would keep stale members and can't switch between thin and regular archives
+	if( Kind == Project::Kind::StaticLibrary )
+		std::filesystem::remove( OutputPath, Error );
+
+	auto Diagnostics = std::make_shared< DiagnosticParser >( MakeDiagnosticParser( OutputPath ) );
+	auto Linked      = ProcessReactor::Instance().Launch( Arguments, JobSystem::CurrentCancellationToken(), State->LastPeakMemory( OutputPath ), [ Diagnostics ]( std::string_view Line ) { Diagnostics->ParseLine( Line ); } );
+
+	JobSystem::Instance().Continue( Linked, [ Configuration, Kind, State, Callback = std::move( Callback ), Diagnostics, OutputPath, CommandUTF8 = std::move( CommandUTF8 ), Stamps = std::move( Stamps ), StartTime ]( const ProcessReactor::Result& rResult ) mutable
+		{
+			const auto Duration = std::chrono::duration_cast< std::chrono::milliseconds >( BuildTrace::Clock::now() - rResult.StartTime );
+
+			Diagnostics->Finish();
+
+			rResult.Output.WriteTo( std::cout );
+
+			BuildTrace::Instance().Record( Kind == Project::Kind::StaticLibrary ? "archive" : "link", OutputPath, CommandUTF8, rResult.StartTime, rResult.Usage );
+
+			// Headless builds and the build daemon only print what went wrong, unless asked for more
+			if( Configuration->m_Verbose.value_or( false ) || Configuration->m_Explain.value_or( false ) )
+				std::cout << "Linking " << OutputPath.filename() << " took " << Duration.count() << " ms\n";
+
+			if( rResult.ExitCode == 0 )
+			{
+				State->Update( OutputPath, std::move( Stamps ), std::move( CommandUTF8 ), StartTime, rResult.Usage );
+
+				Callback( OutputPath );
+			}
+			else
+			{
+				State->Forget( OutputPath );
+
+				Callback( std::nullopt );
+			}
+		} );
 
 } // Link
 
@@ -58,7 +431,15 @@ std::optional< std::filesystem::path > ICompiler::Link( const Configuration& rCo
 
 std::filesystem::path ICompiler::GetCompilerOutputPath( const Configuration& rConfiguration, const std::filesystem::path& rFilePath )
 {
-	return ( *rConfiguration.m_OutputDir / rFilePath.stem() );
+	std::filesystem::path OutputFile = ( *rConfiguration.m_OutputDir / rFilePath.stem() );
+
+#if defined( _WIN32 )
+	OutputFile.replace_extension( L".obj" );
+#else // _WIN32
+	OutputFile.replace_extension( L".o" );
+#endif // !_WIN32
+
+	return OutputFile;
 
 } // GetCompilerOutputPath
 
@@ -111,3 +492,33 @@ std::filesystem::path ICompiler::GetLinkerOutputPath( const Configuration& rConf
 	return OutputFile;
 
 } // GetLinkerOutputPath
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path ICompiler::GetPrecompiledHeaderPath( const Configuration& rConfiguration )
+{
+	return ( *rConfiguration.m_OutputDir / "PCH" / rConfiguration.m_PrecompiledHeader->filename() );
+
+} // GetPrecompiledHeaderPath
+
+//////////////////////////////////////////////////////////////////////////
+
+bool ICompiler::UsesPrecompiledHeader( const Configuration& rConfiguration, const std::filesystem::path& rFilePath )
+{
+	// The precompiled header is compiled as C++, so it can't be used by C sources
+	return rConfiguration.m_PrecompiledHeader && rFilePath.extension() != ".c";
+
+} // UsesPrecompiledHeader
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string ICompiler::PathArgument( const std::filesystem::path& rPath )
+{
+
+#if defined( _WIN32 )
+	return UTF8Converter().to_bytes( rPath.wstring() );
+#else // _WIN32
+	return rPath.string();
+#endif // !_WIN32
+
+} // PathArgument
@@ -16,18 +16,25 @@
  */
 
 #pragma once
+#include "Build/Diagnostics.h"
+#include "Compilers/Toolchain.h"
 #include "Components/Configuration.h"
 #include "Components/Project.h"
 
 #include <atomic>
 #include <filesystem>
+#include <functional>
 #include <future>
 #include <span>
 #include <string_view>
 #include <string>
+#include <vector>
 
 #include <Common/Aliases.h>
 #include <Common/Macros.h>
+#include <Common/Process.h>
+
+class BuildState;
 
 class ICompiler
 {
@@ -37,28 +44,78 @@ class ICompiler
 
 public:
 
+	// Called with the output file, or nothing if it failed to build
+	using OutputCallback = std::function< void( std::optional< std::filesystem::path > ) >;
+
+//////////////////////////////////////////////////////////////////////////
+
 	         ICompiler( void ) = default;
 	virtual ~ICompiler( void ) = default;
 
 //////////////////////////////////////////////////////////////////////////
 
-	std::optional< std::filesystem::path > Compile( const Configuration& rConfiguration, const std::filesystem::path& rFilePath );
-	std::optional< std::filesystem::path > Link   ( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind );
+	// These only start the compiler or linker and return right away. The callback runs in a continuation of the current job once it exits.
+	void Precompile( ResolvedConfiguration::Ptr Configuration, std::shared_ptr< BuildState > State, OutputCallback Callback );
+	void Compile   ( ResolvedConfiguration::Ptr Configuration, const std::filesystem::path& rFilePath, std::shared_ptr< BuildState > State, OutputCallback Callback );
+	void Link      ( ResolvedConfiguration::Ptr Configuration, std::vector< std::filesystem::path > InputFiles, std::vector< std::filesystem::path > Libraries, std::wstring OutputName, Project::Kind Kind, std::shared_ptr< BuildState > State, OutputCallback Callback );
+
+//////////////////////////////////////////////////////////////////////////
+
+	virtual std::string_view   GetName       ( void ) const = 0;
+	virtual Toolchain::InfoPtr ProbeToolchain( const Configuration& rConfiguration ) = 0;
+
+	// Options for the defines and include directories, which are shared by every file that is compiled with the configuration
+	virtual Process::Arguments MakePreprocessorOptions( const Configuration& rConfiguration ) = 0;
+
+//////////////////////////////////////////////////////////////////////////
+
+	Process::Arguments CompilerArguments( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath ) { return MakeCompilerArguments( rConfiguration, rFilePath ); }
 
 //////////////////////////////////////////////////////////////////////////
 
-	virtual std::string_view GetName( void ) const = 0;
+	static std::filesystem::path GetCompilerOutputPath   ( const Configuration& rConfiguration, const std::filesystem::path& rFilePath );
+	static std::filesystem::path GetLinkerOutputPath     ( const Configuration& rConfiguration, const std::wstring& rOutputName, Project::Kind Kind );
+	static std::filesystem::path GetPrecompiledHeaderPath( const Configuration& rConfiguration );
+	static bool                  UsesPrecompiledHeader   ( const Configuration& rConfiguration, const std::filesystem::path& rFilePath );
+	static std::string           PathArgument            ( const std::filesystem::path& rPath );
 
 //////////////////////////////////////////////////////////////////////////
 
-	static std::filesystem::path GetCompilerOutputPath( const Configuration& rConfiguration, const std::filesystem::path& rFilePath );
-	static std::filesystem::path GetLinkerOutputPath  ( const Configuration& rConfiguration, const std::wstring& rOutputName, Project::Kind Kind );
+private:
+
+	struct CompileTask;
+	using  CompileTaskPtr = std::shared_ptr< CompileTask >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	void             RunCompiler         ( CompileTaskPtr Task );
+	void             RunRemoteCompiler   ( CompileTaskPtr Task, std::filesystem::path PreprocessedPath );
+	void             FinishCompile       ( CompileTaskPtr Task, bool Success );
+	DiagnosticParser MakeDiagnosticParser( const std::filesystem::path& rTranslationUnit ) const;
 
 //////////////////////////////////////////////////////////////////////////
 
 protected:
 
-	virtual std::wstring MakeCompilerCommandLineString( const Configuration& rConfiguration, const std::filesystem::path& rFilePath ) = 0;
-	virtual std::wstring MakeLinkerCommandLineString  ( const Configuration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind ) = 0;
+	virtual Process::Arguments MakeCompilerArguments         ( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath ) = 0;
+	virtual Process::Arguments MakePreprocessorArguments     ( const ResolvedConfiguration& rConfiguration, const std::filesystem::path& rFilePath, const std::filesystem::path& rOutputPath ) = 0;
+	virtual Process::Arguments MakePrecompiledHeaderArguments( const ResolvedConfiguration& rConfiguration ) = 0;
+	virtual Process::Arguments MakeLinkerArguments           ( const ResolvedConfiguration& rConfiguration, std::span< std::filesystem::path > InputFiles, const std::wstring& rOutputName, Project::Kind Kind ) = 0;
+
+	// Arguments for compiling the preprocessed file on a worker, or nothing if the file can't be compiled elsewhere. The preprocessor arguments must write
+	// the depfile then, since the worker doesn't send one back.
+	virtual std::optional< Process::Arguments > MakeRemoteCompilerArguments( const ResolvedConfiguration& /*rConfiguration*/, const std::filesystem::path& /*rFilePath*/ ) { return std::nullopt; }
+
+//////////////////////////////////////////////////////////////////////////
+
+	virtual std::optional< std::vector< std::filesystem::path > > ReadDependencies     ( const std::filesystem::path& rDependencyFile ) = 0;
+	virtual std::filesystem::path                                 GetDependencyFilePath( const std::filesystem::path& rOutputPath ) = 0;
+	virtual DiagnosticParser::LineKind                            ParseDiagnostic      ( std::string_view Line, DiagnosticStore::Diagnostic& rDiagnostic ) const = 0;
+
+//////////////////////////////////////////////////////////////////////////
+
+	virtual std::filesystem::path GetPrecompiledHeaderSourcePath( const Configuration& rConfiguration ) = 0;
+	virtual std::filesystem::path GetPrecompiledHeaderOutputPath( const Configuration& rConfiguration ) = 0;
+	virtual std::filesystem::path GetPrecompiledHeaderObjectPath( const Configuration& rConfiguration ) = 0;
 
 }; // ICompiler
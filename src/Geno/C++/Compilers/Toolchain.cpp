@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Toolchain.h"
+
+#include "Build/BinaryIO.h"
+#include "Build/BuildState.h"
+#include "Compilers/ICompiler.h"
+
+#include <Common/Aliases.h>
+#include <Common/Hash.h>
+#include <Common/LocalAppData.h>
+#include <Common/OutputBuffer.h>
+#include <Common/Process.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#endif // _WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t TOOLCHAIN_MAGIC   = 0x31435447; // "GTC1"
+constexpr uint32_t TOOLCHAIN_VERSION = 1;
+
+#if defined( _WIN32 )
+constexpr std::string_view NULL_DEVICE = "NUL";
+#else // _WIN32
+constexpr std::string_view NULL_DEVICE = "/dev/null";
+#endif // !_WIN32
+
+using namespace BinaryIO;
+
+//////////////////////////////////////////////////////////////////////////
+
+// Optional flags that the compilers may or may not understand, depending on their version
+static constexpr std::string_view GCC_OPTIONAL_FLAGS[] =
+{
+	"-gsplit-dwarf",
+	"-fdiagnostics-color=always",
+	"-fdiagnostics-format=json",
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string_view Trim( std::string_view String )
+{
+	while( !String.empty() && std::isspace( static_cast< unsigned char >( String.front() ) ) ) String.remove_prefix( 1 );
+	while( !String.empty() && std::isspace( static_cast< unsigned char >( String.back() ) ) )  String.remove_suffix( 1 );
+
+	return String;
+
+} // Trim
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::optional< Toolchain::Info > ProbeGCC( const std::filesystem::path& rExecutable )
+{
+	UTF8Converter     UTF8;
+	const std::string Compiler     = ICompiler::PathArgument( rExecutable );
+	Toolchain::Info   Info;
+	bool              InSearchList = false;
+
+	Info.Executable = rExecutable;
+
+	OutputBuffer Output( [ & ]( std::string_view Line )
+		{
+			if( InSearchList )
+			{
+				if( Line.starts_with( "End of search list." ) )
+				{
+					InSearchList = false;
+				}
+				else
+				{
+					// macOS marks framework directories with a suffix
+					if( Line.ends_with( " (framework directory)" ) )
+						Line.remove_suffix( std::string_view( " (framework directory)" ).size() );
+
+					Info.SystemIncludeDirs.push_back( std::filesystem::path( UTF8.from_bytes( std::string( Trim( Line ) ) ) ).lexically_normal() );
+				}
+			}
+			else if( Line.starts_with( "#include <...> search starts here:" ) )
+			{
+				InSearchList = true;
+			}
+			else if( Line.starts_with( "Target: " ) )
+			{
+				Info.Target = Trim( Line.substr( 8 ) );
+			}
+			else if( const size_t Version = Line.find( " version " ); Info.Version.empty() && Version != std::string_view::npos && ( Line.starts_with( "gcc" ) || Line.find( "clang" ) != std::string_view::npos ) )
+			{
+				std::string_view Number = Line.substr( Version + 9 );
+				Info.Version            = Number.substr( 0, Number.find( ' ' ) );
+			}
+		} );
+
+	if( Process( { Compiler, "-v", "-E", "-x", "c++", std::string( NULL_DEVICE ) } ).Capture( Output ) != 0 )
+		return std::nullopt;
+
+	// Ask the compiler about every flag that it might not know, so that the command lines never have to guess
+	for( std::string_view Flag : GCC_OPTIONAL_FLAGS )
+	{
+		// Only the exit code matters
+		OutputBuffer Discarded( 0 );
+
+		if( Process( { Compiler, "-Werror", std::string( Flag ), "-fsyntax-only", "-x", "c++", std::string( NULL_DEVICE ) } ).Capture( Discarded ) == 0 )
+			Info.SupportedFlags.emplace_back( Flag );
+	}
+
+	return Info;
+
+} // ProbeGCC
+
+//////////////////////////////////////////////////////////////////////////
+
+#if defined( _WIN32 )
+
+static std::wstring GetHostString( void )
+{
+	switch( Configuration::HostArchitecture() )
+	{
+		case Configuration::Architecture::x86:    return L"Hostx86";
+		case Configuration::Architecture::x86_64: return L"Hostx64";
+		default:                                  return L"Hostx64";
+	}
+
+} // GetHostString
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::wstring GetTargetString( const Configuration::Architecture Architecture )
+{
+	switch( Architecture )
+	{
+		case Configuration::Architecture::x86:    return L"x86";
+		case Configuration::Architecture::x86_64: return L"x64";
+		default:                                  return GetTargetString( Configuration::HostArchitecture() );
+	}
+
+} // GetTargetString
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::filesystem::path FindProgramFilesX86Dir( void )
+{
+	if( DWORD ProgramFilesLength = GetEnvironmentVariableW( L"ProgramFiles(x86)", nullptr, 0 ) )
+	{
+		std::wstring ProgramFilesBuffer;
+		ProgramFilesBuffer.resize( ProgramFilesLength );
+
+		GetEnvironmentVariableW( L"ProgramFiles(x86)", ProgramFilesBuffer.data(), ProgramFilesLength );
+
+		// Remove extra null-terminator
+		ProgramFilesBuffer.pop_back();
+
+		return ProgramFilesBuffer;
+	}
+
+	return std::filesystem::path();
+
+} // FindProgramFilesX86Dir
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::filesystem::path FindMSVCDir( const std::filesystem::path& rProgramFilesX86 )
+{
+	const std::filesystem::path VSWhereLocation = rProgramFilesX86 / "Microsoft Visual Studio" / "Installer" / "vswhere.exe";
+	if( std::filesystem::exists( VSWhereLocation ) )
+	{
+		// Run vswhere.exe to get the installation path of Visual Studio
+		int                Result;
+		Process            VSWhereProcess = Process( { ICompiler::PathArgument( VSWhereLocation ), "-legacy", "-prerelease", "-latest", "-property", "installationPath" } );
+		const std::wstring VSWhereOutput = VSWhereProcess.OutputOf( Result );
+		if( Result == 0 )
+		{
+			// Trim trailing newlines
+			const std::filesystem::path VisualStudioLocation( VSWhereOutput.begin(), VSWhereOutput.end() - 2 );
+			if( std::filesystem::exists( VisualStudioLocation ) )
+			{
+				for( const std::filesystem::directory_entry& rMSVCDir : std::filesystem::directory_iterator( VisualStudioLocation / "VC" / "Tools" / "MSVC" ) )
+				{
+					// Just choose the first best version
+					if( true )
+						return rMSVCDir;
+				}
+			}
+		}
+	}
+
+	return std::filesystem::path();
+
+} // FindMSVCDir
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::wstring FindWindowsSDKVersion( const std::wstring& rTarget, const std::filesystem::path& rProgramFilesX86 )
+{
+	for( const std::filesystem::directory_entry& rDirectory : std::filesystem::directory_iterator( rProgramFilesX86 / "Windows Kits" / "10" / "Lib" ) )
+	{
+		const std::filesystem::path DirectoryPath = rDirectory.path();
+
+		if( std::filesystem::exists( DirectoryPath / "um" / rTarget / "kernel32.lib" ) )
+			return DirectoryPath.filename();
+	}
+
+	return std::wstring();
+
+} // FindWindowsSDKVersion
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::optional< Toolchain::Info > ProbeMSVC( Configuration::Architecture Architecture )
+{
+	const std::filesystem::path ProgramFilesX86 = FindProgramFilesX86Dir();
+	const std::filesystem::path MSVCDir         = FindMSVCDir( ProgramFilesX86 );
+	const std::wstring          Target          = GetTargetString( Architecture );
+
+	if( MSVCDir.empty() )
+		return std::nullopt;
+
+	const std::wstring          WindowsSDKVersion    = FindWindowsSDKVersion( Target, ProgramFilesX86 );
+	const std::filesystem::path WindowsSDKIncludeDir = ProgramFilesX86 / "Windows Kits" / "10" / "Include" / WindowsSDKVersion;
+	const std::filesystem::path WindowsSDKLibraryDir = ProgramFilesX86 / "Windows Kits" / "10" / "Lib" / WindowsSDKVersion;
+	Toolchain::Info             Info;
+
+	Info.Executable = MSVCDir / "bin" / GetHostString() / Target / "cl.exe";
+	Info.Version    = MSVCDir.filename().string();
+	Info.Target     = UTF8Converter().to_bytes( Target );
+
+	Info.SystemIncludeDirs.push_back( MSVCDir / "include" );
+	Info.SystemIncludeDirs.push_back( WindowsSDKIncludeDir / "ucrt" );
+	Info.SystemIncludeDirs.push_back( WindowsSDKIncludeDir / "um" );
+	Info.SystemIncludeDirs.push_back( WindowsSDKIncludeDir / "shared" );
+
+	Info.SystemLibraryDirs.push_back( MSVCDir / "lib" / Target );
+	Info.SystemLibraryDirs.push_back( WindowsSDKLibraryDir / "um" / Target );
+	Info.SystemLibraryDirs.push_back( WindowsSDKLibraryDir / "ucrt" / Target );
+
+	return Info;
+
+} // ProbeMSVC
+
+#endif // _WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Toolchain::Info::Supports( std::string_view Flag ) const
+{
+	return std::find( SupportedFlags.begin(), SupportedFlags.end(), Flag ) != SupportedFlags.end();
+
+} // Supports
+
+//////////////////////////////////////////////////////////////////////////
+
+Toolchain::Toolchain( void )
+{
+	if( !LocalAppData::Instance().Path().empty() )
+		m_Path = LocalAppData::Instance().Path() / "Toolchains";
+
+} // Toolchain
+
+//////////////////////////////////////////////////////////////////////////
+
+Toolchain::InfoPtr Toolchain::GCC( std::string_view Program )
+{
+	const std::filesystem::path Executable = FindProgram( UTF8Converter().from_bytes( Program.data(), Program.data() + Program.size() ) );
+
+	if( Executable.empty() )
+		return nullptr;
+
+	return Find( "GCC " + std::string( Program ), Executable, [ & ]( void ) { return ProbeGCC( Executable ); } );
+
+} // GCC
+
+//////////////////////////////////////////////////////////////////////////
+
+Toolchain::InfoPtr Toolchain::MSVC( Configuration::Architecture Target )
+{
+
+#if defined( _WIN32 )
+
+	// The compiler can only be found by asking the Visual Studio installer, so any cached compiler that still exists is trusted
+	return Find( "MSVC " + std::string( Reflection::EnumToString( Target ) ), std::filesystem::path(), [ & ]( void ) { return ProbeMSVC( Target ); } );
+
+#else // _WIN32
+
+	( void )Target;
+
+	return nullptr;
+
+#endif // !_WIN32
+
+} // MSVC
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< uint64_t > Toolchain::Identity( std::string_view Program )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	auto It = m_Identities.find( std::string( Program ) );
+	if( It != m_Identities.end() )
+		return It->second;
+
+	const std::optional< uint64_t > Identity = ExecutableIdentity( FindProgram( UTF8Converter().from_bytes( Program.data(), Program.data() + Program.size() ) ) );
+
+	m_Identities.emplace( std::string( Program ), Identity );
+
+	return Identity;
+
+} // Identity
+
+//////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path Toolchain::FindProgram( const std::filesystem::path& rProgram )
+{
+	if( rProgram.has_parent_path() )
+		return rProgram;
+
+#if defined( _WIN32 )
+	constexpr char PATH_SEPARATOR = ';';
+#else // _WIN32
+	constexpr char PATH_SEPARATOR = ':';
+#endif // !_WIN32
+
+	const char* pPath = getenv( "PATH" );
+	if( pPath == nullptr )
+		return std::filesystem::path();
+
+	std::string_view Directories = pPath;
+
+	while( !Directories.empty() )
+	{
+		const size_t                Separator = Directories.find( PATH_SEPARATOR );
+		const std::filesystem::path Directory = Directories.substr( 0, Separator );
+		std::error_code             Error;
+
+		if( std::filesystem::is_regular_file( Directory / rProgram, Error ) )
+			return Directory / rProgram;
+
+	#if defined( _WIN32 )
+		if( std::filesystem::is_regular_file( ( Directory / rProgram ).replace_extension( ".exe" ), Error ) )
+			return ( Directory / rProgram ).replace_extension( ".exe" );
+	#endif // _WIN32
+
+		if( Separator == std::string_view::npos )
+			break;
+
+		Directories.remove_prefix( Separator + 1 );
+	}
+
+	return std::filesystem::path();
+
+} // FindProgram
+
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< uint64_t > Toolchain::ExecutableIdentity( const std::filesystem::path& rExecutable )
+{
+	std::error_code Error;
+
+	// Upgrading the compiler changes its size or modification time
+	if( const uint64_t Size = std::filesystem::file_size( rExecutable, Error ); !Error )
+		return Hash::Combine( Hash::Combine( Hash::FNV1a( rExecutable.generic_string() ), Size ), static_cast< uint64_t >( BuildState::FileTime( rExecutable ) ) );
+
+	return std::nullopt;
+
+} // ExecutableIdentity
+
+//////////////////////////////////////////////////////////////////////////
+
+template< typename Probe >
+Toolchain::InfoPtr Toolchain::Find( const std::string& rKey, const std::filesystem::path& rExecutable, Probe&& rrProbe )
+{
+	std::scoped_lock Lock( m_Mutex );
+
+	if( auto Checked = m_CheckedInfos.find( rKey ); Checked != m_CheckedInfos.end() )
+		return Checked->second;
+
+	Load();
+
+	// Reuse the previous probe as long as it describes the very same executable
+	if( auto Cached = m_Infos.find( rKey ); Cached != m_Infos.end() )
+	{
+		const Info& rInfo = *Cached->second;
+
+		if( ( rExecutable.empty() || rInfo.Executable == rExecutable ) && ExecutableIdentity( rInfo.Executable ) == rInfo.Identity )
+			return m_CheckedInfos.emplace( rKey, Cached->second ).first->second;
+	}
+
+	std::optional< Info > Probed = rrProbe();
+	InfoPtr               Result;
+
+	if( Probed )
+	{
+		if( auto Identity = ExecutableIdentity( Probed->Executable ) )
+		{
+			Probed->Identity = *Identity;
+			Result           = std::make_shared< const Info >( std::move( *Probed ) );
+			m_Infos[ rKey ]  = Result;
+
+			Save();
+		}
+	}
+
+	if( !Result )
+		std::cerr << "Failed to probe toolchain '" << rKey << "'\n";
+
+	m_CheckedInfos.emplace( rKey, Result );
+
+	return Result;
+
+} // Find
+
+//////////////////////////////////////////////////////////////////////////
+
+void Toolchain::Load( void )
+{
+	if( m_Loaded || m_Path.empty() )
+		return;
+
+	m_Loaded = true;
+
+	std::string FileBuffer;
+	if( !ReadFile( m_Path, FileBuffer ) )
+		return;
+
+	std::string_view Buffer = FileBuffer;
+	uint32_t         Magic;
+	uint32_t         Version;
+	uint32_t         NumInfos;
+
+	if( !ReadValue( Buffer, Magic ) || Magic != TOOLCHAIN_MAGIC || !ReadValue( Buffer, Version ) || Version != TOOLCHAIN_VERSION || !ReadValue( Buffer, NumInfos ) )
+		return;
+
+	UTF8Converter UTF8;
+
+	auto ReadPaths = [ & ]( std::vector< std::filesystem::path >& rPaths )
+	{
+		uint32_t NumPaths;
+		if( !ReadValue( Buffer, NumPaths ) )
+			return false;
+
+		for( uint32_t i = 0; i < NumPaths; ++i )
+		{
+			std::string Path;
+			if( !ReadString( Buffer, Path ) )
+				return false;
+
+			rPaths.emplace_back( UTF8.from_bytes( Path ) );
+		}
+
+		return true;
+	};
+
+	for( uint32_t i = 0; i < NumInfos; ++i )
+	{
+		std::string Key;
+		std::string Executable;
+		Info        Info;
+		uint32_t    NumFlags;
+
+		if( !ReadString( Buffer, Key ) || !ReadString( Buffer, Executable ) || !ReadValue( Buffer, Info.Identity ) || !ReadString( Buffer, Info.Version ) || !ReadString( Buffer, Info.Target )
+		 || !ReadPaths( Info.SystemIncludeDirs ) || !ReadPaths( Info.SystemLibraryDirs ) || !ReadValue( Buffer, NumFlags ) )
+			break;
+
+		for( uint32_t j = 0; j < NumFlags; ++j )
+		{
+			if( !ReadString( Buffer, Info.SupportedFlags.emplace_back() ) )
+				return;
+		}
+
+		Info.Executable = UTF8.from_bytes( Executable );
+
+		m_Infos.emplace( std::move( Key ), std::make_shared< const Toolchain::Info >( std::move( Info ) ) );
+	}
+
+} // Load
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Toolchain::Save( void )
+{
+	if( m_Path.empty() )
+		return false;
+
+	UTF8Converter UTF8;
+	std::string   Buffer;
+
+	WriteValue( Buffer, TOOLCHAIN_MAGIC );
+	WriteValue( Buffer, TOOLCHAIN_VERSION );
+	WriteValue( Buffer, static_cast< uint32_t >( m_Infos.size() ) );
+
+	auto WritePaths = [ & ]( const std::vector< std::filesystem::path >& rPaths )
+	{
+		WriteValue( Buffer, static_cast< uint32_t >( rPaths.size() ) );
+
+		for( const std::filesystem::path& rPath : rPaths )
+			WriteString( Buffer, UTF8.to_bytes( rPath.wstring() ) );
+	};
+
+	for( const auto& [ rKey, rInfo ] : m_Infos )
+	{
+		WriteString( Buffer, rKey );
+		WriteString( Buffer, UTF8.to_bytes( rInfo->Executable.wstring() ) );
+		WriteValue ( Buffer, rInfo->Identity );
+		WriteString( Buffer, rInfo->Version );
+		WriteString( Buffer, rInfo->Target );
+		WritePaths ( rInfo->SystemIncludeDirs );
+		WritePaths ( rInfo->SystemLibraryDirs );
+		WriteValue ( Buffer, static_cast< uint32_t >( rInfo->SupportedFlags.size() ) );
+
+		for( const std::string& rFlag : rInfo->SupportedFlags )
+			WriteString( Buffer, rFlag );
+	}
+
+	return WriteFile( m_Path, Buffer );
+
+} // Save
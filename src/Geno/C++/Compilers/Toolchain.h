@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include "Components/Configuration.h"
+
+#include <Common/Macros.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Toolchain
+{
+	GENO_SINGLETON( Toolchain );
+
+	Toolchain( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	struct Info
+	{
+		std::filesystem::path                Executable;
+		uint64_t                             Identity = 0; // Identity of the executable at the time that it was probed
+		std::string                          Version;
+		std::string                          Target;
+		std::vector< std::filesystem::path > SystemIncludeDirs;
+		std::vector< std::filesystem::path > SystemLibraryDirs;
+		std::vector< std::string >           SupportedFlags;
+
+		bool Supports( std::string_view Flag ) const;
+
+	}; // Info
+
+	using InfoPtr = std::shared_ptr< const Info >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	InfoPtr                   GCC     ( std::string_view Program );
+	InfoPtr                   MSVC    ( Configuration::Architecture Target );
+	std::optional< uint64_t > Identity( std::string_view Program );
+
+//////////////////////////////////////////////////////////////////////////
+
+	static std::filesystem::path     FindProgram       ( const std::filesystem::path& rProgram );
+	static std::optional< uint64_t > ExecutableIdentity( const std::filesystem::path& rExecutable );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	template< typename Probe >
+	InfoPtr Find( const std::string& rKey, const std::filesystem::path& rExecutable, Probe&& rrProbe );
+
+//////////////////////////////////////////////////////////////////////////
+
+	void Load( void );
+	bool Save( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::unordered_map< std::string, InfoPtr >                   m_Infos;
+	std::unordered_map< std::string, InfoPtr >                   m_CheckedInfos;
+	std::unordered_map< std::string, std::optional< uint64_t > > m_Identities;
+	std::filesystem::path                                        m_Path;
+	std::mutex                                                   m_Mutex;
+
+	bool                                                         m_Loaded = false;
+
+}; // Toolchain
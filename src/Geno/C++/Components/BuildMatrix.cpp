@@ -23,6 +23,7 @@
 #include <Common/Intrinsics.h>
 
 #include <algorithm>
+#include <cctype>
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -52,6 +53,29 @@ void BuildMatrix::NewConfiguration( std::string_view WhichColumn, std::string Co
 
 //////////////////////////////////////////////////////////////////////////
 
+bool BuildMatrix::Select( std::string_view WhichColumn, std::string_view Configuration )
+{
+	for( Column& rColumn : m_Columns )
+	{
+		if( rColumn.Name != WhichColumn )
+			continue;
+
+		for( size_t i = 0; i < rColumn.Configurations.size(); ++i )
+		{
+			if( rColumn.Configurations[ i ].first == Configuration )
+			{
+				rColumn.CurrentConfiguration = static_cast< int32_t >( i );
+				return true;
+			}
+		}
+	}
+
+	return false;
+
+} // Select
+
+//////////////////////////////////////////////////////////////////////////
+
 Configuration BuildMatrix::CurrentConfiguration( void ) const
 {
 	Configuration Result;
@@ -73,6 +97,41 @@ Configuration BuildMatrix::CurrentConfiguration( void ) const
 
 //////////////////////////////////////////////////////////////////////////
 
+BuildMatrix::ConfigurationVector BuildMatrix::Permutations( void ) const
+{
+	ConfigurationVector Result = { NamedConfiguration() };
+
+	// Expand the cross product one column at a time. Empty columns would erase every permutation, so they are skipped.
+	for( const Column& rColumn : m_Columns )
+	{
+		if( rColumn.Configurations.empty() )
+			continue;
+
+		ConfigurationVector Expanded;
+		Expanded.reserve( Result.size() * rColumn.Configurations.size() );
+
+		for( const auto&[ rPrefix, rBase ] : Result )
+		{
+			for( const auto&[ rName, rConfiguration ] : rColumn.Configurations )
+			{
+				auto&[ rExpandedName, rExpandedConfiguration ] = Expanded.emplace_back( rPrefix.empty() ? rName : ( rPrefix + "-" + rName ), rBase );
+				rExpandedConfiguration.Override( rConfiguration );
+			}
+		}
+
+		Result = std::move( Expanded );
+	}
+
+	// The names double as directory names
+	for( auto&[ rName, rConfiguration ] : Result )
+		std::replace_if( rName.begin(), rName.end(), []( char Char ) { return !std::isalnum( static_cast< unsigned char >( Char ) ) && Char != '-' && Char != '_'; }, '_' );
+
+	return Result;
+
+} // Permutations
+
+//////////////////////////////////////////////////////////////////////////
+
 BuildMatrix BuildMatrix::PlatformDefault( void )
 {
 	BuildMatrix Matrix;
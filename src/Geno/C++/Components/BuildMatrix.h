@@ -54,9 +54,11 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-	void          NewColumn           ( std::string Name );
-	void          NewConfiguration    ( std::string_view WhichColumn, std::string Configuration );
-	Configuration CurrentConfiguration( void ) const;
+	void                NewColumn           ( std::string Name );
+	void                NewConfiguration    ( std::string_view WhichColumn, std::string Configuration );
+	bool                Select              ( std::string_view WhichColumn, std::string_view Configuration );
+	Configuration       CurrentConfiguration( void ) const;
+	ConfigurationVector Permutations        ( void ) const;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -17,20 +17,72 @@
 
 #include "Configuration.h"
 
+#include "Compilers/ICompiler.h"
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Appends the values that aren't in the list yet, keeping the order that they first appeared in
+template< typename T >
+static void AppendUnique( std::vector< T >& rValues, const std::vector< T >& rOther )
+{
+	for( const T& rValue : rOther )
+	{
+		if( std::find( rValues.begin(), rValues.end(), rValue ) == rValues.end() )
+			rValues.push_back( rValue );
+	}
+
+} // AppendUnique
+
+//////////////////////////////////////////////////////////////////////////
+
+// Removes all but the first occurrence of every value
+template< typename T >
+static void RemoveDuplicates( std::vector< T >& rValues )
+{
+	auto End = rValues.begin();
+
+	for( auto It = rValues.begin(); It != rValues.end(); ++It )
+	{
+		if( std::find( rValues.begin(), End, *It ) != End )
+			continue;
+
+		if( End != It )
+			*End = std::move( *It );
+
+		++End;
+	}
+
+	rValues.erase( End, rValues.end() );
+
+} // RemoveDuplicates
+
 //////////////////////////////////////////////////////////////////////////
 
 void Configuration::Override( const Configuration& rOther )
 {
-	if( rOther.m_Compiler     ) m_Compiler     = rOther.m_Compiler;
-	if( rOther.m_Architecture ) m_Architecture = rOther.m_Architecture;
-	if( rOther.m_Optimization ) m_Optimization = rOther.m_Optimization;
-	if( rOther.m_OutputDir    ) m_OutputDir    = rOther.m_OutputDir;
-	if( rOther.m_Verbose      ) m_Verbose      = rOther.m_Verbose;
+	if( rOther.m_Compiler          ) m_Compiler          = rOther.m_Compiler;
+	if( rOther.m_Architecture      ) m_Architecture      = rOther.m_Architecture;
+	if( rOther.m_Optimization      ) m_Optimization      = rOther.m_Optimization;
+	if( rOther.m_Linker            ) m_Linker            = rOther.m_Linker;
+	if( rOther.m_OutputDir         ) m_OutputDir         = rOther.m_OutputDir;
+	if( rOther.m_PrecompiledHeader ) m_PrecompiledHeader = rOther.m_PrecompiledHeader;
+	if( rOther.m_UnityBatchSize    ) m_UnityBatchSize    = rOther.m_UnityBatchSize;
+	if( rOther.m_KeepGoing         ) m_KeepGoing         = rOther.m_KeepGoing;
+	if( rOther.m_UnityBuild        ) m_UnityBuild        = rOther.m_UnityBuild;
+	if( rOther.m_ThinArchives      ) m_ThinArchives      = rOther.m_ThinArchives;
+	if( rOther.m_SplitDebugInfo    ) m_SplitDebugInfo    = rOther.m_SplitDebugInfo;
+	if( rOther.m_Verbose           ) m_Verbose           = rOther.m_Verbose;
+	if( rOther.m_Explain           ) m_Explain           = rOther.m_Explain;
+
+	AppendUnique( m_IncludeDirs, rOther.m_IncludeDirs );
+	AppendUnique( m_LibraryDirs, rOther.m_LibraryDirs );
+	AppendUnique( m_Libraries,   rOther.m_Libraries );
+	AppendUnique( m_Defines,     rOther.m_Defines );
 
-	for( auto& rIncludeDir : rOther.m_IncludeDirs ) m_IncludeDirs.push_back( rIncludeDir );
-	for( auto& rLibraryDir : rOther.m_LibraryDirs ) m_LibraryDirs.push_back( rLibraryDir );
-	for( auto& rLibrary    : rOther.m_Libraries   ) m_Libraries  .push_back( rLibrary );
-	for( auto& rDefine     : rOther.m_Defines     ) m_Defines    .push_back( rDefine );
+	// Flags are appended even if they are already there, since a later flag may undo an earlier one
+	m_CompilerFlags.insert( m_CompilerFlags.end(), rOther.m_CompilerFlags.begin(), rOther.m_CompilerFlags.end() );
 
 } // Override
 
@@ -50,3 +102,42 @@ Configuration::Architecture Configuration::HostArchitecture( void )
 #endif // _M_ARM || __arm__
 
 } // HostArchitecture
+
+//////////////////////////////////////////////////////////////////////////
+
+ResolvedConfiguration::ResolvedConfiguration( Configuration Base )
+	: Configuration( std::move( Base ) )
+{
+	for( std::filesystem::path& rIncludeDir : m_IncludeDirs )
+		rIncludeDir = rIncludeDir.lexically_normal();
+
+	for( std::filesystem::path& rLibraryDir : m_LibraryDirs )
+		rLibraryDir = rLibraryDir.lexically_normal();
+
+	// The lists may have picked up duplicates from the settings of a project. Those would only make every command line longer.
+	RemoveDuplicates( m_IncludeDirs );
+	RemoveDuplicates( m_LibraryDirs );
+	RemoveDuplicates( m_Libraries );
+	RemoveDuplicates( m_Defines );
+
+	if( m_Compiler )
+		m_PreprocessorOptions = m_Compiler->MakePreprocessorOptions( *this );
+
+} // ResolvedConfiguration
+
+//////////////////////////////////////////////////////////////////////////
+
+ResolvedConfiguration::Ptr ResolvedConfiguration::WithOverrides( const Configuration& rOverrides ) const
+{
+	Configuration Combined = *this;
+	Combined.Override( rOverrides );
+
+	// The precompiled header is built with the options of the project, and compilers reject it or miscompile when the options of a file differ
+	const bool SameCodeGeneration = Combined.m_Optimization == m_Optimization && Combined.m_CompilerFlags == m_CompilerFlags && Combined.m_Defines == m_Defines;
+
+	if( !SameCodeGeneration )
+		Combined.m_PrecompiledHeader.reset();
+
+	return Make( std::move( Combined ) );
+
+} // WithOverrides
@@ -17,10 +17,13 @@
 
 #pragma once
 #include <Common/Macros.h>
+#include <Common/Process.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 class ICompiler;
@@ -38,6 +41,7 @@ public:
 
 	enum class Optimization
 	{
+		Off,
 		FavorSize,
 		FavorSpeed,
 		Full,
@@ -53,6 +57,16 @@ public:
 
 	}; // Architecture
 
+	enum class Linker
+	{
+		Default,
+		BFD,
+		Gold,
+		LLD,
+		Mold,
+
+	}; // Linker
+
 //////////////////////////////////////////////////////////////////////////
 
 	Configuration( void ) = default;
@@ -72,15 +86,65 @@ public:
 	std::vector< std::filesystem::path >   m_LibraryDirs;
 	std::vector< std::string >             m_Libraries;
 	std::vector< std::string >             m_Defines;
+	std::vector< std::string >             m_CompilerFlags;
 	std::optional< Optimization >          m_Optimization;
 	std::optional< Architecture >          m_Architecture;
+	std::optional< Linker >                m_Linker;
 	std::optional< std::filesystem::path > m_OutputDir;
+	std::optional< std::filesystem::path > m_PrecompiledHeader;
+	std::optional< uint32_t >              m_UnityBatchSize;
+	std::optional< uint32_t >              m_KeepGoing;
+	std::optional< bool >                  m_UnityBuild;
+	std::optional< bool >                  m_ThinArchives;
+	std::optional< bool >                  m_SplitDebugInfo;
 	std::optional< bool >                  m_Verbose;
+	std::optional< bool >                  m_Explain;
 
 }; // Configuration
 
 //////////////////////////////////////////////////////////////////////////
 
+// The configuration of a project for a single build, after the workspace configuration and the build matrix were merged into it. It never changes
+// once it is made, so every job of the project shares the same one.
+class ResolvedConfiguration : public Configuration
+{
+	GENO_DISABLE_COPY_AND_MOVE( ResolvedConfiguration );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	using Ptr = std::shared_ptr< const ResolvedConfiguration >;
+
+//////////////////////////////////////////////////////////////////////////
+
+	explicit ResolvedConfiguration( Configuration Base );
+
+//////////////////////////////////////////////////////////////////////////
+
+	static Ptr Make( Configuration Base ) { return std::make_shared< const ResolvedConfiguration >( std::move( Base ) ); }
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Resolves this configuration again with the overrides of a file filter or a single file on top. Files whose optimization, flags or defines
+	// differ from this configuration don't use its precompiled header.
+	Ptr WithOverrides( const Configuration& rOverrides ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Defines and include directories as the compiler wants them. These are the same for every file of the project, so they are only made once.
+	const Process::Arguments& PreprocessorOptions( void ) const { return m_PreprocessorOptions; }
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	Process::Arguments m_PreprocessorOptions;
+
+}; // ResolvedConfiguration
+
+//////////////////////////////////////////////////////////////////////////
+
 namespace Reflection
 {
 	constexpr std::string_view EnumToString( Configuration::Architecture Value )
@@ -102,6 +166,7 @@ namespace Reflection
 	{
 		switch( Value )
 		{
+			case Configuration::Optimization::Off:        return "Off";
 			case Configuration::Optimization::FavorSize:  return "FavorSize";
 			case Configuration::Optimization::FavorSpeed: return "FavorSpeed";
 			case Configuration::Optimization::Full:       return "Full";
@@ -110,6 +175,22 @@ namespace Reflection
 
 	} // EnumToString
 
+//////////////////////////////////////////////////////////////////////////
+
+	constexpr std::string_view EnumToString( Configuration::Linker Value )
+	{
+		switch( Value )
+		{
+			case Configuration::Linker::Default: return "Default";
+			case Configuration::Linker::BFD:     return "BFD";
+			case Configuration::Linker::Gold:    return "Gold";
+			case Configuration::Linker::LLD:     return "LLD";
+			case Configuration::Linker::Mold:    return "Mold";
+			default:                             return "Unknown";
+		}
+
+	} // EnumToString
+
 //////////////////////////////////////////////////////////////////////////
 
 	constexpr void EnumFromString( std::string_view String, Configuration::Architecture& rValue )
@@ -125,10 +206,23 @@ namespace Reflection
 
 	constexpr void EnumFromString( std::string_view String, Configuration::Optimization& rValue )
 	{
-		if(      String == "FavorSize"  ) rValue = Configuration::Optimization::FavorSize;
+		if(      String == "Off"        ) rValue = Configuration::Optimization::Off;
+		else if( String == "FavorSize"  ) rValue = Configuration::Optimization::FavorSize;
 		else if( String == "FavorSpeed" ) rValue = Configuration::Optimization::FavorSpeed;
 		else if( String == "Full"       ) rValue = Configuration::Optimization::Full;
 
 	} // EnumFromString
 
+//////////////////////////////////////////////////////////////////////////
+
+	constexpr void EnumFromString( std::string_view String, Configuration::Linker& rValue )
+	{
+		if(      String == "Default" ) rValue = Configuration::Linker::Default;
+		else if( String == "BFD"     ) rValue = Configuration::Linker::BFD;
+		else if( String == "Gold"    ) rValue = Configuration::Linker::Gold;
+		else if( String == "LLD"     ) rValue = Configuration::Linker::LLD;
+		else if( String == "Mold"    ) rValue = Configuration::Linker::Mold;
+
+	} // EnumFromString
+
 } // Reflection
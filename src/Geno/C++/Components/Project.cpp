@@ -17,17 +17,138 @@
 
 #include "Project.h"
 
+#include "Build/BinaryIO.h"
+#include "Build/BuildState.h"
 #include "Compilers/ICompiler.h"
 
 #include <GCL/Deserializer.h>
 #include <GCL/Serializer.h>
-#include "GUI/Widgets/StatusBar.h"
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iostream>
 
 //////////////////////////////////////////////////////////////////////////
 
+static uint64_t FileSize( const std::filesystem::path& rFile )
+{
+	std::error_code Error;
+	const uintmax_t Size = std::filesystem::file_size( rFile, Error );
+
+	return Error ? 0 : static_cast< uint64_t >( Size );
+
+} // FileSize
+
+//////////////////////////////////////////////////////////////////////////
+
+// Only the settings that may differ between the files of a project can be overridden for a filter or a file
+static GCL::Object SerializeOverrides( std::string Name, const Configuration& rConfiguration, const std::filesystem::path& rLocation )
+{
+	GCL::Object Overrides( std::move( Name ), std::in_place_type< GCL::Object::TableType > );
+
+	if( rConfiguration.m_Optimization )
+	{
+		GCL::Object Optimization( "Optimization" );
+		Optimization.SetString( std::string( Reflection::EnumToString( *rConfiguration.m_Optimization ) ) );
+		Overrides.AddChild( std::move( Optimization ) );
+	}
+
+	if( !rConfiguration.m_CompilerFlags.empty() )
+	{
+		GCL::Object CompilerFlags( "CompilerFlags", std::in_place_type< GCL::Object::TableType > );
+
+		for( const std::string& rFlag : rConfiguration.m_CompilerFlags )
+			CompilerFlags.AddChild( GCL::Object( rFlag ) );
+
+		Overrides.AddChild( std::move( CompilerFlags ) );
+	}
+
+	if( !rConfiguration.m_IncludeDirs.empty() )
+	{
+		GCL::Object IncludeDirs( "IncludeDirs", std::in_place_type< GCL::Object::TableType > );
+
+		for( const std::filesystem::path& rIncludeDir : rConfiguration.m_IncludeDirs )
+			IncludeDirs.AddChild( GCL::Object( rIncludeDir.lexically_relative( rLocation ).string() ) );
+
+		Overrides.AddChild( std::move( IncludeDirs ) );
+	}
+
+	if( !rConfiguration.m_Defines.empty() )
+	{
+		GCL::Object Defines( "Defines", std::in_place_type< GCL::Object::TableType > );
+
+		for( const std::string& rDefine : rConfiguration.m_Defines )
+			Defines.AddChild( GCL::Object( rDefine ) );
+
+		Overrides.AddChild( std::move( Defines ) );
+	}
+
+	return Overrides;
+
+} // SerializeOverrides
+
+//////////////////////////////////////////////////////////////////////////
+
+static Configuration DeserializeOverrides( const GCL::Object& rObject, const std::filesystem::path& rLocation )
+{
+	Configuration Overrides;
+
+	if( !rObject.IsTable() )
+		return Overrides;
+
+	for( const GCL::Object& rChild : rObject.Table() )
+	{
+		std::string_view Name = rChild.Name();
+
+		if( Name == "Optimization" && rChild.IsString() )
+		{
+			Reflection::EnumFromString( rChild.String(), Overrides.m_Optimization.emplace() );
+		}
+		else if( Name == "CompilerFlags" && rChild.IsTable() )
+		{
+			for( const GCL::Object& rFlagObj : rChild.Table() )
+				Overrides.m_CompilerFlags.emplace_back( rFlagObj.Name() );
+		}
+		else if( Name == "IncludeDirs" && rChild.IsTable() )
+		{
+			for( const GCL::Object& rIncludeDirObj : rChild.Table() )
+			{
+				std::filesystem::path IncludeDir = rIncludeDirObj.Name();
+
+				if( !IncludeDir.is_absolute() )
+					IncludeDir = rLocation / IncludeDir;
+
+				Overrides.m_IncludeDirs.emplace_back( IncludeDir.lexically_normal() );
+			}
+		}
+		else if( Name == "Defines" && rChild.IsTable() )
+		{
+			for( const GCL::Object& rDefineObj : rChild.Table() )
+				Overrides.m_Defines.emplace_back( rDefineObj.Name() );
+		}
+	}
+
+	return Overrides;
+
+} // DeserializeOverrides
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Project::IsSourceFile( const std::filesystem::path& rFile )
+{
+	const std::filesystem::path Extension = rFile.extension();
+
+	return ( Extension == ".c"
+	      || Extension == ".cc"
+	      || Extension == ".cpp"
+	      || Extension == ".cxx"
+	      || Extension == ".c++" );
+
+} // IsSourceFile
+
+//////////////////////////////////////////////////////////////////////////
+
 Project::Project( std::filesystem::path Location )
 	: m_Location( std::move( Location ) )
 	, m_Name    ( "MyProject" )
@@ -53,6 +174,8 @@ Project& Project::operator=( Project&& rrOther )
 	m_Location           = std::move( rrOther.m_Location );
 	m_Name               = std::move( rrOther.m_Name );
 	m_FileFilters        = std::move( rrOther.m_FileFilters );
+	m_NonUnityFiles      = std::move( rrOther.m_NonUnityFiles );
+	m_FileConfigurations = std::move( rrOther.m_FileConfigurations );
 
 	rrOther.m_Kind       = Kind::Unspecified;
 
@@ -62,54 +185,169 @@ Project& Project::operator=( Project&& rrOther )
 
 //////////////////////////////////////////////////////////////////////////
 
-void Project::Build( void )
+Project::BuildJobs Project::Build( ResolvedConfiguration::Ptr Config, std::shared_ptr< BuildState > State, std::shared_ptr< CancellationToken > Token ) const
 {
 	UTF8Converter UTF8Converter;
+	BuildJobs     Jobs;
+
+	// The records of the previous build tell which files are up-to-date and can be skipped
+	Jobs.State = std::move( State );
+
+	// Every compile job of the project depends on the precompiled header
+	std::vector< JobSystem::JobPtr > PrecompiledHeaderJobs;
+	auto                             PrecompiledHeaderReady = std::make_shared< bool >( !Config->m_PrecompiledHeader );
 
-	if( !m_LocalConfiguration.m_OutputDir )
-		m_LocalConfiguration.m_OutputDir = m_Location;
+	if( Config->m_PrecompiledHeader && Config->m_Compiler )
+	{
+		auto Output = std::make_shared< std::filesystem::path >();
+
+		Jobs.CompilerOutputs.push_back( Output );
 
-	Configuration Config = m_LocalConfiguration;
+		PrecompiledHeaderJobs.push_back( JobSystem::Instance().NewJob(
+			[Config, Output, PrecompiledHeaderReady, State = Jobs.State, Token]( void )
+			{
+				// The compile jobs wait until the header has been precompiled, without holding on to the worker in the meantime
+				Config->m_Compiler->Precompile( Config, State, [ Config, Output, PrecompiledHeaderReady, Token ]( std::optional< std::filesystem::path > Result )
+					{
+						if( Result )
+						{
+							*Output                 = std::move( *Result );
+							*PrecompiledHeaderReady = true;
+						}
+						else
+						{
+							std::cerr << "Failed to precompile " << *Config->m_PrecompiledHeader << "\n";
+
+							Token->ReportFailure();
+						}
+					} );
+			},
+			{ },
+			{ },
+			Token
+		) );
+
+		Jobs.LinkerDependencies.push_back( PrecompiledHeaderJobs.back() );
+	}
+
+	auto AddCompileJob = [ & ]( const std::filesystem::path& rFile, uint64_t Size, ResolvedConfiguration::Ptr FileConfig )
+	{
+		auto       Output                = std::make_shared< std::filesystem::path >();
+		const bool UsesPrecompiledHeader = ICompiler::UsesPrecompiledHeader( *FileConfig, rFile );
+		Job::Cost  Cost;
+
+		// Schedule by how long the file took to compile last time
+		Cost.Duration = Jobs.State->LastDuration( ICompiler::GetCompilerOutputPath( *FileConfig, rFile ) );
+		Cost.Size     = Size;
+
+		Jobs.CompilerOutputs.push_back( Output );
+
+		Jobs.LinkerDependencies.push_back( JobSystem::Instance().NewJob(
+			[Config = std::move( FileConfig ), rFile, Output, UsesPrecompiledHeader, PrecompiledHeaderReady, State = Jobs.State, Token]( void )
+			{
+				if( !Config->m_Compiler )
+				{
+					std::cerr << "Failed to compile " << rFile << ". No compiler active!\n";
+					Token->ReportFailure();
+					return;
+				}
+
+				// The build has already failed, but the object would be missing from the link without a word
+				if( UsesPrecompiledHeader && !*PrecompiledHeaderReady )
+				{
+					std::cerr << "Skipping " << rFile.filename() << " because the precompiled header failed\n";
+					return;
+				}
+
+				// The compiler runs in the background. The job finishes once it exits, without holding on to the worker.
+				Config->m_Compiler->Compile( Config, rFile, State, [ Output, Token ]( std::optional< std::filesystem::path > Result )
+					{
+						if( Result )
+							*Output = std::move( *Result );
+						else
+							Token->ReportFailure();
+					} );
+			},
+			UsesPrecompiledHeader ? std::span( PrecompiledHeaderJobs ) : std::span< JobSystem::JobPtr >( ),
+			Cost,
+			Token
+		) );
+	};
 
 	// Build Project
 
+	const bool UnityBuild = Config->m_UnityBuild.value_or( false );
+
 	for( const FileFilter& rFileFilter : m_FileFilters )
 	{
+		const ResolvedConfiguration::Ptr     FilterConfig = FilterConfiguration( Config, rFileFilter );
+		std::vector< std::filesystem::path > UnitySources;
+
 		for( const std::filesystem::path& rFile : rFileFilter.Files )
 		{
-			auto Extension = rFile.extension();
-
 			// Skip any files that shouldn't be compiled
 			// TODO: We want to support other languages in the future. Perhaps store the compiler in each file-config?
-			if( Extension != ".c"
-			 && Extension != ".cc"
-			 && Extension != ".cpp"
-			 && Extension != ".cxx"
-			 && Extension != ".c++" )
+			if( !IsSourceFile( rFile ) )
 				continue;
 
-			auto Output = std::make_shared< std::filesystem::path >();
+			// Files with settings of their own are compiled on their own
+			if( m_FileConfigurations.contains( rFile ) )
+				AddCompileJob( rFile, FileSize( rFile ), FileConfiguration( FilterConfig, rFile ) );
+			// C sources can't be amalgamated with C++ sources
+			else if( UnityBuild && rFile.extension() != ".c" && std::find( m_NonUnityFiles.begin(), m_NonUnityFiles.end(), rFile ) == m_NonUnityFiles.end() )
+				UnitySources.push_back( rFile );
+			else
+				AddCompileJob( rFile, FileSize( rFile ), FilterConfig );
+		}
 
-			m_CompilerOutputs.push_back( Output );
+		if( UnitySources.empty() )
+			continue;
 
-			m_LinkerDependencies.push_back( JobSystem::Instance().NewJob(
-				[Config, rFile, Output]( void )
-				{
-					if( !Config.m_Compiler )
-					{
-						std::cerr << "Failed to compile " << rFile << ". No compiler active!\n";
-						return;
-					}
+		// Sort the sources so that the generated files stay identical between builds
+		std::sort( UnitySources.begin(), UnitySources.end() );
 
-					if( auto Result = Config.m_Compiler->Compile( Config, rFile ) )
-					{
-						*Output = *Result;
-					}
-				}
-			) );
+		const size_t BatchSize = Config->m_UnityBatchSize.value_or( 0 ) > 0 ? *Config->m_UnityBatchSize : UnitySources.size();
+		std::string  BaseName  = m_Name + "_" + ( rFileFilter.Name.empty() ? std::string( "Files" ) : rFileFilter.Name.string() );
+
+		std::replace_if( BaseName.begin(), BaseName.end(), []( char Char ) { return !std::isalnum( static_cast< unsigned char >( Char ) ); }, '_' );
+
+		for( size_t Begin = 0, Index = 0; Begin < UnitySources.size(); Begin += BatchSize, ++Index )
+		{
+			const size_t End = std::min( Begin + BatchSize, UnitySources.size() );
+
+			if( End - Begin == 1 )
+			{
+				AddCompileJob( UnitySources[ Begin ], FileSize( UnitySources[ Begin ] ), FilterConfig );
+				continue;
+			}
+
+			const std::filesystem::path UnityFile = *Config->m_OutputDir / "Unity" / ( BaseName + "_" + std::to_string( Index ) + ".cpp" );
+			std::string                 Contents  = "// Generated unity source. Do not edit.\n";
+			uint64_t                    Size      = 0;
+
+			for( size_t i = Begin; i < End; ++i )
+			{
+				Contents += "#include \"" + UTF8Converter.to_bytes( UnitySources[ i ].generic_wstring() ) + "\"\n";
+				Size     += FileSize( UnitySources[ i ] );
+			}
+
+			if( BinaryIO::WriteFileIfChanged( UnityFile, Contents ) )
+			{
+				AddCompileJob( UnityFile, Size, FilterConfig );
+			}
+			else
+			{
+				std::cerr << "Failed to write " << UnityFile << ". Compiling its sources individually.\n";
+
+				for( size_t i = Begin; i < End; ++i )
+					AddCompileJob( UnitySources[ i ], FileSize( UnitySources[ i ] ), FilterConfig );
+			}
 		}
 	}
-}
+
+	return Jobs;
+
+} // Build
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -186,6 +424,9 @@ bool Project::Serialize( void )
 					FileFilter.AddChild( std::move( Files ) );
 				}
 
+				if( rFileFilter.LocalConfiguration )
+					FileFilter.AddChild( SerializeOverrides( "Configuration", *rFileFilter.LocalConfiguration, m_Location ) );
+
 				Filters.AddChild( std::move( FileFilter ) );
 			}
 		}
@@ -211,6 +452,32 @@ bool Project::Serialize( void )
 		}
 	}
 
+	// Files that can't be part of a unity build
+	if( !m_NonUnityFiles.empty() )
+	{
+		GCL::Object NonUnityFiles( "NonUnityFiles", std::in_place_type< GCL::Object::TableType > );
+
+		for( const std::filesystem::path& rFile : m_NonUnityFiles )
+		{
+			const std::filesystem::path RelativePath = rFile.lexically_relative( m_Location );
+
+			NonUnityFiles.AddChild( GCL::Object( RelativePath.string() ) );
+		}
+
+		Serializer.WriteObject( NonUnityFiles );
+	}
+
+	// Settings of single files
+	if( !m_FileConfigurations.empty() )
+	{
+		GCL::Object FileConfigurations( "FileConfigurations", std::in_place_type< GCL::Object::TableType > );
+
+		for( const auto& [ rFile, rConfiguration ] : m_FileConfigurations )
+			FileConfigurations.AddChild( SerializeOverrides( rFile.lexically_relative( m_Location ).string(), rConfiguration, m_Location ) );
+
+		Serializer.WriteObject( FileConfigurations );
+	}
+
 	// Include directories
 	if( !m_LocalConfiguration.m_IncludeDirs.empty() )
 	{
@@ -254,6 +521,15 @@ bool Project::Serialize( void )
 		Serializer.WriteObject( Defines );
 	}
 
+	// Precompiled header
+	if( m_LocalConfiguration.m_PrecompiledHeader )
+	{
+		GCL::Object PrecompiledHeader( "PrecompiledHeader" );
+		PrecompiledHeader.SetString( m_LocalConfiguration.m_PrecompiledHeader->lexically_relative( m_Location ).string() );
+
+		Serializer.WriteObject( PrecompiledHeader );
+	}
+
 	// Libraries
 	if( !m_LocalConfiguration.m_Libraries.empty() )
 	{
@@ -626,6 +902,30 @@ std::vector< std::filesystem::path > Project::FindSourceFolders( void )
 
 //////////////////////////////////////////////////////////////////////////
 
+ResolvedConfiguration::Ptr Project::FilterConfiguration( const ResolvedConfiguration::Ptr& rConfiguration, const FileFilter& rFileFilter ) const
+{
+	// Filters without settings of their own share the configuration of the project
+	if( !rFileFilter.LocalConfiguration )
+		return rConfiguration;
+
+	return rConfiguration->WithOverrides( *rFileFilter.LocalConfiguration );
+
+} // FilterConfiguration
+
+//////////////////////////////////////////////////////////////////////////
+
+ResolvedConfiguration::Ptr Project::FileConfiguration( const ResolvedConfiguration::Ptr& rFilterConfiguration, const std::filesystem::path& rFile ) const
+{
+	auto It = m_FileConfigurations.find( rFile );
+	if( It == m_FileConfigurations.end() )
+		return rFilterConfiguration;
+
+	return rFilterConfiguration->WithOverrides( It->second );
+
+} // FileConfiguration
+
+//////////////////////////////////////////////////////////////////////////
+
 void Project::GCLObjectCallback( GCL::Object Object, void* pUser )
 {
 	Project*         pSelf = static_cast< Project* >( pUser );
@@ -673,6 +973,10 @@ void Project::GCLObjectCallback( GCL::Object Object, void* pUser )
 						FileFilter.Files.emplace_back( std::move( FilePath ) );
 					}
 				}
+				else if( FileFilterObjectName == "Configuration" )
+				{
+					FileFilter.LocalConfiguration = DeserializeOverrides( rFileFilterObject, pSelf->m_Location );
+				}
 			}
 
 			pSelf->m_FileFilters.emplace_back( std::move( FileFilter ) );
@@ -697,6 +1001,31 @@ void Project::GCLObjectCallback( GCL::Object Object, void* pUser )
 			pFileFilter->Files.emplace_back( std::move( FilePath ) );
 		}
 	}
+	else if( Name == "NonUnityFiles" )
+	{
+		for( const GCL::Object& rFilePathObj : Object.Table() )
+		{
+			std::filesystem::path FilePath = rFilePathObj.Name();
+
+			if( !FilePath.is_absolute() )
+				FilePath = pSelf->m_Location / FilePath;
+
+			FilePath = FilePath.lexically_normal();
+			pSelf->m_NonUnityFiles.emplace_back( std::move( FilePath ) );
+		}
+	}
+	else if( Name == "FileConfigurations" )
+	{
+		for( const GCL::Object& rFileObj : Object.Table() )
+		{
+			std::filesystem::path FilePath = rFileObj.Name();
+
+			if( !FilePath.is_absolute() )
+				FilePath = pSelf->m_Location / FilePath;
+
+			pSelf->m_FileConfigurations[ FilePath.lexically_normal() ] = DeserializeOverrides( rFileObj, pSelf->m_Location );
+		}
+	}
 	else if( Name == "IncludeDirs" )
 	{
 		for( const GCL::Object& rFilePathObj : Object.Table() )
@@ -737,5 +1066,14 @@ void Project::GCLObjectCallback( GCL::Object Object, void* pUser )
 			pSelf->m_LocalConfiguration.m_Libraries.emplace_back( rLibraryObj.Name() );
 		}
 	}
+	else if( Name == "PrecompiledHeader" )
+	{
+		std::filesystem::path FilePath = Object.String();
+
+		if( !FilePath.is_absolute() )
+			FilePath = pSelf->m_Location / FilePath;
+
+		pSelf->m_LocalConfiguration.m_PrecompiledHeader = FilePath.lexically_normal();
+	}
 
 } // GCLObjectCallback
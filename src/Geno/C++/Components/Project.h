@@ -24,8 +24,12 @@
 #include <Common/Async/JobSystem.h>
 
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 
+class BuildState;
 class ICompiler;
 
 struct FileFilter
@@ -33,6 +37,7 @@ struct FileFilter
 	std::filesystem::path                Name;
 	std::filesystem::path                Path;
 	std::vector< std::filesystem::path > Files;
+	std::optional< Configuration >       LocalConfiguration;
 
 }; // FileFilter
 
@@ -53,11 +58,22 @@ public:
 
 	}; // Kind
 
+	struct BuildJobs
+	{
+		std::vector< JobSystem::JobPtr >                        LinkerDependencies;
+		std::vector< std::shared_ptr< std::filesystem::path > > CompilerOutputs;
+		std::shared_ptr< BuildState >                           State;
+
+	}; // BuildJobs
 
 //////////////////////////////////////////////////////////////////////////
 
 	static constexpr std::string_view EXTENSION = ".gprj";
 
+//////////////////////////////////////////////////////////////////////////
+
+	static bool IsSourceFile( const std::filesystem::path& rFile );
+
 //////////////////////////////////////////////////////////////////////////
 
 	explicit Project( std::filesystem::path Location );
@@ -67,25 +83,28 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-	void Build      ( void );
-	bool Serialize  ( void );
-	bool Deserialize( void );
+	BuildJobs Build      ( ResolvedConfiguration::Ptr Config, std::shared_ptr< BuildState > State, std::shared_ptr< CancellationToken > Token ) const;
+	bool      Serialize  ( void );
+	bool      Deserialize( void );
 
 //////////////////////////////////////////////////////////////////////////
 
-	void                                                     SortFileFilters   ( void );
-	FileFilter*                                              NewFileFilter     ( const std::filesystem::path& Name );
-	void                                                     RemoveFileFilter  ( const std::filesystem::path& Name );
-	FileFilter*                                              FileFilterByName  ( const std::filesystem::path& Name );
-	std::filesystem::path                                    FileInFileFilter  ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter );
-	void                                                     RenameFileFilter  ( const std::filesystem::path& rFileFilter, const std::string& rName );
-	bool                                                     NewFile           ( const std::filesystem::path& rPath, const std::filesystem::path& rFileFilter );
-	bool                                                     AddFile           ( const std::filesystem::path& rPath, const std::filesystem::path& rFileFilter );
-	void                                                     RemoveFile        ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter );
-	void                                                     RenameFile        ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter, const std::string& rName );
-	std::vector< JobSystem::JobPtr >&                        LinkerDependencies( void ) { return m_LinkerDependencies; }
-	std::vector< std::shared_ptr< std::filesystem::path > >& CompilerOutputs   ( void ) { return m_CompilerOutputs; }
-	std::vector< std::filesystem::path >                     FindSourceFolders ( void );
+	void                                 SortFileFilters  ( void );
+	FileFilter*                          NewFileFilter    ( const std::filesystem::path& Name );
+	void                                 RemoveFileFilter ( const std::filesystem::path& Name );
+	FileFilter*                          FileFilterByName ( const std::filesystem::path& Name );
+	std::filesystem::path                FileInFileFilter ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter );
+	void                                 RenameFileFilter ( const std::filesystem::path& rFileFilter, const std::string& rName );
+	bool                                 NewFile          ( const std::filesystem::path& rPath, const std::filesystem::path& rFileFilter );
+	bool                                 AddFile          ( const std::filesystem::path& rPath, const std::filesystem::path& rFileFilter );
+	void                                 RemoveFile       ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter );
+	void                                 RenameFile       ( const std::filesystem::path& rFile, const std::filesystem::path& rFileFilter, const std::string& rName );
+	std::vector< std::filesystem::path > FindSourceFolders( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	ResolvedConfiguration::Ptr FilterConfiguration( const ResolvedConfiguration::Ptr& rConfiguration, const FileFilter& rFileFilter ) const;
+	ResolvedConfiguration::Ptr FileConfiguration  ( const ResolvedConfiguration::Ptr& rFilterConfiguration, const std::filesystem::path& rFile ) const;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -97,14 +116,16 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-	Kind                                                    m_Kind = Kind::Application;
-	Configuration                                           m_LocalConfiguration;
+	Kind                                 m_Kind = Kind::Application;
+	Configuration                        m_LocalConfiguration;
+
+	std::filesystem::path                m_Location;
+	std::string                          m_Name;
+	std::vector< FileFilter >            m_FileFilters;
+	std::vector< std::filesystem::path > m_NonUnityFiles;
 
-	std::filesystem::path                                   m_Location;
-	std::string                                             m_Name;
-	std::vector< FileFilter >                               m_FileFilters;
-	std::vector< JobSystem::JobPtr >                        m_LinkerDependencies;
-	std::vector< std::shared_ptr< std::filesystem::path > > m_CompilerOutputs;
+	// Settings for single files that take precedence over those of the project, its filter and the workspace
+	std::map< std::filesystem::path, Configuration > m_FileConfigurations;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -17,10 +17,15 @@
 
 #include "Workspace.h"
 
+#include "Build/BuildState.h"
+#include "Build/BuildTrace.h"
+#include "Build/CompileCache.h"
+#include "Build/Diagnostics.h"
 #include "Compilers/CompilerGCC.h"
 #include "Compilers/CompilerMSVC.h"
-#include "GUI/Widgets/StatusBar.h"
 
+#include <charconv>
+#include <functional>
 #include <iostream>
 
 #include <Common/Async/JobSystem.h>
@@ -40,98 +45,380 @@ Workspace::Workspace( std::filesystem::path Location )
 
 void Workspace::Build( void )
 {
-	if( !m_Projects.empty() )
+	if( !m_Projects.empty() && !IsBuilding() )
 	{
-		UTF8Converter                            UTF8Converter;
-		std::vector< JobSystem::JobPtr >         LinkerJobs;
-		std::vector< std::string >               LinkerJobProjectNames;
-		std::shared_ptr< std::filesystem::path > LinkerOutput = std::make_shared< std::filesystem::path >();
-
-		// Sort projects so that the link jobs exist to be depended upon
-		std::vector< std::reference_wrapper< Project > > ProjectRefs;
-		std::copy( m_Projects.begin(), m_Projects.end(), std::back_inserter( ProjectRefs ) );
-		std::sort( ProjectRefs.begin(), ProjectRefs.end(), []( const Project& rA, const Project& rB )
-			{
-				auto& rLibraries = rB.m_LocalConfiguration.m_Libraries;
-				return std::find( rLibraries.begin(), rLibraries.end(), rA.m_Name ) != rLibraries.end();
-			}
-		);
+		const Configuration Configuration = m_BuildMatrix.CurrentConfiguration();
+		PendingBuild        Build         = BeginBuild( Configuration );
+
+		ScheduleBuild( Configuration, "", nullptr, Build );
+		ScheduleBuildFinished( std::move( Build ), Configuration.m_OutputDir.value_or( m_Location ) );
+	}
+
+} // Build
+
+//////////////////////////////////////////////////////////////////////////
+
+void Workspace::BuildAllPermutations( void )
+{
+	if( !m_Projects.empty() && !IsBuilding() )
+	{
+		const Configuration Configuration = m_BuildMatrix.CurrentConfiguration();
+		PendingBuild        Build         = BeginBuild( Configuration );
+
+		// Every permutation goes into the same job graph so that no core idles while one configuration links
+		for( const auto&[ rName, rConfiguration ] : m_BuildMatrix.Permutations() )
+			ScheduleBuild( rConfiguration, rName, nullptr, Build );
+
+		ScheduleBuildFinished( std::move( Build ), Configuration.m_OutputDir.value_or( m_Location ) );
+	}
+
+} // BuildAllPermutations
+
+//////////////////////////////////////////////////////////////////////////
+
+void Workspace::BuildProject( std::string_view Name )
+{
+	const Project* pProject = ProjectByName( Name );
+
+	if( pProject && !IsBuilding() )
+	{
+		const Configuration Configuration = m_BuildMatrix.CurrentConfiguration();
+		PendingBuild        Build         = BeginBuild( Configuration );
+
+		// Only the projects that the target links with are built along with it
+		ScheduleBuild( Configuration, "", pProject, Build );
+		ScheduleBuildFinished( std::move( Build ), Configuration.m_OutputDir.value_or( m_Location ) );
+	}
+
+} // BuildProject
+
+//////////////////////////////////////////////////////////////////////////
+
+void Workspace::CancelBuild( void )
+{
+	if( auto Token = m_BuildCancellationToken.lock() )
+	{
+		std::cout << "Stopping build\n";
+
+		Token->Cancel();
+	}
+
+} // CancelBuild
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Workspace::IsBuilding( void ) const
+{
+	// The final job of a build is released by the job system once it has run
+	return !m_BuildFinishedJob.expired();
+
+} // IsBuilding
+
+
+//////////////////////////////////////////////////////////////////////////
+
+Workspace::PendingBuild Workspace::BeginBuild( const Configuration& rConfiguration )
+{
+	PendingBuild Build;
+
+	// Stop at the first failure unless the configuration says to keep going
+	Build.Token              = std::make_shared< CancellationToken >( rConfiguration.m_KeepGoing.value_or( 1 ) );
+	m_BuildCancellationToken = Build.Token;
+
+	BuildTrace::Instance().Begin();
+	DiagnosticStore::Instance().Clear();
+
+	return Build;
+
+} // BeginBuild
 
+//////////////////////////////////////////////////////////////////////////
+
+std::optional< std::vector< size_t > > Workspace::SortProjects( const std::vector< std::vector< size_t > >& rDependencies, std::optional< size_t > Target ) const
+{
+	enum class Mark
+	{
+		Unvisited,
+		Visiting,
+		Visited,
+
+	}; // Mark
+
+	std::vector< Mark >             Marks( rDependencies.size(), Mark::Unvisited );
+	std::vector< size_t >           Path;
+	std::vector< size_t >           Order;
+	std::function< bool( size_t ) > Visit = [ & ]( size_t Index )
+	{
+		if( Marks[ Index ] == Mark::Visited )
+			return true;
+
+		// The path leads back to a project that is still waiting for its dependencies
+		if( Marks[ Index ] == Mark::Visiting )
+		{
+			std::cerr << "Projects depend on each other in a cycle: ";
+
+			for( auto It = std::find( Path.begin(), Path.end(), Index ); It != Path.end(); ++It )
+				std::cerr << m_Projects[ *It ].m_Name << " -> ";
+
+			std::cerr << m_Projects[ Index ].m_Name << "\n";
 
-		for( Project& rProject : ProjectRefs )
+			return false;
+		}
+
+		Marks[ Index ] = Mark::Visiting;
+		Path.push_back( Index );
+
+		for( size_t Dependency : rDependencies[ Index ] )
 		{
-			//std::cout << "=== Building Project: " << rProject.m_Name << " ===\n";
+			if( !Visit( Dependency ) )
+				return false;
+		}
+
+		Path.pop_back();
+		Marks[ Index ] = Mark::Visited;
+		Order.push_back( Index );
 
-			Configuration                                           Configuration = m_BuildMatrix.CurrentConfiguration();
-			std::vector< std::shared_ptr< std::filesystem::path > > CompilerOutputs;
+		return true;
+	};
 
-			rProject.m_LocalConfiguration.Override( Configuration );
+	if( Target )
+	{
+		if( !Visit( *Target ) )
+			return std::nullopt;
+	}
+	else
+	{
+		for( size_t i = 0; i < rDependencies.size(); ++i )
+		{
+			if( !Visit( i ) )
+				return std::nullopt;
+		}
+	}
 
-			// Build Project
-			rProject.Build();
+	return Order;
 
-			// Override the workspace config, as the project config could of changed
-			Configuration.Override( rProject.m_LocalConfiguration );
+} // SortProjects
 
-			// Set project compiler outputs
-			CompilerOutputs = rProject.CompilerOutputs();
+//////////////////////////////////////////////////////////////////////////
 
-			// Assemble a list of link jobs for projects that this depends on
-			for( std::string& rLibrary : Configuration.m_Libraries )
+void Workspace::ScheduleBuild( const Configuration& rConfiguration, const std::string& rPermutation, const Project* pTarget, PendingBuild& rBuild )
+{
+	UTF8Converter                             UTF8Converter;
+	std::vector< Configuration >              Configurations;
+	std::vector< std::vector< size_t > >      Dependencies( m_Projects.size() );
+	std::unordered_map< std::string, size_t > ProjectIndices;
+	std::shared_ptr< std::filesystem::path >  LinkerOutput = rBuild.LinkerOutputs.emplace_back( std::make_shared< std::filesystem::path >() );
+
+	Configurations.reserve( m_Projects.size() );
+
+	for( size_t i = 0; i < m_Projects.size(); ++i )
+	{
+		const Project& rProject = m_Projects[ i ];
+
+		// Combine the project and workspace configurations without touching the project's own settings
+		Configuration& rProjectConfiguration = Configurations.emplace_back( rProject.m_LocalConfiguration );
+		rProjectConfiguration.Override( rConfiguration );
+
+		// Permutations are built side by side, so each one gets a directory of its own
+		if( !rPermutation.empty() )
+			rProjectConfiguration.m_OutputDir = rProjectConfiguration.m_OutputDir.value_or( rProject.m_Location ) / rPermutation;
+		else if( !rProjectConfiguration.m_OutputDir )
+			rProjectConfiguration.m_OutputDir = rProject.m_Location;
+
+		ProjectIndices.emplace( rProject.m_Name, i );
+	}
+
+	// A project depends on every project of the workspace that it links with. Libraries outside of the workspace are left to the linker.
+	for( size_t i = 0; i < m_Projects.size(); ++i )
+	{
+		for( const std::string& rLibrary : Configurations[ i ].m_Libraries )
+		{
+			auto It = ProjectIndices.find( rLibrary );
+			if( It != ProjectIndices.end() && std::find( Dependencies[ i ].begin(), Dependencies[ i ].end(), It->second ) == Dependencies[ i ].end() )
+				Dependencies[ i ].push_back( It->second );
+		}
+	}
+
+	const std::optional< std::vector< size_t > > Order = SortProjects( Dependencies, pTarget ? std::optional< size_t >( ProjectIndices[ pTarget->m_Name ] ) : std::nullopt );
+
+	if( !Order )
+	{
+		rBuild.Token->ReportFailure();
+		return;
+	}
+
+	// The output of the build is that of a project which nothing else depends on, preferably an application
+	size_t Primary = Order->back();
+
+	if( !pTarget )
+	{
+		std::vector< bool > IsDependency( m_Projects.size(), false );
+
+		for( size_t Index : *Order )
+			for( size_t Dependency : Dependencies[ Index ] )
+				IsDependency[ Dependency ] = true;
+
+		for( size_t Index : *Order )
+		{
+			if( !IsDependency[ Index ] && m_Projects[ Index ].m_Kind == Project::Kind::Application )
+				Primary = Index;
+		}
+	}
+
+	std::vector< JobSystem::JobPtr >     LinkerJobs( m_Projects.size() );
+	std::vector< std::filesystem::path > LinkerOutputs( m_Projects.size() );
+
+	for( size_t Index : *Order )
+	{
+		const Project& rProject      = m_Projects[ Index ];
+		Configuration  Configuration = Configurations[ Index ];
+
+		// Wait for the link jobs of the projects that this links with. Dependencies always come first in the order, so those jobs exist.
+		// Archivers never read the libraries of a static library, so those are archived in parallel.
+		std::vector< JobSystem::JobPtr >     DependencyJobs;
+		std::vector< std::filesystem::path > Libraries;
+
+		if( rProject.m_Kind != Project::Kind::StaticLibrary )
+		{
+			for( size_t Dependency : Dependencies[ Index ] )
 			{
-				auto Name = std::find( LinkerJobProjectNames.begin(), LinkerJobProjectNames.end(), rLibrary );
-				if( Name != LinkerJobProjectNames.end() )
-					rProject.LinkerDependencies().push_back( *std::next( LinkerJobs.begin(), std::distance( LinkerJobProjectNames.begin(), Name ) ) );
+				DependencyJobs.push_back( LinkerJobs[ Dependency ] );
+
+				// Find the library where this permutation put it
+				Configuration.m_LibraryDirs.push_back( *Configurations[ Dependency ].m_OutputDir );
+
+				// A library that was rebuilt has to be linked again, even if none of the objects of this project changed
+				if( m_Projects[ Dependency ].m_Kind != Project::Kind::Application )
+					Libraries.push_back( LinkerOutputs[ Dependency ] );
 			}
+		}
 
-			const std::wstring  ProjectName = UTF8Converter.from_bytes( rProject.m_Name );
-			const Project::Kind Kind        = rProject.m_Kind;
+		// Every job of the project shares the configuration from here on
+		const ResolvedConfiguration::Ptr Resolved  = ResolvedConfiguration::Make( std::move( Configuration ) );
+		const std::filesystem::path      StatePath = ( *Resolved->m_OutputDir / rProject.m_Name ).replace_extension( BuildState::EXTENSION );
+		Project::BuildJobs               Jobs      = rProject.Build( Resolved, AcquireBuildState( StatePath ), rBuild.Token );
 
-			LinkerJobProjectNames.push_back( rProject.m_Name );
+		Jobs.LinkerDependencies.insert( Jobs.LinkerDependencies.end(), DependencyJobs.begin(), DependencyJobs.end() );
 
-			// Push a new job with the projects link job and linker dependencies
-			LinkerJobs.push_back( JobSystem::Instance().NewJob(
-				[ Configuration, ProjectName, Kind, CompilerOutputs, LinkerOutput ]( void )
-				{
-					std::vector< std::filesystem::path > InputFiles;
+		const std::wstring                                      ProjectName     = UTF8Converter.from_bytes( rProject.m_Name );
+		const Project::Kind                                     Kind            = rProject.m_Kind;
+		std::vector< std::shared_ptr< std::filesystem::path > > CompilerOutputs = std::move( Jobs.CompilerOutputs );
+		std::shared_ptr< BuildState >                           State           = std::move( Jobs.State );
+		std::shared_ptr< std::filesystem::path >                Output          = ( Index == Primary ) ? LinkerOutput : nullptr;
 
-					for( auto& rInputFile : CompilerOutputs )
-						if( !rInputFile->empty() )
-							InputFiles.emplace_back( std::move( *rInputFile ) );
+		rBuild.States.push_back( State );
 
-					if( !InputFiles.empty() )
-					{
-						if( auto Result = Configuration.m_Compiler->Link( Configuration, InputFiles, ProjectName, Kind ) )
-							*LinkerOutput = *Result;
-					}
-				},
-				rProject.LinkerDependencies()
-			) );
-
-			//std::cout << "=== Done building '" << rProject.m_Name << "' Output -> "  << Configuration.m_Compiler->GetLinkerOutputPath( Configuration, ProjectName, rProject.m_Kind ).string() << " === \n";
-		}
+		// The link job is the tail of every critical path through the project
+		LinkerOutputs[ Index ] = ICompiler::GetLinkerOutputPath( *Resolved, ProjectName, Kind );
+
+		Job::Cost LinkerCost;
+		LinkerCost.Duration = State->LastDuration( LinkerOutputs[ Index ] );
 
-		JobSystem::Instance().NewJob(
-			[ this, LinkerJobs, LinkerOutput ]( void )
+		// Push a new job with the projects link job and linker dependencies
+		LinkerJobs[ Index ] = JobSystem::Instance().NewJob(
+			[ Resolved, ProjectName, Kind, CompilerOutputs, Libraries, Output, State, Token = rBuild.Token ]( void )
 			{
-				if( auto& rLinkerOutput = *LinkerOutput; !rLinkerOutput.empty() )
-				{
-					std::cout << "Done building workspace\n";
+				std::vector< std::filesystem::path > InputFiles;
 
-					Events.BuildFinished( *this, rLinkerOutput, true );
-				}
-				else
-				{
-					std::cout << "Failed to build workspace\n";
+				for( auto& rInputFile : CompilerOutputs )
+					if( !rInputFile->empty() )
+						InputFiles.emplace_back( std::move( *rInputFile ) );
+
+				if( InputFiles.empty() )
+					return;
 
-					Events.BuildFinished( *this, "", false );
-				}
+				// The linker runs in the background. The job finishes once it exits, without holding on to the worker.
+				Resolved->m_Compiler->Link( Resolved, std::move( InputFiles ), Libraries, ProjectName, Kind, State, [ Output, Token ]( std::optional< std::filesystem::path > Result )
+					{
+						if( !Result )
+							Token->ReportFailure();
+						else if( Output )
+							*Output = std::move( *Result );
+					} );
 			},
-			LinkerJobs
+			Jobs.LinkerDependencies,
+			LinkerCost,
+			rBuild.Token
 		);
+
+		rBuild.LinkerJobs.push_back( LinkerJobs[ Index ] );
 	}
 
-} // Build
+} // ScheduleBuild
+
+//////////////////////////////////////////////////////////////////////////
+
+void Workspace::ScheduleBuildFinished( PendingBuild Build, std::filesystem::path TraceDir )
+{
+	m_BuildFinishedJob = JobSystem::Instance().NewJob(
+		[ this, LinkerOutputs = Build.LinkerOutputs, States = Build.States, Token = Build.Token, TraceDir ]( void )
+		{
+			// Cancelled link jobs never ran, so the states are saved here to keep everything that did compile
+			for( const std::shared_ptr< BuildState >& rState : States )
+				rState->Save();
+
+			BuildTrace::Instance().PrintSummary( 5 );
+			BuildTrace::Instance().Write( TraceDir, m_Name );
+
+			const CompileCache::Statistics CacheStatistics = CompileCache::Instance().TakeBuildStatistics();
+
+			if( CacheStatistics.Hits + CacheStatistics.Misses > 0 )
+			{
+				const uint64_t HitRate = CacheStatistics.Hits * 100 / ( CacheStatistics.Hits + CacheStatistics.Misses );
+
+				std::cout << "Compile cache: " << CacheStatistics.Hits << " hits, " << CacheStatistics.Misses << " misses (" << HitRate << "%), ";
+				std::cout << ( CompileCache::Instance().TotalSize() >> 20 ) << " MiB in use\n";
+			}
+
+			CompileCache::Instance().Save();
+
+			// Only a build where every configuration produced an output counts as a success
+			const bool Success = !Token->IsCancelled() && Token->Failures() == 0
+			                  && std::none_of( LinkerOutputs.begin(), LinkerOutputs.end(), []( const auto& rLinkerOutput ) { return rLinkerOutput->empty(); } );
+
+			if( Success )
+			{
+				std::cout << "Done building workspace\n";
+
+				Events.BuildFinished( *this, *LinkerOutputs.front(), true );
+			}
+			else
+			{
+				if( !Token->IsCancelled() )
+					std::cout << "Failed to build workspace\n";
+				else if( Token->Failures() > 0 )
+					std::cout << "Build stopped after " << Token->Failures() << " failed jobs\n";
+				else
+					std::cout << "Build stopped\n";
+
+				Events.BuildFinished( *this, "", false );
+			}
+		},
+		Build.LinkerJobs
+	);
+
+} // ScheduleBuildFinished
+
+//////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr< BuildState > Workspace::AcquireBuildState( const std::filesystem::path& rPath )
+{
+	std::shared_ptr< BuildState >& rState = m_BuildStates[ rPath.generic_string() ];
+
+	// Records are kept between builds so that they don't need to be read again, unless another build of the project replaced them
+	if( !rState || rState->IsStale() )
+	{
+		rState = std::make_shared< BuildState >( rPath );
+		rState->Load();
+	}
+	else
+	{
+		rState->Dependencies().ResetTimes();
+	}
+
+	return rState;
+
+} // AcquireBuildState
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -203,6 +490,20 @@ bool Workspace::Deserialize( void )
 
 //////////////////////////////////////////////////////////////////////////
 
+bool Workspace::Reload( void )
+{
+	if( IsBuilding() )
+		return false;
+
+	// Projects are added again as the workspace file lists them. The build states are kept, since those belong to the output directories.
+	m_Projects.clear();
+
+	return Deserialize();
+
+} // Reload
+
+//////////////////////////////////////////////////////////////////////////
+
 void Workspace::Rename( std::string Name )
 {
 	const std::filesystem::path OldPath = ( m_Location / m_Name ).replace_extension( EXTENSION );
@@ -352,7 +653,9 @@ void Workspace::SerializeBuildMatrixColumn( GCL::Object& rObject, const BuildMat
 	{
 		GCL::Object ConfigurationObj( rName );
 
-		if( rConfiguration.m_Compiler || rConfiguration.m_Architecture || rConfiguration.m_Optimization )
+		if( rConfiguration.m_Compiler || rConfiguration.m_Architecture || rConfiguration.m_Optimization || rConfiguration.m_Linker
+		 || rConfiguration.m_UnityBuild || rConfiguration.m_UnityBatchSize || rConfiguration.m_ThinArchives || rConfiguration.m_SplitDebugInfo
+		 || rConfiguration.m_KeepGoing || rConfiguration.m_Explain )
 		{
 			GCL::Object::TableType& rTable = ConfigurationObj.SetTable();
 
@@ -364,6 +667,27 @@ void Workspace::SerializeBuildMatrixColumn( GCL::Object& rObject, const BuildMat
 
 			if( rConfiguration.m_Optimization )
 				rTable.emplace_back( "Optimization" ).SetString( std::string( Reflection::EnumToString( *rConfiguration.m_Optimization ) ) );
+
+			if( rConfiguration.m_Linker )
+				rTable.emplace_back( "Linker" ).SetString( std::string( Reflection::EnumToString( *rConfiguration.m_Linker ) ) );
+
+			if( rConfiguration.m_UnityBuild )
+				rTable.emplace_back( "UnityBuild" ).SetString( *rConfiguration.m_UnityBuild ? "true" : "false" );
+
+			if( rConfiguration.m_UnityBatchSize )
+				rTable.emplace_back( "UnityBatchSize" ).SetString( std::to_string( *rConfiguration.m_UnityBatchSize ) );
+
+			if( rConfiguration.m_ThinArchives )
+				rTable.emplace_back( "ThinArchives" ).SetString( *rConfiguration.m_ThinArchives ? "true" : "false" );
+
+			if( rConfiguration.m_SplitDebugInfo )
+				rTable.emplace_back( "SplitDebugInfo" ).SetString( *rConfiguration.m_SplitDebugInfo ? "true" : "false" );
+
+			if( rConfiguration.m_KeepGoing )
+				rTable.emplace_back( "KeepGoing" ).SetString( std::to_string( *rConfiguration.m_KeepGoing ) );
+
+			if( rConfiguration.m_Explain )
+				rTable.emplace_back( "Explain" ).SetString( *rConfiguration.m_Explain ? "true" : "false" );
 		}
 
 		ColumnObj.AddChild( std::move( ConfigurationObj ) );
@@ -413,6 +737,58 @@ void Workspace::DeserializeBuildMatrixColumn( BuildMatrix::Column& rColumn, cons
 
 				Reflection::EnumFromString( rOptimization, Configuration.m_Optimization.emplace() );
 			}
+
+			if( auto Linker = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "Linker"; } )
+			;   Linker != rTable.end() && Linker->IsString() )
+			{
+				const GCL::Object::StringType& rLinker = Linker->String();
+
+				Reflection::EnumFromString( rLinker, Configuration.m_Linker.emplace() );
+			}
+
+			if( auto UnityBuild = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "UnityBuild"; } )
+			;   UnityBuild != rTable.end() && UnityBuild->IsString() )
+			{
+				Configuration.m_UnityBuild = ( UnityBuild->String() == "true" );
+			}
+
+			if( auto UnityBatchSize = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "UnityBatchSize"; } )
+			;   UnityBatchSize != rTable.end() && UnityBatchSize->IsString() )
+			{
+				const GCL::Object::StringType& rUnityBatchSize = UnityBatchSize->String();
+				uint32_t                       Value           = 0;
+
+				if( std::from_chars( rUnityBatchSize.data(), rUnityBatchSize.data() + rUnityBatchSize.size(), Value ).ec == std::errc() )
+					Configuration.m_UnityBatchSize = Value;
+			}
+
+			if( auto ThinArchives = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "ThinArchives"; } )
+			;   ThinArchives != rTable.end() && ThinArchives->IsString() )
+			{
+				Configuration.m_ThinArchives = ( ThinArchives->String() == "true" );
+			}
+
+			if( auto SplitDebugInfo = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "SplitDebugInfo"; } )
+			;   SplitDebugInfo != rTable.end() && SplitDebugInfo->IsString() )
+			{
+				Configuration.m_SplitDebugInfo = ( SplitDebugInfo->String() == "true" );
+			}
+
+			if( auto KeepGoing = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "KeepGoing"; } )
+			;   KeepGoing != rTable.end() && KeepGoing->IsString() )
+			{
+				const GCL::Object::StringType& rKeepGoing = KeepGoing->String();
+				uint32_t                       Value      = 0;
+
+				if( std::from_chars( rKeepGoing.data(), rKeepGoing.data() + rKeepGoing.size(), Value ).ec == std::errc() )
+					Configuration.m_KeepGoing = Value;
+			}
+
+			if( auto Explain = std::find_if( rTable.begin(), rTable.end(), []( const GCL::Object& rObject ) { return rObject.Name() == "Explain"; } )
+			;   Explain != rTable.end() && Explain->IsString() )
+			{
+				Configuration.m_Explain = ( Explain->String() == "true" );
+			}
 		}
 
 		rColumn.Configurations.emplace_back( rConfigurationObj.Name(), std::move( Configuration ) );
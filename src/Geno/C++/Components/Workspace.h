@@ -20,13 +20,18 @@
 #include "Components/BuildMatrix.h"
 #include "Components/Project.h"
 
+#include <Common/Async/CancellationToken.h>
+#include <Common/Async/JobSystem.h>
 #include <Common/Event.h>
 #include <Common/Process.h>
 #include <GCL/Deserializer.h>
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 class Workspace;
@@ -48,9 +53,14 @@ public:
 
 //////////////////////////////////////////////////////////////////////////
 
-	void Build      ( void );
-	bool Serialize  ( void );
-	bool Deserialize( void );
+	void Build               ( void );
+	void BuildAllPermutations( void );
+	void BuildProject        ( std::string_view Name );
+	void CancelBuild         ( void );
+	bool IsBuilding          ( void ) const;
+	bool Serialize           ( void );
+	bool Deserialize         ( void );
+	bool Reload              ( void );
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -81,11 +91,36 @@ public:
 
 private:
 
+	struct PendingBuild
+	{
+		std::vector< JobSystem::JobPtr >                        LinkerJobs;
+		std::vector< std::shared_ptr< std::filesystem::path > > LinkerOutputs;
+		std::vector< std::shared_ptr< BuildState > >            States;
+		std::shared_ptr< CancellationToken >                    Token;
+
+	}; // PendingBuild
+
+//////////////////////////////////////////////////////////////////////////
+
 	static void GCLObjectCallback( GCL::Object pObject, void* pUser );
 
+//////////////////////////////////////////////////////////////////////////
+
+	PendingBuild                           BeginBuild           ( const Configuration& rConfiguration );
+	void                                   ScheduleBuild        ( const Configuration& rConfiguration, const std::string& rPermutation, const Project* pTarget, PendingBuild& rBuild );
+	void                                   ScheduleBuildFinished( PendingBuild Build, std::filesystem::path TraceDir );
+	std::shared_ptr< BuildState >          AcquireBuildState    ( const std::filesystem::path& rPath );
+	std::optional< std::vector< size_t > > SortProjects         ( const std::vector< std::vector< size_t > >& rDependencies, std::optional< size_t > Target ) const;
+
 //////////////////////////////////////////////////////////////////////////
 
 	void SerializeBuildMatrixColumn  ( GCL::Object& rObject, const BuildMatrix::Column& rColumn );
 	void DeserializeBuildMatrixColumn( BuildMatrix::Column& rColumn, const GCL::Object& rObject );
 
+//////////////////////////////////////////////////////////////////////////
+
+	std::unordered_map< std::string, std::shared_ptr< BuildState > > m_BuildStates;
+	std::weak_ptr< CancellationToken >                               m_BuildCancellationToken;
+	std::weak_ptr< Job >                                             m_BuildFinishedJob;
+
 }; // Workspace
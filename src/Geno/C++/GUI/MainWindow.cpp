@@ -29,6 +29,7 @@
 #include "GUI/Widgets/WorkspaceOutliner.h"
 #include "GUI/Widgets/StatusBar.h"
 #include "GUI/Widgets/FindInWorkspace.h"
+#include "GUI/Widgets/ProblemsWindow.h"
 #include "GUI/Styles.h"
 
 #include <iostream>
@@ -171,6 +172,7 @@ MainWindow::MainWindow( void )
 	pTextEdit          = new TextEdit();
 	pOutputWindow      = new OutputWindow();
 	pFindInWorkspace   = new FindInWorkspace();
+	pProblemsWindow    = new ProblemsWindow();
 
 } // MainWindow
 
@@ -184,6 +186,7 @@ MainWindow::~MainWindow( void )
 	delete pWorkspaceOutliner;
 	delete pTitleBar;
 	delete pFindInWorkspace;
+	delete pProblemsWindow;
 
 #if defined( _WIN32 )
 
@@ -266,6 +269,7 @@ void MainWindow::Render( void )
 	if( pTitleBar->ShowTextEdit                   ) pTextEdit         ->Show( &pTitleBar->ShowTextEdit );
 	if( pTitleBar->ShowOutputWindow               ) pOutputWindow     ->Show( &pTitleBar->ShowOutputWindow );
 	if( pTitleBar->ShowFindInWorkspaceWindow      ) pFindInWorkspace  ->Show( &pTitleBar->ShowFindInWorkspaceWindow );
+	if( pTitleBar->ShowProblemsWindow             ) pProblemsWindow   ->Show( &pTitleBar->ShowProblemsWindow );
 
 	StatusBar::Instance().Show();
 
@@ -465,6 +469,12 @@ void MainWindow::ImGuiSettingsReadLineCB( ImGuiContext* /*pContext*/, ImGuiSetti
 		if( sscanf( pLine, "Active=%d", &Active ) == 1 )
 			pSelf->pTitleBar->ShowOutputWindow = Active;
 	}
+	else if( Name == "Problems" )
+	{
+		int Active;
+		if( sscanf( pLine, "Active=%d", &Active ) == 1 )
+			pSelf->pTitleBar->ShowProblemsWindow = Active;
+	}
 	else if( Name == "Recent Workspaces" )
 	{
 		if( strncmp( pLine, "Path=", 5 ) == 0 )
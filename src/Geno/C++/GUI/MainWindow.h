@@ -36,6 +36,7 @@ class  TextEdit;
 class  Win32DropTarget;
 class  WorkspaceOutliner;
 class  FindInWorkspace;
+class  ProblemsWindow;
 struct GLFWwindow;
 struct ImGuiContext;
 struct ImGuiSettingsHandler;
@@ -91,6 +92,7 @@ public:
 	TextEdit*          pTextEdit          = nullptr;
 	OutputWindow*      pOutputWindow      = nullptr;
 	FindInWorkspace*   pFindInWorkspace   = nullptr;
+	ProblemsWindow*    pProblemsWindow    = nullptr;
 
 //////////////////////////////////////////////////////////////////////////
 
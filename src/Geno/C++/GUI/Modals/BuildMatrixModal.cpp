@@ -375,6 +375,96 @@ void BuildMatrixModal::DrawSidebar( void )
 			}
 		}
 
+		ImGui::SetCursorPosY( ImGui::GetCursorPosY() + 10.0f );
+
+		// Unity build
+		{
+			bool UnityBuild = rConfiguration.second.m_UnityBuild.value_or( false );
+
+			if( ImGui::Checkbox( "Unity build##UNITY_BUILD", &UnityBuild ) )
+			{
+				if( UnityBuild ) rConfiguration.second.m_UnityBuild = true;
+				else             rConfiguration.second.m_UnityBuild.reset();
+			}
+
+			if( UnityBuild )
+			{
+				int BatchSize = static_cast< int >( rConfiguration.second.m_UnityBatchSize.value_or( 0 ) );
+
+				ImGui::TextUnformatted( "Files per unit (0 = per filter)" );
+
+				if( ImGui::InputInt( "##UNITY_BATCH_SIZE", &BatchSize ) )
+				{
+					if( BatchSize > 0 ) rConfiguration.second.m_UnityBatchSize = static_cast< uint32_t >( BatchSize );
+					else                rConfiguration.second.m_UnityBatchSize.reset();
+				}
+			}
+		}
+
+		ImGui::SetCursorPosY( ImGui::GetCursorPosY() + 10.0f );
+
+		// Linker
+		{
+			const char* pLinkerNames[] { "Default", "BFD", "Gold", "LLD", "Mold" };
+			int         Index          = static_cast< int >( rConfiguration.second.m_Linker.value_or( Configuration::Linker::Default ) );
+
+			ImGui::TextUnformatted( "Linker (GCC)" );
+
+			if( ImGui::Combo( "##LINKER", &Index, pLinkerNames, static_cast< int >( std::size( pLinkerNames ) ) ) )
+			{
+				if( Index > 0 ) rConfiguration.second.m_Linker = static_cast< Configuration::Linker >( Index );
+				else            rConfiguration.second.m_Linker.reset();
+			}
+		}
+
+		// Thin archives
+		{
+			bool ThinArchives = rConfiguration.second.m_ThinArchives.value_or( false );
+
+			if( ImGui::Checkbox( "Thin archives##THIN_ARCHIVES", &ThinArchives ) )
+			{
+				if( ThinArchives ) rConfiguration.second.m_ThinArchives = true;
+				else               rConfiguration.second.m_ThinArchives.reset();
+			}
+		}
+
+		// Split debug info
+		{
+			bool SplitDebugInfo = rConfiguration.second.m_SplitDebugInfo.value_or( false );
+
+			if( ImGui::Checkbox( "Split debug info##SPLIT_DEBUG_INFO", &SplitDebugInfo ) )
+			{
+				if( SplitDebugInfo ) rConfiguration.second.m_SplitDebugInfo = true;
+				else                 rConfiguration.second.m_SplitDebugInfo.reset();
+			}
+		}
+
+		ImGui::SetCursorPosY( ImGui::GetCursorPosY() + 10.0f );
+
+		// Keep going
+		{
+			int KeepGoing = static_cast< int >( rConfiguration.second.m_KeepGoing.value_or( 1 ) );
+
+			ImGui::TextUnformatted( "Stop after failures (0 = never)" );
+
+			if( ImGui::InputInt( "##KEEP_GOING", &KeepGoing ) )
+			{
+				if( KeepGoing != 1 ) rConfiguration.second.m_KeepGoing = static_cast< uint32_t >( KeepGoing > 0 ? KeepGoing : 0 );
+				else                 rConfiguration.second.m_KeepGoing.reset();
+			}
+		}
+
+		// Explain
+		{
+			bool Explain = rConfiguration.second.m_Explain.value_or( false );
+
+			if( ImGui::Checkbox( "Explain rebuilds##EXPLAIN", &Explain ) )
+			{
+				if( Explain ) rConfiguration.second.m_Explain = true;
+				else          rConfiguration.second.m_Explain.reset();
+			}
+		}
+
 		// Delete button
 		{
 			ImGui::SetCursorPosY( ImGui::GetWindowHeight() - 24 );
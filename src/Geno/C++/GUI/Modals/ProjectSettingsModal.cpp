@@ -155,6 +155,21 @@ void ProjectSettingsModal::UpdateDerived( void )
 						pProject->m_LocalConfiguration.m_Defines.emplace_back();
 					}
 
+					ImGui::Separator();
+					ImGui::TextUnformatted( "Precompiled Header" );
+
+					{
+						std::optional< std::filesystem::path >& rPrecompiledHeader = pProject->m_LocalConfiguration.m_PrecompiledHeader;
+						std::string                             Buffer             = rPrecompiledHeader ? rPrecompiledHeader->lexically_relative( pProject->m_Location ).string() : std::string();
+
+						ImGui::SetNextItemWidth( -5.0f );
+						if( ImGui::InputText( "##PRECOMPILED_HEADER", &Buffer ) )
+						{
+							if( Buffer.empty() ) rPrecompiledHeader.reset();
+							else                 rPrecompiledHeader = ( pProject->m_Location / Buffer ).lexically_normal();
+						}
+					}
+
 				} break;
 
 				case CategoryLinker:
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "ProblemsWindow.h"
+
+#include "Build/Diagnostics.h"
+#include "GUI/MainWindow.h"
+#include "GUI/Widgets/TextEdit.h"
+#include "GUI/Widgets/TitleBar.h"
+
+#include <string>
+
+#include <imgui.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+static const char* SeverityName( DiagnosticStore::Severity Level )
+{
+	switch( Level )
+	{
+		case DiagnosticStore::Severity::Error:   return "Error";
+		case DiagnosticStore::Severity::Warning: return "Warning";
+		case DiagnosticStore::Severity::Note:    return "Note";
+	}
+
+	return "";
+
+} // SeverityName
+
+//////////////////////////////////////////////////////////////////////////
+
+static ImVec4 SeverityColor( DiagnosticStore::Severity Level )
+{
+	switch( Level )
+	{
+		case DiagnosticStore::Severity::Error:   return ImVec4( 0.95f, 0.35f, 0.35f, 1.0f );
+		case DiagnosticStore::Severity::Warning: return ImVec4( 0.95f, 0.80f, 0.30f, 1.0f );
+		case DiagnosticStore::Severity::Note:    return ImVec4( 0.55f, 0.75f, 0.95f, 1.0f );
+	}
+
+	return ImGui::GetStyleColorVec4( ImGuiCol_Text );
+
+} // SeverityColor
+
+//////////////////////////////////////////////////////////////////////////
+
+static std::string FormatLocation( const DiagnosticStore::Diagnostic& rDiagnostic )
+{
+	std::string Location = rDiagnostic.File;
+
+	if( rDiagnostic.Line > 0 )
+		Location += ":" + std::to_string( rDiagnostic.Line );
+
+	if( rDiagnostic.Column > 0 )
+		Location += ":" + std::to_string( rDiagnostic.Column );
+
+	return Location;
+
+} // FormatLocation
+
+//////////////////////////////////////////////////////////////////////////
+
+static void OpenInTextEdit( const DiagnosticStore::Diagnostic& rDiagnostic )
+{
+	if( rDiagnostic.File.empty() )
+		return;
+
+	MainWindow::Instance().pTitleBar->ShowTextEdit = true;
+	MainWindow::Instance().pTextEdit->GoTo( rDiagnostic.File, ( int )rDiagnostic.Line, ( int )rDiagnostic.Column );
+
+} // OpenInTextEdit
+
+//////////////////////////////////////////////////////////////////////////
+
+void ProblemsWindow::Show( bool* pOpen )
+{
+	ImGui::SetNextWindowSize( ImVec2( 350 * 2, 196 ), ImGuiCond_FirstUseEver );
+
+	if( ImGui::Begin( "Problems", pOpen ) )
+	{
+		const DiagnosticStore& rStore = DiagnosticStore::Instance();
+
+		bool FilterChanged = false;
+
+		FilterChanged |= ImGui::Checkbox( ( "Errors (" + std::to_string( rStore.NumErrors() ) + ")###Errors" ).c_str(), &m_ShowErrors );
+		ImGui::SameLine();
+		FilterChanged |= ImGui::Checkbox( ( "Warnings (" + std::to_string( rStore.NumWarnings() ) + ")###Warnings" ).c_str(), &m_ShowWarnings );
+		ImGui::SameLine();
+		FilterChanged |= ImGui::Checkbox( "Notes", &m_ShowNotes );
+
+		// The store is filled from the build threads, so only filter again when something was added
+		if( const uint64_t Generation = rStore.Generation(); FilterChanged || Generation != m_Generation )
+		{
+			m_Rows       = rStore.Filter( m_ShowErrors, m_ShowWarnings, m_ShowNotes );
+			m_Generation = Generation;
+		}
+
+		const ImGuiTableFlags TableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+
+		if( ImGui::BeginTable( "##Problems", 3, TableFlags ) )
+		{
+			ImGui::TableSetupScrollFreeze( 0, 1 );
+			ImGui::TableSetupColumn( "Severity", ImGuiTableColumnFlags_WidthFixed );
+			ImGui::TableSetupColumn( "Message", ImGuiTableColumnFlags_WidthStretch );
+			ImGui::TableSetupColumn( "Location", ImGuiTableColumnFlags_WidthStretch, 0.4f );
+			ImGui::TableHeadersRow();
+
+			// Only the visible rows are looked up, since a broken header can produce thousands of diagnostics
+			ImGuiListClipper Clipper;
+			Clipper.Begin( ( int )m_Rows.size() );
+
+			while( Clipper.Step() )
+			{
+				for( int Row = Clipper.DisplayStart; Row < Clipper.DisplayEnd; ++Row )
+				{
+					const uint32_t                    Index       = m_Rows[ Row ];
+					const DiagnosticStore::Diagnostic Diagnostic  = rStore.Get( Index );
+					const uint32_t                    Occurrences = rStore.Occurrences( Index );
+
+					ImGui::PushID( Row );
+					ImGui::TableNextRow();
+
+					ImGui::TableSetColumnIndex( 0 );
+					ImGui::TextColored( SeverityColor( Diagnostic.Level ), "%s", SeverityName( Diagnostic.Level ) );
+
+					ImGui::TableSetColumnIndex( 1 );
+					if( ImGui::Selectable( Diagnostic.Message.c_str(), false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick ) && ImGui::IsMouseDoubleClicked( 0 ) )
+						OpenInTextEdit( Diagnostic );
+
+					if( ImGui::IsItemHovered() )
+					{
+						const std::vector< DiagnosticStore::Diagnostic > Notes = rStore.Notes( Index );
+
+						ImGui::BeginTooltip();
+						ImGui::Text( "In %s", rStore.TranslationUnit( Index ).c_str() );
+
+						if( Occurrences > 1 )
+							ImGui::Text( "Reported by %u translation units", Occurrences );
+
+						for( const DiagnosticStore::Diagnostic& rNote : Notes )
+						{
+							ImGui::TextColored( SeverityColor( rNote.Level ), "%s", FormatLocation( rNote ).c_str() );
+							ImGui::SameLine();
+							ImGui::TextUnformatted( rNote.Message.c_str() );
+						}
+
+						ImGui::EndTooltip();
+					}
+
+					if( Occurrences > 1 )
+					{
+						ImGui::SameLine();
+						ImGui::TextDisabled( "(x%u)", Occurrences );
+					}
+
+					ImGui::TableSetColumnIndex( 2 );
+					ImGui::TextUnformatted( FormatLocation( Diagnostic ).c_str() );
+
+					ImGui::PopID();
+				}
+			}
+
+			ImGui::EndTable();
+		}
+	} ImGui::End();
+
+} // Show
@@ -18,6 +18,8 @@
 #include "StatusBar.h"
 #include "GUI/PrimaryMonitor.h"
 
+#include <Common/ProcessReactor.h>
+
 #include <thread>
 #include <chrono>
 
@@ -169,6 +171,32 @@ void StatusBar::Show( void )
 	{
 		ImGui::Text( "%s", m_Message.Msg.c_str() );
 
+		// Show how many compilers may run at once while a build is running, and what is holding them back
+		if( const ProcessReactor::Status Status = ProcessReactor::Instance().CurrentStatus(); Status.NumRunning + Status.NumPending > 0 )
+		{
+			ImGui::SameLine( 0.0f, 30.0f );
+			ImGui::Text( "Processes: %zu / %zu", Status.NumRunning, Status.Limit );
+
+			switch( Status.Constraint )
+			{
+				case ResourceGovernor::Constraint::Load:
+					ImGui::SameLine();
+					ImGui::TextUnformatted( "(limited by system load)" );
+					break;
+				case ResourceGovernor::Constraint::Memory:
+					ImGui::SameLine();
+					ImGui::TextUnformatted( "(limited by available memory)" );
+					break;
+				case ResourceGovernor::Constraint::Jobserver:
+					ImGui::SameLine();
+					ImGui::TextUnformatted( "(waiting for a jobserver slot)" );
+					break;
+				case ResourceGovernor::Constraint::None:
+				default:
+					break;
+			}
+		}
+
 		float Offset = 0.0f;
 
 		if( !m_TextEditInfo.empty() )
@@ -25,6 +25,7 @@
 #include "Discord/DiscordRPC.h"
 #include "GUI/Widgets/StatusBar.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -262,6 +263,36 @@ void TextEdit::AddFile( const std::filesystem::path& rPath )
 
 //////////////////////////////////////////////////////////////////////////
 
+void TextEdit::GoTo( const std::filesystem::path& rPath, int Line, int Column )
+{
+	AddFile( rPath );
+
+	for( File& rFile : Files )
+	{
+		if( rFile.Path != rPath || rFile.Lines.empty() )
+			continue;
+
+		// Lines and columns are one-based, as reported by compilers
+		const int Y = std::clamp( Line - 1, 0, ( int )rFile.Lines.size() - 1 );
+		const int X = std::clamp( Column - 1, 0, ( int )rFile.Lines[ Y ].size() );
+
+		Cursor Cursor;
+		Cursor.Position = Coordinate( X, Y );
+		Cursor.Main     = true;
+
+		rFile.Cursors.clear();
+		rFile.Cursors.push_back( Cursor );
+
+		// Scrolling needs the layout of the editor window, so wait until it is rendered
+		rFile.PendingScroll = true;
+
+		break;
+	}
+
+} // GoTo
+
+//////////////////////////////////////////////////////////////////////////
+
 void TextEdit::OnDragDrop( const Drop& rDrop, int X, int Y )
 {
 	ImGuiWindow* pWindow = ImGui::FindWindowByName( WINDOW_NAME );
@@ -459,6 +490,12 @@ bool TextEdit::RenderEditor( File& rFile )
 	HandleKeyboardInputs( rFile );
 	HandleMouseInputs( rFile );
 
+	if( rFile.PendingScroll )
+	{
+		ScrollToCursor( rFile );
+		rFile.PendingScroll = false;
+	}
+
 	int FirstLine = ( int )( Props.ScrollY / Props.CharAdvanceY );
 	int LastLine  = std::min( FirstLine + ( int )( Size.y / Props.CharAdvanceY + 2 ), ( int )rFile.Lines.size() - 1 );
 
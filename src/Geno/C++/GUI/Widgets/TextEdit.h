@@ -328,8 +328,9 @@ public:
 
 		std::vector< Line > Lines;
 
-		bool Open    = true;
-		bool Changed = false;
+		bool Open          = true;
+		bool Changed       = false;
+		bool PendingScroll = false;
 
 		std::vector< Cursor > Cursors;
 
@@ -353,6 +354,7 @@ public:
 
 	void Show( bool* pOpen );
 	void AddFile( const std::filesystem::path& rPath );
+	void GoTo( const std::filesystem::path& rPath, int Line, int Column );
 	void OnDragDrop( const Drop& rDrop, int X, int Y );
 	void SaveFile( File& rFile );
 	void ReplaceFile( const std::filesystem::path& rOldPath, const std::filesystem::path& rNewPath );
@@ -19,6 +19,7 @@
 
 #include "Application.h"
 #include "Auxiliary/STBAux.h"
+#include "Build/CompilationDatabase.h"
 #include "Compilers/ICompiler.h"
 #include "GUI/MainWindow.h"
 #include "GUI/Modals/NewItemModal.h"
@@ -108,6 +109,11 @@ void TitleBar::Draw( void )
 
 			ImGui::Separator();
 
+			if( ImGui::MenuItem( "Export Compilation Database", "", false, WorkspaceActive ) ) ActionFileExportCompilationDatabase();
+			if( ImGui::MenuItem( "Import Compilation Database", "", false, WorkspaceActive ) ) ActionFileImportCompilationDatabase();
+
+			ImGui::Separator();
+
 			if( ImGui::MenuItem( "Exit", "Alt+E" ) ) exit( 0 );
 
 			ImGui::EndMenu();
@@ -117,6 +123,12 @@ void TitleBar::Draw( void )
 		{
 			if( ImGui::MenuItem( "Build And Run", "F5" ) ) ActionBuildBuildAndRun();
 			if( ImGui::MenuItem( "Build", "F7" ) ) ActionBuildBuild();
+			if( ImGui::MenuItem( "Build All Permutations" ) ) ActionBuildBuildAllPermutations();
+
+			ImGui::Separator();
+
+			if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
+				if( ImGui::MenuItem( "Stop Build", "Ctrl+Break", false, pWorkspace->IsBuilding() ) ) ActionBuildStopBuild();
 
 			ImGui::EndMenu();
 		}
@@ -126,6 +138,7 @@ void TitleBar::Draw( void )
 			ImGui::MenuItem( "Text Edit", "Alt+T", &ShowTextEdit );
 			ImGui::MenuItem( "Workspace", "Alt+W", &ShowWorkspaceOutliner );
 			ImGui::MenuItem( "Output", "Alt+O", &ShowOutputWindow );
+			ImGui::MenuItem( "Problems", "Alt+P", &ShowProblemsWindow );
 
 			ImGui::MenuItem( "Find Files in Workspace", "Alt+J", &ShowFindInWorkspaceWindow );
 
@@ -178,7 +191,38 @@ void TitleBar::Draw( void )
 				float ScreenX = ImGui::GetCursorScreenPos().x;
 				float ScreenY = ImGui::GetCursorScreenPos().y;
 
-				if( !pWorkspace->m_AppProcess->IsRunning() )
+				if( pWorkspace->IsBuilding() )
+				{
+					const float  BoxSize = 0.75f;
+					const float  FramePadding = ImGui::GetStyle().FramePadding.x;
+					const float  TextSize = ImGui::CalcTextSize( "Stop Build" ).x + FramePadding + 2.1f;
+					ImRect       ButtonRect = ImRect( ImVec2( ScreenX, ScreenY ), ImVec2( ScreenX + BoxSize * 25 + TextSize,     ScreenY + BoxSize * 25 ) );
+					ImRect       IconRect   = ImRect( ImVec2( ScreenX, ScreenY ), ImVec2( ScreenX + BoxSize * 25 + FramePadding, ScreenY + BoxSize * 25 ) );
+
+					bool Hovered = false;
+					bool Held    = false;
+					bool Pressed = ImGui::ButtonBehavior( ButtonRect, ImGui::GetID( "STOP_BUILD" ), &Hovered, &Held, 0 );
+
+					if( Hovered )
+					{
+						const ImU32 Color = ImGui::GetColorU32( Held ? ImGuiCol_ButtonActive : ImGuiCol_ButtonHovered );
+						pDrawList->AddRectFilled( ButtonRect.Min, ButtonRect.Max, Color );
+					}
+
+					{
+						pDrawList->AddRectFilled( IconRect.Max, IconRect.Min, IM_COL32( 255, 255, 255, 255 ) );
+
+						ImGui::SameLine();
+						ImGui::SetCursorPosX( ImGui::GetCursorPosX() + 21.0f );
+						ImGui::Text( "Stop Build" );
+					}
+
+					if( Pressed )
+					{
+						ActionBuildStopBuild();
+					}
+				}
+				else if( !pWorkspace->m_AppProcess->IsRunning() )
 				{
 					const float ArrowSize = 0.75f;
 					const float TextSize = ImGui::CalcTextSize( "Run Project" ).x + ImGui::GetStyle().FramePadding.x + 2.1f;
@@ -410,6 +454,7 @@ void TitleBar::Draw( void )
 		if( ImGui::IsKeyPressed( GLFW_KEY_N ) ) ActionFileNewWorkspace();
 		if( ImGui::IsKeyPressed( GLFW_KEY_O ) ) ActionFileOpenWorkspace();
 		if( ImGui::IsKeyPressed( GLFW_KEY_W ) ) ActionFileCloseWorkspace();
+		if( ImGui::IsKeyPressed( GLFW_KEY_PAUSE ) ) ActionBuildStopBuild();
 	}
 	else if( ImGui::IsKeyDown( GLFW_KEY_LEFT_ALT ) || ImGui::IsKeyDown( GLFW_KEY_RIGHT_ALT ) )
 	{
@@ -417,6 +462,7 @@ void TitleBar::Draw( void )
 		if( ImGui::IsKeyPressed( GLFW_KEY_T ) ) ShowTextEdit ^= 1;
 		if( ImGui::IsKeyPressed( GLFW_KEY_W ) ) ShowWorkspaceOutliner ^= 1;
 		if( ImGui::IsKeyPressed( GLFW_KEY_O ) ) ShowOutputWindow ^= 1;
+		if( ImGui::IsKeyPressed( GLFW_KEY_P ) ) ShowProblemsWindow ^= 1;
 		if( ImGui::IsKeyPressed( GLFW_KEY_J ) ) ShowFindInWorkspaceWindow ^= 1;
 	}
 	else
@@ -503,6 +549,27 @@ void TitleBar::ActionFileCloseWorkspace( void )
 
 //////////////////////////////////////////////////////////////////////////
 
+void TitleBar::ActionFileExportCompilationDatabase( void )
+{
+	if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
+		CompilationDatabase::Export( *pWorkspace, pWorkspace->m_Location / CompilationDatabase::FILE_NAME );
+
+} // ActionFileExportCompilationDatabase
+
+//////////////////////////////////////////////////////////////////////////
+
+void TitleBar::ActionFileImportCompilationDatabase( void )
+{
+	OpenFileModal::Instance().Show( "Import Compilation Database", "*.json", []( const std::filesystem::path& rFile )
+	{
+		if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
+			CompilationDatabase::Import( *pWorkspace, rFile );
+	} );
+
+} // ActionFileImportCompilationDatabase
+
+//////////////////////////////////////////////////////////////////////////
+
 void TitleBar::ActionBuildBuildAndRun( void )
 {
 	if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
@@ -558,6 +625,23 @@ void TitleBar::ActionBuildBuild( void )
 
 //////////////////////////////////////////////////////////////////////////
 
+void TitleBar::ActionBuildBuildAllPermutations( void )
+{
+	if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
+	{
+		MainWindow::Instance().pOutputWindow->ClearCapture();
+
+		// Save all open files before building
+		if( MainWindow::Instance().pTextEdit )
+			MainWindow::Instance().pTextEdit->SaveAllFiles();
+
+		pWorkspace->BuildAllPermutations();
+	}
+
+} // ActionBuildBuildAllPermutations
+
+//////////////////////////////////////////////////////////////////////////
+
 void TitleBar::AddBuildMatrixColumn( BuildMatrix::Column& rColumn )
 {
 	ImGui::Spacing();
@@ -597,3 +681,14 @@ void TitleBar::ActionBuildStopRun( void )
 		}
 	}
 } // ActionBuildStopRun
+
+//////////////////////////////////////////////////////////////////////////
+
+void TitleBar::ActionBuildStopBuild( void )
+{
+	if( Workspace* pWorkspace = Application::Instance().CurrentWorkspace() )
+	{
+		pWorkspace->CancelBuild();
+	}
+
+} // ActionBuildStopBuild
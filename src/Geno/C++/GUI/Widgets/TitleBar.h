@@ -48,6 +48,7 @@ public:
 	bool ShowDemoWindow            = false;
 	bool ShowAboutWindow           = false;
 	bool ShowOutputWindow          = false;
+	bool ShowProblemsWindow        = false;
 	bool ShowWorkspaceOutliner     = false;
 	bool ShowGenoDiscordSettings   = false;
 	bool ShowFindInWorkspaceWindow = false;
@@ -56,15 +57,19 @@ public:
 
 private:
 
-	void ActionFileNewWorkspace       ( void );
-	void ActionExtShowGenoDiscord     ( void );
-	void ActionFileOpenWorkspace      ( void );
-	void ActionFileOpenRecentWorkspace( std::filesystem::path Path );
-	void ActionFileCloseWorkspace     ( void );
-	void ActionBuildBuildAndRun       ( void );
-	void ActionBuildBuild             ( void );
-	void AddBuildMatrixColumn         ( BuildMatrix::Column& rColumn );
-	void ActionBuildStopRun           ( void );
+	void ActionFileNewWorkspace             ( void );
+	void ActionExtShowGenoDiscord           ( void );
+	void ActionFileOpenWorkspace            ( void );
+	void ActionFileOpenRecentWorkspace      ( std::filesystem::path Path );
+	void ActionFileCloseWorkspace           ( void );
+	void ActionFileExportCompilationDatabase( void );
+	void ActionFileImportCompilationDatabase( void );
+	void ActionBuildBuildAndRun             ( void );
+	void ActionBuildBuild                   ( void );
+	void ActionBuildBuildAllPermutations    ( void );
+	void AddBuildMatrixColumn               ( BuildMatrix::Column& rColumn );
+	void ActionBuildStopRun                 ( void );
+	void ActionBuildStopBuild               ( void );
 
 //////////////////////////////////////////////////////////////////////////
 
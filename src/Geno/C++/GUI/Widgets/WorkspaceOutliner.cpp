@@ -28,11 +28,13 @@
 #include "GUI/Modals/NewItemModal.h"
 #include "GUI/Modals/OpenFileModal.h"
 #include "GUI/Modals/ProjectSettingsModal.h"
+#include "GUI/Widgets/OutputWindow.h"
 #include "GUI/Widgets/TitleBar.h"
 #include "GUI/Widgets/TextEdit.h"
 #include "WidgetCommands/OutlinerCommands.h"
 #include "Discord/DiscordRPC.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include <GLFW/glfw3.h>
@@ -445,6 +447,21 @@ void WorkspaceOutliner::Show( bool* pOpen )
 			}
 			else if( ImGui::BeginPopup( "ProjectContextMenu", ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoSavedSettings ) )
 			{
+				// Builds the project along with the projects that it links with, and nothing else
+				if( ImGui::MenuItem( "Build", nullptr, false, !pWorkspace->IsBuilding() ) )
+				{
+					MainWindow::Instance().pOutputWindow->ClearCapture();
+
+					// Save all open files before building
+					if( MainWindow::Instance().pTextEdit )
+						MainWindow::Instance().pTextEdit->SaveAllFiles();
+
+					pWorkspace->BuildProject( m_SelectedProjectName );
+					ShowProjectContextMenu = false;
+				}
+
+				ImGui::Separator();
+
 				if( ImGui::MenuItem( "Rename" ) )
 				{
 					RenameProject          = RenameWorkspace || RenameFileFilter || RenameFile ? false : true;
@@ -627,6 +644,21 @@ void WorkspaceOutliner::Show( bool* pOpen )
 					ShowFileContextMenu = false;
 				}
 
+				if( Project* pProject = pWorkspace->ProjectByName( m_SelectedProjectName ) )
+				{
+					auto NonUnityFile = std::find( pProject->m_NonUnityFiles.begin(), pProject->m_NonUnityFiles.end(), m_SelectedFile );
+					bool Excluded     = ( NonUnityFile != pProject->m_NonUnityFiles.end() );
+
+					if( ImGui::MenuItem( "Exclude From Unity Build", nullptr, Excluded ) )
+					{
+						if( Excluded ) pProject->m_NonUnityFiles.erase( NonUnityFile );
+						else           pProject->m_NonUnityFiles.push_back( m_SelectedFile );
+
+						pProject->Serialize();
+						ShowFileContextMenu = false;
+					}
+				}
+
 				ImGui::EndPopup();
 			}
 		}
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Daemon.h"
+
+#include "Build/Diagnostics.h"
+#include "Components/Workspace.h"
+
+#include <Common/Async/JobSystem.h>
+#include <Common/Jobserver.h>
+#include <Common/ProcessReactor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Collects everything that the build prints, for the connection to pass on to the client. Jobs print from many threads at once.
+class CapturedOutput final : public std::streambuf
+{
+public:
+
+	std::string Take( void )
+	{
+		std::scoped_lock Lock( m_Mutex );
+
+		return std::exchange( m_Text, std::string() );
+
+	} // Take
+
+//////////////////////////////////////////////////////////////////////////
+
+protected:
+
+	int_type overflow( int_type Character ) override
+	{
+		if( !traits_type::eq_int_type( Character, traits_type::eof() ) )
+		{
+			std::scoped_lock Lock( m_Mutex );
+			m_Text.push_back( traits_type::to_char_type( Character ) );
+		}
+
+		return traits_type::not_eof( Character );
+
+	} // overflow
+
+	std::streamsize xsputn( const char* pText, std::streamsize Size ) override
+	{
+		std::scoped_lock Lock( m_Mutex );
+		m_Text.append( pText, static_cast< size_t >( Size ) );
+
+		return Size;
+
+	} // xsputn
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	std::mutex  m_Mutex;
+	std::string m_Text;
+
+}; // CapturedOutput
+
+//////////////////////////////////////////////////////////////////////////
+
+Daemon::Daemon( std::filesystem::path SocketPath, size_t NumJobs )
+	: m_SocketPath( std::move( SocketPath ) )
+	, m_NumJobs   ( NumJobs )
+{
+} // Daemon
+
+//////////////////////////////////////////////////////////////////////////
+
+Daemon::~Daemon( void ) = default;
+
+//////////////////////////////////////////////////////////////////////////
+
+int Daemon::Run( void )
+{
+	LocalSocket Listener = LocalSocket::Listen( m_SocketPath );
+
+	if( !Listener.IsValid() )
+	{
+		std::cerr << "geno-buildd: Failed to listen on " << m_SocketPath << "\n";
+		return 1;
+	}
+
+	if( !m_Watcher.IsValid() )
+		std::cerr << "geno-buildd: Can't watch files on this system. Workspaces are read again for every build.\n";
+
+	Jobserver::Instance().Start( m_NumJobs );
+	JobSystem::Instance().StartThreads( m_NumJobs );
+	ProcessReactor::Instance().SetMaxProcesses( m_NumJobs );
+
+	std::cout << "geno-buildd: Listening on " << m_SocketPath << " with " << m_NumJobs << " jobs\n" << std::flush;
+
+	// Builds run one at a time, but a thread per connection lets clients queue up behind the running build
+	for( LocalSocket Connection = Listener.Accept(); Connection.IsValid(); Connection = Listener.Accept() )
+		std::thread( &Daemon::Serve, this, std::move( Connection ) ).detach();
+
+	std::cerr << "geno-buildd: Stopped accepting connections on " << m_SocketPath << "\n";
+
+	return 1;
+
+} // Run
+
+//////////////////////////////////////////////////////////////////////////
+
+void Daemon::Serve( LocalSocket Connection )
+{
+	std::string Payload;
+
+	while( std::optional< WorkerProtocol::MessageType > Type = WorkerProtocol::Receive( Connection, Payload ) )
+	{
+		if( *Type != WorkerProtocol::MessageType::Build )
+			return;
+
+		WorkerProtocol::BuildRequest Request;
+		if( !WorkerProtocol::Decode( Payload, Request ) )
+			return;
+
+		WorkerProtocol::BuildReply Reply;
+		Reply.ExitCode = Build( Request, Connection );
+
+		if( !WorkerProtocol::Send( Connection, WorkerProtocol::MessageType::BuildReply, WorkerProtocol::Encode( Reply ) ) )
+			return;
+	}
+
+} // Serve
+
+//////////////////////////////////////////////////////////////////////////
+
+int Daemon::Build( const WorkerProtocol::BuildRequest& rRequest, LocalSocket& rConnection )
+{
+	std::scoped_lock Lock( m_BuildMutex );
+
+	CapturedOutput  Output;
+	bool            Connected     = true;
+	std::streambuf* pPreviousOut  = std::cout.rdbuf( &Output );
+	std::streambuf* pPreviousErr  = std::cerr.rdbuf( &Output );
+	auto            ForwardOutput = [ & ]( void )
+	{
+		if( std::string Text = Output.Take(); Connected && !Text.empty() )
+			Connected = WorkerProtocol::Send( rConnection, WorkerProtocol::MessageType::BuildOutput, Text );
+	};
+
+	const std::filesystem::path WorkspacePath = std::filesystem::path( rRequest.Workspace ).lexically_normal();
+	LoadedWorkspace*            pLoaded       = nullptr;
+	int                         ExitCode      = 0;
+
+	if( !WorkspacePath.is_absolute() )
+	{
+		std::cerr << "Expected an absolute path to the workspace, got " << WorkspacePath << "\n";
+		ExitCode = 2;
+	}
+	else if( pLoaded = Acquire( WorkspacePath ); !pLoaded )
+	{
+		std::cerr << "Failed to load workspace " << WorkspacePath << "\n";
+		ExitCode = 2;
+	}
+
+	if( pLoaded )
+	{
+		Workspace& rWorkspace = *pLoaded->pWorkspace;
+
+		// Selections of an earlier request must not leak into this one
+		for( size_t i = 0; i < rWorkspace.m_BuildMatrix.m_Columns.size() && i < pLoaded->Defaults.size(); ++i )
+			rWorkspace.m_BuildMatrix.m_Columns[ i ].CurrentConfiguration = pLoaded->Defaults[ i ];
+
+		for( const std::string& rSelection : rRequest.Selections )
+		{
+			const size_t           Equals        = rSelection.find( '=' );
+			const std::string_view Column        = std::string_view( rSelection ).substr( 0, Equals );
+			const std::string_view Configuration = ( Equals != std::string::npos ) ? std::string_view( rSelection ).substr( Equals + 1 ) : std::string_view();
+
+			if( Equals == std::string::npos || !rWorkspace.m_BuildMatrix.Select( Column, Configuration ) )
+			{
+				std::cerr << "Workspace has no configuration '" << Configuration << "' in column '" << Column << "'\n";
+				ExitCode = 2;
+			}
+		}
+
+		if( ExitCode == 0 && rWorkspace.m_Projects.empty() )
+		{
+			std::cerr << "Workspace " << WorkspacePath << " has no projects to build\n";
+			ExitCode = 2;
+		}
+		else if( ExitCode == 0 && !rRequest.Project.empty() && !rWorkspace.ProjectByName( rRequest.Project ) )
+		{
+			std::cerr << "Workspace " << WorkspacePath << " has no project named '" << rRequest.Project << "'\n";
+			ExitCode = 2;
+		}
+
+		if( ExitCode == 0 )
+		{
+			std::promise< bool > Finished;
+
+			rWorkspace.Events.BuildFinished += [ &Finished ]( Workspace& /*rWorkspace*/, std::filesystem::path /*OutputFile*/, bool Success )
+			{
+				Finished.set_value( Success );
+			};
+
+			if( rRequest.Project.empty() ) rWorkspace.Build();
+			else                           rWorkspace.BuildProject( rRequest.Project );
+
+			// The job that reported the result still uses the workspace until it returns
+			for( bool Cancelled = false; rWorkspace.IsBuilding(); )
+			{
+				std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+				ForwardOutput();
+
+				// Nobody is waiting for the result anymore
+				if( !Connected && !Cancelled )
+				{
+					rWorkspace.CancelBuild();
+					Cancelled = true;
+				}
+			}
+
+			const DiagnosticStore& rDiagnostics = DiagnosticStore::Instance();
+
+			if( rDiagnostics.NumErrors() > 0 || rDiagnostics.NumWarnings() > 0 )
+				std::cout << "Errors: " << rDiagnostics.NumErrors() << ", warnings: " << rDiagnostics.NumWarnings() << "\n";
+
+			ExitCode = Finished.get_future().get() ? 0 : 1;
+		}
+	}
+
+	ForwardOutput();
+
+	std::cout.rdbuf( pPreviousOut );
+	std::cerr.rdbuf( pPreviousErr );
+
+	return ExitCode;
+
+} // Build
+
+//////////////////////////////////////////////////////////////////////////
+
+Daemon::LoadedWorkspace* Daemon::Acquire( const std::filesystem::path& rPath )
+{
+	ProcessChanges();
+
+	auto It = m_Workspaces.find( rPath.generic_string() );
+
+	if( It == m_Workspaces.end() )
+	{
+		LoadedWorkspace Loaded;
+		Loaded.pWorkspace         = std::make_unique< Workspace >( rPath.parent_path() );
+		Loaded.pWorkspace->m_Name = rPath.stem().string();
+
+		if( !Loaded.pWorkspace->Deserialize() )
+			return nullptr;
+
+		It = m_Workspaces.emplace( rPath.generic_string(), std::move( Loaded ) ).first;
+	}
+	else if( It->second.Stale )
+	{
+		std::cout << "Reloading workspace " << rPath.filename() << "\n";
+
+		// The name in the workspace file may differ from the name of the file itself
+		It->second.pWorkspace->m_Name = rPath.stem().string();
+
+		if( !It->second.pWorkspace->Reload() )
+		{
+			m_Workspaces.erase( It );
+			return nullptr;
+		}
+	}
+	else
+	{
+		return &It->second;
+	}
+
+	LoadedWorkspace& rLoaded = It->second;
+
+	rLoaded.Defaults.clear();
+
+	for( const BuildMatrix::Column& rColumn : rLoaded.pWorkspace->m_BuildMatrix.m_Columns )
+		rLoaded.Defaults.push_back( rColumn.CurrentConfiguration );
+
+	Watch( rLoaded, rPath );
+
+	return &rLoaded;
+
+} // Acquire
+
+//////////////////////////////////////////////////////////////////////////
+
+void Daemon::Watch( LoadedWorkspace& rLoaded, const std::filesystem::path& rPath )
+{
+	rLoaded.Files.clear();
+	rLoaded.Files.push_back( rPath );
+
+	for( const Project& rProject : rLoaded.pWorkspace->m_Projects )
+		rLoaded.Files.push_back( ( rProject.m_Location / rProject.m_Name ).replace_extension( Project::EXTENSION ).lexically_normal() );
+
+	// Changes that happen before the watches are in place are missed, so the workspace stays stale if any of them fails
+	rLoaded.Stale = false;
+
+	for( const std::filesystem::path& rFile : rLoaded.Files )
+		rLoaded.Stale |= !m_Watcher.Watch( rFile.parent_path() );
+
+} // Watch
+
+//////////////////////////////////////////////////////////////////////////
+
+void Daemon::ProcessChanges( void )
+{
+	std::vector< std::filesystem::path > Changes;
+	const bool                           Complete = m_Watcher.Poll( Changes );
+
+	for( auto&[ rPath, rLoaded ] : m_Workspaces )
+	{
+		if( !Complete )
+		{
+			rLoaded.Stale = true;
+			continue;
+		}
+
+		for( const std::filesystem::path& rChange : Changes )
+			rLoaded.Stale |= std::find( rLoaded.Files.begin(), rLoaded.Files.end(), rChange.lexically_normal() ) != rLoaded.Files.end();
+	}
+
+} // ProcessChanges
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/FileWatcher.h>
+#include <Common/LocalSocket.h>
+#include <Common/Macros.h>
+#include <Common/WorkerProtocol.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Workspace;
+
+// Builds workspaces on behalf of clients that connect to its socket. Workspaces stay loaded between builds, along with the records of
+// previous builds and the probed toolchains, and are only read again once their files change.
+class Daemon
+{
+	GENO_DISABLE_COPY_AND_MOVE( Daemon );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	 Daemon( std::filesystem::path SocketPath, size_t NumJobs );
+	~Daemon( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Serves connections until the socket fails. Returns the exit code of the daemon.
+	int Run( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	struct LoadedWorkspace
+	{
+		std::unique_ptr< Workspace >         pWorkspace;
+		std::vector< std::filesystem::path > Files;    // The workspace file and the files of its projects
+		std::vector< int32_t >               Defaults; // The configuration that the workspace file selects in each column of the matrix
+		bool                                 Stale = false;
+
+	}; // LoadedWorkspace
+
+//////////////////////////////////////////////////////////////////////////
+
+	void             Serve         ( LocalSocket Connection );
+	int              Build         ( const WorkerProtocol::BuildRequest& rRequest, LocalSocket& rConnection );
+	LoadedWorkspace* Acquire       ( const std::filesystem::path& rPath );
+	void             Watch         ( LoadedWorkspace& rLoaded, const std::filesystem::path& rPath );
+	void             ProcessChanges( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::unordered_map< std::string, LoadedWorkspace > m_Workspaces;
+	std::filesystem::path                              m_SocketPath;
+	FileWatcher                                        m_Watcher;
+	std::mutex                                         m_BuildMutex;
+
+	size_t                                             m_NumJobs = 1;
+
+}; // Daemon
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Daemon.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#if !defined( _WIN32 )
+#include <csignal>
+#endif // !_WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+static int PrintUsage( void )
+{
+	std::cerr << "Usage: geno-buildd --socket <path> [--jobs <count>]\n"
+	             "\n"
+	             "  --socket <path>  UNIX socket to accept build requests on. Pass it to 'Geno --build <workspace> --daemon <path>'.\n"
+	             "  --jobs <count>   Jobs to run at once. Defaults to the number of hardware threads.\n";
+
+	return 1;
+
+} // PrintUsage
+
+//////////////////////////////////////////////////////////////////////////
+
+int main( int ArgCount, char** ppArgs )
+{
+	std::filesystem::path SocketPath;
+	size_t                NumJobs = std::max( std::thread::hardware_concurrency(), 1u );
+
+	for( int i = 1; i < ArgCount; ++i )
+	{
+		const bool HasValue = ( i + 1 ) < ArgCount;
+
+		if( strcmp( ppArgs[ i ], "--socket" ) == 0 && HasValue )
+		{
+			SocketPath = ppArgs[ ++i ];
+		}
+		else if( strcmp( ppArgs[ i ], "--jobs" ) == 0 && HasValue )
+		{
+			NumJobs = static_cast< size_t >( std::max( atoi( ppArgs[ ++i ] ), 1 ) );
+		}
+		else
+		{
+			return PrintUsage();
+		}
+	}
+
+	if( SocketPath.empty() )
+		return PrintUsage();
+
+#if !defined( _WIN32 )
+	// Clients that go away are noticed when sending to them fails
+	signal( SIGPIPE, SIG_IGN );
+#endif // !_WIN32
+
+	Daemon Instance( std::move( SocketPath ), NumJobs );
+
+	return Instance.Run();
+
+} // main
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "Worker.h"
+
+#include <Common/OutputBuffer.h>
+#include <Common/Process.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+#if !defined( _WIN32 )
+#include <unistd.h>
+#endif // !_WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+static void ReplaceAll( std::string& rString, std::string_view From, std::string_view To )
+{
+	for( size_t Position = rString.find( From ); Position != std::string::npos; Position = rString.find( From, Position + To.size() ) )
+		rString.replace( Position, From.size(), To );
+
+} // ReplaceAll
+
+//////////////////////////////////////////////////////////////////////////
+
+Worker::Worker( std::filesystem::path SocketPath, uint32_t Slots, std::vector< std::string > AllowedPrograms )
+	: m_SocketPath     ( std::move( SocketPath ) )
+	, m_AllowedPrograms( std::move( AllowedPrograms ) )
+	, m_Slots          ( Slots )
+{
+	std::error_code Error;
+
+#if defined( _WIN32 )
+	m_JobPrefix = std::filesystem::temp_directory_path( Error ) / ( "geno-worker-" + std::to_string( GetCurrentProcessId() ) + "-" );
+#else // _WIN32
+	m_JobPrefix = std::filesystem::temp_directory_path( Error ) / ( "geno-worker-" + std::to_string( getpid() ) + "-" );
+#endif // !_WIN32
+
+} // Worker
+
+//////////////////////////////////////////////////////////////////////////
+
+int Worker::Run( void )
+{
+	LocalSocket Listener = LocalSocket::Listen( m_SocketPath );
+
+	if( !Listener.IsValid() )
+	{
+		std::cerr << "geno-worker: Failed to listen on " << m_SocketPath << "\n";
+		return 1;
+	}
+
+	std::cout << "geno-worker: Listening on " << m_SocketPath << " with " << m_Slots << " slots\n" << std::flush;
+
+	// Connections only wait for a slot while they are served, so a thread each keeps a slow client from holding up the others
+	for( LocalSocket Connection = Listener.Accept(); Connection.IsValid(); Connection = Listener.Accept() )
+		std::thread( &Worker::Serve, this, std::move( Connection ) ).detach();
+
+	std::cerr << "geno-worker: Stopped accepting connections on " << m_SocketPath << "\n";
+
+	return 1;
+
+} // Run
+
+//////////////////////////////////////////////////////////////////////////
+
+void Worker::Serve( LocalSocket Connection )
+{
+	std::string Payload;
+
+	while( std::optional< WorkerProtocol::MessageType > Type = WorkerProtocol::Receive( Connection, Payload ) )
+	{
+		switch( *Type )
+		{
+			case WorkerProtocol::MessageType::Status:
+			{
+				WorkerProtocol::StatusReply Reply;
+				Reply.Slots = m_Slots;
+
+				{
+					std::scoped_lock Lock( m_SlotsMutex );
+					Reply.Running = m_Running;
+				}
+
+				if( !WorkerProtocol::Send( Connection, WorkerProtocol::MessageType::StatusReply, WorkerProtocol::Encode( Reply ) ) )
+					return;
+
+			} break;
+
+			case WorkerProtocol::MessageType::Compile:
+			{
+				WorkerProtocol::CompileRequest Request;
+				if( !WorkerProtocol::Decode( Payload, Request ) )
+					return;
+
+				// Free the memory of the source before waiting for a slot
+				Payload = std::string();
+
+				{
+					std::unique_lock Lock( m_SlotsMutex );
+					m_SlotFreed.wait( Lock, [ this ]( void ) { return m_Running < m_Slots; } );
+					++m_Running;
+				}
+
+				const WorkerProtocol::CompileReply Reply = Compile( Request );
+
+				{
+					std::scoped_lock Lock( m_SlotsMutex );
+					--m_Running;
+				}
+
+				m_SlotFreed.notify_one();
+
+				if( !WorkerProtocol::Send( Connection, WorkerProtocol::MessageType::CompileReply, WorkerProtocol::Encode( Reply ) ) )
+					return;
+
+			} break;
+
+			default:
+			{
+				// The client is confused, so there's no point in answering
+				return;
+
+			} break;
+		}
+	}
+
+} // Serve
+
+//////////////////////////////////////////////////////////////////////////
+
+WorkerProtocol::CompileReply Worker::Compile( const WorkerProtocol::CompileRequest& rRequest )
+{
+	WorkerProtocol::CompileReply Reply;
+
+	if( rRequest.Arguments.empty() || !IsAllowed( rRequest.Arguments.front() ) )
+	{
+		Reply.Output = "geno-worker: Refusing to run '" + ( rRequest.Arguments.empty() ? std::string() : rRequest.Arguments.front() ) + "', since it isn't an allowed compiler\n";
+		return Reply;
+	}
+
+	// Every job gets a directory of its own, which is gone again once the job is done
+	const std::filesystem::path Directory  = m_JobPrefix.string() + std::to_string( m_NextJobId.fetch_add( 1, std::memory_order_relaxed ) );
+	const std::filesystem::path SourcePath = Directory / ( "input" + std::filesystem::path( rRequest.SourceName ).extension().string() );
+	const std::filesystem::path ObjectPath = Directory / "output.o";
+	std::error_code             Error;
+
+	std::filesystem::create_directories( Directory, Error );
+
+	if( std::ofstream Stream( SourcePath, std::ios::binary ); !Stream.write( rRequest.Source.data(), rRequest.Source.size() ) )
+	{
+		Reply.Output = "geno-worker: Failed to write " + SourcePath.string() + "\n";
+		std::filesystem::remove_all( Directory, Error );
+		return Reply;
+	}
+
+	Process::Arguments Arguments = rRequest.Arguments;
+
+	for( std::string& rArgument : Arguments )
+	{
+		ReplaceAll( rArgument, WorkerProtocol::INPUT_PLACEHOLDER,  SourcePath.string() );
+		ReplaceAll( rArgument, WorkerProtocol::OUTPUT_PLACEHOLDER, ObjectPath.string() );
+	}
+
+	Process      Compiler( std::move( Arguments ) );
+	OutputBuffer Output;
+
+	Reply.ExitCode = Compiler.Capture( Output );
+	Reply.Output   = Output.ToString();
+	Reply.Usage    = Compiler.Usage();
+
+	if( Reply.ExitCode == 0 )
+	{
+		std::ifstream Stream( ObjectPath, std::ios::binary );
+		Reply.Object.assign( std::istreambuf_iterator< char >( Stream ), std::istreambuf_iterator< char >() );
+
+		// A compiler that claims success without producing an object is no good to the client
+		if( Reply.Object.empty() )
+		{
+			Reply.ExitCode = -1;
+			Reply.Output  += "geno-worker: The compiler didn't write an object file\n";
+		}
+	}
+
+	std::filesystem::remove_all( Directory, Error );
+
+	return Reply;
+
+} // Compile
+
+//////////////////////////////////////////////////////////////////////////
+
+bool Worker::IsAllowed( std::string_view Program ) const
+{
+	// Only bare program names are accepted, so that a client can't point the worker at a program of its choosing
+	if( Program.find_first_of( "/\\" ) != std::string_view::npos )
+		return false;
+
+	for( const std::string& rAllowed : m_AllowedPrograms )
+	{
+		if( Program == rAllowed )
+			return true;
+	}
+
+	return false;
+
+} // IsAllowed
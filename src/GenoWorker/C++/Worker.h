@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 Sebastian Kylander https://gaztin.com/
+ *
+ * This software is provided 'as-is', without any express or implied warranty. In no event will
+ * the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the
+ *    original software. If you use this software in a product, an acknowledgment in the product
+ *    documentation would be appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be misrepresented as
+ *    being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#pragma once
+#include <Common/LocalSocket.h>
+#include <Common/Macros.h>
+#include <Common/WorkerProtocol.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compiles preprocessed files on behalf of Geno instances that connect to its socket, a fixed number of files at a time
+class Worker
+{
+	GENO_DISABLE_COPY_AND_MOVE( Worker );
+
+//////////////////////////////////////////////////////////////////////////
+
+public:
+
+	Worker( std::filesystem::path SocketPath, uint32_t Slots, std::vector< std::string > AllowedPrograms );
+
+//////////////////////////////////////////////////////////////////////////
+
+	// Serves connections until the socket fails. Returns the exit code of the daemon.
+	int Run( void );
+
+//////////////////////////////////////////////////////////////////////////
+
+private:
+
+	void                         Serve    ( LocalSocket Connection );
+	WorkerProtocol::CompileReply Compile  ( const WorkerProtocol::CompileRequest& rRequest );
+	bool                         IsAllowed( std::string_view Program ) const;
+
+//////////////////////////////////////////////////////////////////////////
+
+	std::filesystem::path      m_SocketPath;
+	std::filesystem::path      m_JobPrefix;
+	std::vector< std::string > m_AllowedPrograms;
+	std::mutex                 m_SlotsMutex;
+	std::condition_variable    m_SlotFreed;
+	uint32_t                   m_Slots     = 1;
+	uint32_t                   m_Running   = 0;
+	std::atomic< uint64_t >    m_NextJobId = 0;
+
+}; // Worker